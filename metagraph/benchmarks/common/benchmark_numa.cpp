@@ -0,0 +1,86 @@
+#include <random>
+#include <thread>
+
+#include <omp.h>
+#include <benchmark/benchmark.h>
+
+#include "common/threads/numa.hpp"
+#include "common/threads/threading.hpp"
+
+
+/**
+ * Throughput of random lookups in a large in-memory table from all cores,
+ * which is the access pattern of queries against a loaded index, with and
+ * without the NUMA mode of query and server_query (--numa).
+ *
+ * On a machine with a single NUMA node, the topology can be emulated by
+ * booting the kernel with numa=fake=2 (or in a VM with several virtual NUMA
+ * nodes), and the run can be restricted to a subset of the nodes with numactl,
+ * e.g., to compare with an index allocated on a single node:
+ *
+ *   numactl --cpunodebind=0,1 --membind=0 ./benchmarks --benchmark_filter=BM_numa
+ *   numactl --cpunodebind=0,1 ./benchmarks --benchmark_filter=BM_numa
+ *
+ * Pinning can't be undone, so the pinned runs are registered last.
+ */
+
+namespace {
+
+constexpr size_t TABLE_SIZE = 1llu << 27; // 1 GiB
+constexpr size_t NUM_LOOKUPS_PER_THREAD = 1'000'000;
+
+
+const std::vector<uint64_t>& get_table(bool interleave) {
+    static std::vector<uint64_t> tables[2];
+
+    std::vector<uint64_t> &table = tables[interleave];
+    if (table.empty()) {
+        set_numa_interleave(interleave);
+        // the pages are allocated on first touch
+        table.resize(TABLE_SIZE);
+        #pragma omp parallel for num_threads(std::thread::hardware_concurrency())
+        for (size_t i = 0; i < table.size(); ++i) {
+            table[i] = i;
+        }
+        set_numa_interleave(false);
+    }
+    return table;
+}
+
+// the arguments are: interleave the table, pin the threads
+void BM_numa_random_lookups(benchmark::State &state) {
+    const size_t num_threads = std::thread::hardware_concurrency();
+    set_num_threads(num_threads);
+    if (state.range(1))
+        set_numa_pinning(true);
+
+    const auto &table = get_table(state.range(0));
+
+    uint64_t sum = 0;
+    for (auto _ : state) {
+        #pragma omp parallel for num_threads(get_num_threads()) reduction(+:sum)
+        for (size_t t = 0; t < num_threads; ++t) {
+            std::mt19937_64 gen(t);
+            for (size_t i = 0; i < NUM_LOOKUPS_PER_THREAD; ++i) {
+                sum += table[gen() % TABLE_SIZE];
+            }
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+
+    state.SetItemsProcessed(state.iterations() * num_threads * NUM_LOOKUPS_PER_THREAD);
+    state.counters["numa_nodes"] = get_num_numa_nodes();
+
+    set_numa_pinning(false);
+    set_num_threads(1);
+}
+
+BENCHMARK(BM_numa_random_lookups)
+    -> Unit(benchmark::kMillisecond)
+    -> UseRealTime()
+    -> Args({ 0, 0 })
+    -> Args({ 1, 0 })
+    -> Args({ 0, 1 })
+    -> Args({ 1, 1 });
+
+} // namespace
@@ -222,4 +222,66 @@ BENCHMARK(BM_BOSS_num_incoming_to_target) -> Unit(benchmark::kMicrosecond);
 
 DEFINE_BOSS_BENCHMARK(get_node_seq,  get_node_seq,              get_W,    size);
 
+
+// compare the representations of W, e.g. wavelet trees and occurrence tables
+std::unique_ptr<DBGSuccinct> load_graph(benchmark::State &state, BOSS::State graph_state) {
+    auto graph = load_graph(state);
+    graph->switch_state(graph_state);
+    return graph;
+}
+
+#define DEFINE_BOSS_STATE_BENCHMARK(NAME, OPERATION, ...) \
+template <BOSS::State graph_state> \
+static void BM_BOSS_state_##NAME(benchmark::State& state) { \
+    auto graph = load_graph(state, graph_state); \
+    const BOSS &boss = graph->get_boss(); \
+ \
+    auto indexes = random_numbers(NUM_DISTINCT_INDEXES, 1, boss.get_W().size() - 1); \
+    size_t i = 0; \
+    for (auto _ : state) { \
+        uint64_t edge = indexes[i++ % NUM_DISTINCT_INDEXES]; \
+        benchmark::DoNotOptimize(boss.OPERATION(edge, ##__VA_ARGS__)); \
+    } \
+} \
+BENCHMARK_TEMPLATE(BM_BOSS_state_##NAME, BOSS::State::STAT) -> Unit(benchmark::kMicrosecond); \
+BENCHMARK_TEMPLATE(BM_BOSS_state_##NAME, BOSS::State::SMALL) -> Unit(benchmark::kMicrosecond); \
+BENCHMARK_TEMPLATE(BM_BOSS_state_##NAME, BOSS::State::FAST) -> Unit(benchmark::kMicrosecond); \
+BENCHMARK_TEMPLATE(BM_BOSS_state_##NAME, BOSS::State::OCC) -> Unit(benchmark::kMicrosecond); \
+BENCHMARK_TEMPLATE(BM_BOSS_state_##NAME, BOSS::State::INTERLEAVED) -> Unit(benchmark::kMicrosecond); \
+
+DEFINE_BOSS_STATE_BENCHMARK(get_W,     get_W);
+DEFINE_BOSS_STATE_BENCHMARK(rank_W_A,  rank_W, 1);
+DEFINE_BOSS_STATE_BENCHMARK(rank_W_Am, rank_W, 6);
+DEFINE_BOSS_STATE_BENCHMARK(bwd,       bwd);
+DEFINE_BOSS_STATE_BENCHMARK(pred_W_A,  pred_W, 1);
+DEFINE_BOSS_STATE_BENCHMARK(succ_W_A,  succ_W, 1);
+
+template <BOSS::State graph_state>
+static void BM_BOSS_state_fwd(benchmark::State &state) {
+    auto graph = load_graph(state, graph_state);
+    const BOSS &boss = graph->get_boss();
+
+    std::mt19937 gen(32);
+    std::uniform_int_distribution<uint64_t> dis(1, boss.get_W().size() - 1);
+
+    std::vector<std::pair<uint64_t, BOSS::TAlphabet>> edges;
+    edges.reserve(NUM_DISTINCT_INDEXES);
+    while (edges.size() < NUM_DISTINCT_INDEXES) {
+        uint64_t edge = dis(gen);
+        if (boss.get_W().size() <= 2 || boss.get_W(edge))
+            edges.emplace_back(edge, boss.get_W(edge) % boss.alph_size);
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        auto edge = edges[i++ % NUM_DISTINCT_INDEXES];
+        benchmark::DoNotOptimize(boss.fwd(edge.first, edge.second));
+    }
+}
+BENCHMARK_TEMPLATE(BM_BOSS_state_fwd, BOSS::State::STAT) -> Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_BOSS_state_fwd, BOSS::State::SMALL) -> Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_BOSS_state_fwd, BOSS::State::FAST) -> Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_BOSS_state_fwd, BOSS::State::OCC) -> Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_BOSS_state_fwd, BOSS::State::INTERLEAVED) -> Unit(benchmark::kMicrosecond);
+
 } // namespace
@@ -0,0 +1,101 @@
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include "graph/representation/succinct/dbg_succinct.hpp"
+#include "graph/alignment/dbg_aligner.hpp"
+
+
+namespace {
+
+using namespace mtg::graph;
+using namespace mtg::graph::align;
+
+constexpr size_t REFERENCE_LENGTH = 100'000;
+constexpr size_t READ_LENGTH = 250;
+constexpr size_t NUM_READS = 1'000;
+constexpr size_t K = 31;
+
+
+// generate a deterministic random reference sequence
+std::string random_reference(size_t length) {
+    std::mt19937 gen(32);
+    std::uniform_int_distribution<int> dis(0, 3);
+
+    std::string sequence(length, 'A');
+    for (char &c : sequence) {
+        c = "ACGT"[dis(gen)];
+    }
+    return sequence;
+}
+
+// sample reads from the reference and introduce errors at the given rate,
+// 80% of which are substitutions and 20% are single-character indels
+std::vector<std::string> simulate_reads(const std::string &reference,
+                                        double error_rate) {
+    std::mt19937 gen(32);
+    std::uniform_int_distribution<size_t> start_dis(0, reference.size() - 2 * READ_LENGTH);
+    std::uniform_int_distribution<int> char_dis(0, 3);
+    std::uniform_real_distribution<double> error_dis(0, 1);
+
+    std::vector<std::string> reads(NUM_READS);
+    for (std::string &read : reads) {
+        // keep the first k-mer exact to guarantee a seed
+        size_t i = start_dis(gen);
+        read = reference.substr(i, K);
+        i += K;
+        while (read.size() < READ_LENGTH) {
+            double r = error_dis(gen);
+            if (r >= error_rate) {
+                read.push_back(reference[i++]);
+            } else if (r < error_rate * 0.8) {
+                read.push_back("ACGT"[char_dis(gen)]);
+                ++i;
+            } else if (r < error_rate * 0.9) {
+                read.push_back("ACGT"[char_dis(gen)]);
+            } else {
+                ++i;
+            }
+        }
+    }
+    return reads;
+}
+
+template <class Extender>
+void BM_align(benchmark::State &state) {
+    static const std::string reference = random_reference(REFERENCE_LENGTH);
+    static const auto graph = []() {
+        auto graph = std::make_shared<DBGSuccinct>(K);
+        graph->add_sequence(reference);
+        return graph;
+    }();
+
+    auto reads = simulate_reads(reference, state.range(0) / 1000.);
+
+    DBGAlignerConfig config(DBGAlignerConfig::dna_scoring_matrix(2, -1, -2));
+    config.gap_opening_penalty = -3;
+    config.gap_extension_penalty = -1;
+    config.xdrop = 27;
+    config.max_nodes_per_seq_char = 10.0;
+    config.min_seed_length = K;
+    config.max_seed_length = K;
+
+    DBGAligner<ExactSeeder<>, Extender> aligner(*graph, config);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(aligner.align(reads[i++ % NUM_READS]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// the argument is the error rate of the reads in per mille
+BENCHMARK_TEMPLATE(BM_align, DefaultColumnExtender<>)
+    -> Unit(benchmark::kMicrosecond)
+    -> Arg(0) -> Arg(10) -> Arg(20) -> Arg(50);
+
+BENCHMARK_TEMPLATE(BM_align, WavefrontExtender<>)
+    -> Unit(benchmark::kMicrosecond)
+    -> Arg(0) -> Arg(10) -> Arg(20) -> Arg(50);
+
+} // namespace
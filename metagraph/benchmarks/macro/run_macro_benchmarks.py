@@ -0,0 +1,376 @@
+#!/usr/bin/env python3
+
+"""
+End-to-end benchmarks of the main metagraph pipelines on simulated data.
+
+Simulates a set of related genomes (one label per genome) and a set of reads
+with sequencing errors sampled from them, then times graph construction,
+annotation, conversion of the annotation to BRWT and RowDiff<BRWT>, querying
+with --fast, alignment, and the throughput of the /search endpoint of the
+server. The results are written to a JSON file, so that runs of different
+releases can be compared.
+
+Run this script from build.
+
+Example:
+../benchmarks/macro/run_macro_benchmarks.py --scale small -o small.json
+../benchmarks/macro/run_macro_benchmarks.py --scale medium -p 8 -o medium.json
+
+"""
+
+import argparse
+import json
+import os
+import random
+import shlex
+import socket
+import subprocess
+import sys
+import time
+import urllib.request
+from subprocess import DEVNULL, PIPE
+from tempfile import TemporaryDirectory, TemporaryFile
+
+
+SCALES = {
+    'tiny':   {'genome_length': 10**4, 'num_genomes': 4,   'num_reads': 10**3},
+    'small':  {'genome_length': 10**5, 'num_genomes': 16,  'num_reads': 10**4},
+    'medium': {'genome_length': 10**6, 'num_genomes': 64,  'num_reads': 10**5},
+    'large':  {'genome_length': 10**7, 'num_genomes': 128, 'num_reads': 10**6},
+}
+
+ALPHABET = 'ACGT'
+
+
+def random_genome(length, gen):
+    return ''.join(gen.choices(ALPHABET, k=length))
+
+
+def mutate(sequence, rate, gen):
+    """Introduce substitutions and single-character indels at the given rate,
+    80% of which are substitutions"""
+    result = []
+    for c in sequence:
+        r = gen.random()
+        if r >= rate:
+            result.append(c)
+        elif r < rate * 0.8:
+            result.append(gen.choice(ALPHABET))
+        elif r < rate * 0.9:
+            result.append(c)
+            result.append(gen.choice(ALPHABET))
+    return ''.join(result)
+
+
+def simulate_genomes(filename, args, gen):
+    """Write genomes derived from a common ancestor, each with its own label.
+    Returns the total number of base pairs."""
+    ancestor = random_genome(args.genome_length, gen)
+    total_bp = 0
+    with open(filename, 'w') as f:
+        for i in range(args.num_genomes):
+            genome = mutate(ancestor, args.divergence, gen)
+            f.write('>genome_{}\n{}\n'.format(i, genome))
+            total_bp += len(genome)
+    return total_bp
+
+
+def simulate_reads(genomes_filename, filename, args, gen):
+    """Sample reads from the genomes and introduce sequencing errors"""
+    with open(genomes_filename) as f:
+        genomes = [line.strip() for line in f if not line.startswith('>')]
+
+    with open(filename, 'w') as f:
+        for i in range(args.num_reads):
+            genome = gen.choice(genomes)
+            begin = gen.randrange(len(genome) - args.read_length + 1)
+            read = mutate(genome[begin:begin + args.read_length],
+                          args.error_rate, gen)
+            f.write('>read_{}\n{}\n'.format(i, read))
+
+
+def file_size(*filenames):
+    return sum(os.path.getsize(filename) for filename in filenames
+                                         if os.path.exists(filename))
+
+
+def wait_with_usage(process):
+    """Wait for the process and return the resources used by it alone, unlike
+    getrusage(RUSAGE_CHILDREN), which accumulates over all children"""
+    _, status, usage = os.wait4(process.pid, 0)
+    # the process is reaped, so Popen must not wait for it again
+    process.returncode = os.WEXITSTATUS(status) if os.WIFEXITED(status) \
+                                                else -os.WTERMSIG(status)
+    return usage
+
+
+def usage_stats(usage):
+    return {
+        'cpu_time_sec': usage.ru_utime + usage.ru_stime,
+        # in KB on Linux
+        'max_rss_kb': usage.ru_maxrss,
+    }
+
+
+def run_stage(stage, command, outputs=[], items=None):
+    """Run a metagraph command and record its running time"""
+    print('[{}] {}'.format(stage, command), file=sys.stderr, flush=True)
+
+    # not a pipe, which could fill up while waiting for the process
+    with TemporaryFile() as stderr:
+        start = time.perf_counter()
+        process = subprocess.Popen(shlex.split(command), stdout=DEVNULL, stderr=stderr)
+        usage = wait_with_usage(process)
+        wall_time = time.perf_counter() - start
+
+        if process.returncode != 0:
+            stderr.seek(0)
+            sys.stderr.write(stderr.read().decode())
+            raise RuntimeError('Stage {} failed with exit code {}'.format(stage, process.returncode))
+
+    result = {
+        'stage': stage,
+        'command': command,
+        'wall_time_sec': wall_time,
+        **usage_stats(usage),
+    }
+    if outputs:
+        result['output_bytes'] = file_size(*outputs)
+    if items:
+        result['items'] = items
+        result['items_per_sec'] = items / wall_time
+    return result
+
+
+def wait_for_server(host, port, process, timeout_sec=600):
+    start = time.perf_counter()
+    while time.perf_counter() - start < timeout_sec:
+        if process.poll() is not None:
+            raise RuntimeError('Server exited with code {}'.format(process.returncode))
+        try:
+            with socket.create_connection((host, port), timeout=1):
+                return time.perf_counter() - start
+        except OSError:
+            time.sleep(0.1)
+    raise RuntimeError('Server did not start in {} sec'.format(timeout_sec))
+
+
+def benchmark_server(args, graph, annotation, reads_filename):
+    """Send the reads to /search in batches and measure the throughput"""
+    command = '{exe} server_query -i {graph} -a {anno} --address {host} --port {port} -p {threads}'.format(
+        exe=args.metagraph,
+        graph=graph,
+        anno=annotation,
+        host=args.host,
+        port=args.port,
+        threads=args.threads
+    )
+    print('[server] {}'.format(command), file=sys.stderr, flush=True)
+
+    with open(reads_filename) as f:
+        lines = f.read().splitlines()
+    records = ['\n'.join(lines[i:i + 2]) for i in range(0, len(lines), 2)]
+    batches = [records[i:i + args.server_batch_size]
+                    for i in range(0, len(records), args.server_batch_size)]
+
+    process = subprocess.Popen(shlex.split(command), stdout=DEVNULL, stderr=DEVNULL)
+    try:
+        startup_time = wait_for_server(args.host, args.port, process)
+
+        url = 'http://{}:{}/search'.format(args.host, args.port)
+        start = time.perf_counter()
+        for batch in batches:
+            payload = json.dumps({
+                'FASTA': '\n'.join(batch),
+                'discovery_fraction': args.discovery_fraction,
+            }).encode()
+            request = urllib.request.Request(url, data=payload, method='POST')
+            with urllib.request.urlopen(request) as response:
+                if response.status != 200:
+                    raise RuntimeError('Server returned status {}'.format(response.status))
+                response.read()
+        wall_time = time.perf_counter() - start
+    finally:
+        process.kill()
+        usage = wait_with_usage(process)
+
+    return {
+        'stage': 'server_search',
+        'command': command,
+        'startup_time_sec': startup_time,
+        'wall_time_sec': wall_time,
+        'requests': len(batches),
+        'requests_per_sec': len(batches) / wall_time,
+        'items': len(records),
+        'items_per_sec': len(records) / wall_time,
+        # including the startup
+        **usage_stats(usage),
+    }
+
+
+def run_benchmarks(args, workdir):
+    gen = random.Random(args.seed)
+
+    genomes = os.path.join(workdir, 'genomes.fa')
+    reads = os.path.join(workdir, 'reads.fa')
+
+    start = time.perf_counter()
+    total_bp = simulate_genomes(genomes, args, gen)
+    simulate_reads(genomes, reads, args, gen)
+    print('Data simulated in {:.2f} sec'.format(time.perf_counter() - start),
+          file=sys.stderr, flush=True)
+
+    exe = args.metagraph
+    threads = args.threads
+    graph_base = os.path.join(workdir, 'graph')
+    graph = graph_base + '.dbg'
+    anno_base = os.path.join(workdir, 'annotation')
+
+    stages = []
+
+    stages.append(run_stage(
+        'build',
+        '{} build --mask-dummy -p {} -k {} -o {} {}'.format(
+            exe, threads, args.k, graph_base, genomes),
+        outputs=[graph], items=total_bp
+    ))
+
+    stages.append(run_stage(
+        'annotate',
+        '{} annotate --anno-header -p {} -i {} --anno-type column -o {} {}'.format(
+            exe, threads, graph, anno_base, genomes),
+        outputs=[anno_base + '.column.annodbg'], items=total_bp
+    ))
+
+    stages.append(run_stage(
+        'transform_anno_brwt',
+        '{} transform_anno --anno-type brwt --greedy -p {} -o {} {}'.format(
+            exe, threads, anno_base, anno_base + '.column.annodbg'),
+        outputs=[anno_base + '.brwt.annodbg']
+    ))
+
+    # RowDiff is constructed in two passes, the second one optimizes anchors
+    row_diff_command = '{} transform_anno --anno-type row_diff -i {} -p {} -o {} {}'.format(
+        exe, graph, threads, anno_base, anno_base + '.column.annodbg')
+    stages.append(run_stage('transform_anno_row_diff', row_diff_command))
+    stages.append(run_stage(
+        'transform_anno_row_diff_optimize',
+        row_diff_command + ' --optimize',
+        outputs=[anno_base + '.row_diff.annodbg', graph + '.anchors']
+    ))
+
+    stages.append(run_stage(
+        'transform_anno_row_diff_brwt',
+        '{} transform_anno --anno-type row_diff_brwt --greedy --anchors-file {} -p {} -o {} {}'.format(
+            exe, graph + '.anchors', threads, anno_base, anno_base + '.row_diff.annodbg'),
+        outputs=[anno_base + '.row_diff_brwt.annodbg']
+    ))
+
+    for anno_type in ['brwt', 'row_diff_brwt']:
+        stages.append(run_stage(
+            'query_fast_' + anno_type,
+            '{} query --fast -p {} -i {} -a {} --discovery-fraction {} {}'.format(
+                exe, threads, graph, '{}.{}.annodbg'.format(anno_base, anno_type),
+                args.discovery_fraction, reads),
+            items=args.num_reads
+        ))
+
+    stages.append(run_stage(
+        'align',
+        '{} align -p {} -i {} {}'.format(exe, threads, graph, reads),
+        items=args.num_reads
+    ))
+
+    if not args.skip_server:
+        stages.append(benchmark_server(args, graph,
+                                       anno_base + '.row_diff_brwt.annodbg', reads))
+
+    return stages
+
+
+def get_revision():
+    """The revision of the source tree, to tell benchmarks of different releases apart"""
+    res = subprocess.run(['git', 'describe', '--always', '--dirty'], stdout=PIPE,
+                         stderr=DEVNULL, cwd=os.path.dirname(os.path.realpath(__file__)))
+    return res.stdout.decode().strip() if res.returncode == 0 else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Metagraph end-to-end benchmarks.')
+    parser.add_argument('--metagraph', type=str, default='./metagraph',
+                        help='path to the metagraph executable (default: %(default)s)')
+    parser.add_argument('--scale', choices=SCALES.keys(), default='small',
+                        help='preset for the size of the simulated data (default: %(default)s)')
+    parser.add_argument('--genome-length', type=int,
+                        help='length of the simulated genomes (overrides --scale)')
+    parser.add_argument('--num-genomes', type=int,
+                        help='number of simulated genomes, i.e., labels (overrides --scale)')
+    parser.add_argument('--num-reads', type=int,
+                        help='number of simulated reads (overrides --scale)')
+    parser.add_argument('--divergence', type=float, default=0.01,
+                        help='mutation rate of genomes w.r.t. their ancestor (default: %(default)s)')
+    parser.add_argument('--read-length', type=int, default=150,
+                        help='length of simulated reads (default: %(default)s)')
+    parser.add_argument('--error-rate', type=float, default=0.01,
+                        help='sequencing error rate of simulated reads (default: %(default)s)')
+    parser.add_argument('-k', type=int, default=31,
+                        help='k-mer length (default: %(default)s)')
+    parser.add_argument('-p', '--threads', type=int, default=1,
+                        help='number of threads (default: %(default)s)')
+    parser.add_argument('--seed', type=int, default=42,
+                        help='seed for the data simulation (default: %(default)s)')
+    parser.add_argument('--discovery-fraction', type=float, default=0.7,
+                        help='discovery fraction for queries (default: %(default)s)')
+    parser.add_argument('--skip-server', action='store_true',
+                        help='do not benchmark the server')
+    parser.add_argument('--server-batch-size', type=int, default=100,
+                        help='number of reads per /search request (default: %(default)s)')
+    parser.add_argument('--host', type=str, default='127.0.0.1',
+                        help='address for the server (default: %(default)s)')
+    parser.add_argument('--port', type=int, default=5555,
+                        help='port for the server (default: %(default)s)')
+    parser.add_argument('--workdir', type=str,
+                        help='directory for the data and indexes (default: temporary)')
+    parser.add_argument('-o', '--output', type=str, default='-',
+                        help='output JSON file (default: stdout)')
+    args = parser.parse_args()
+
+    for param, value in SCALES[args.scale].items():
+        if getattr(args, param) is None:
+            setattr(args, param, value)
+
+    if args.read_length > args.genome_length:
+        parser.error('Read length must not exceed the genome length')
+
+    if args.workdir:
+        os.makedirs(args.workdir, exist_ok=True)
+        stages = run_benchmarks(args, args.workdir)
+    else:
+        with TemporaryDirectory() as workdir:
+            stages = run_benchmarks(args, workdir)
+
+    report = {
+        'revision': get_revision(),
+        'timestamp': time.strftime('%Y-%m-%dT%H:%M:%S%z'),
+        'host': socket.gethostname(),
+        'parameters': {param: getattr(args, param) for param in [
+            'scale', 'genome_length', 'num_genomes', 'num_reads', 'divergence',
+            'read_length', 'error_rate', 'k', 'threads', 'seed',
+            'discovery_fraction', 'server_batch_size'
+        ]},
+        'stages': stages,
+    }
+
+    if args.output == '-':
+        json.dump(report, sys.stdout, indent=2)
+        print()
+    else:
+        with open(args.output, 'w') as f:
+            json.dump(report, f, indent=2)
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        sys.exit(130)
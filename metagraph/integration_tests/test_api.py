@@ -22,6 +22,8 @@ class TestAPIBase(TestingBase):
 
         graph_path = cls.tempdir.name + '/graph.dbg'
         annotation_path = cls.tempdir.name + '/annotation.column.annodbg'
+        cls.graph_path = graph_path
+        cls.annotation_path = annotation_path
 
         cls._build_graph(cls, fasta_path, graph_path, 6, 'succinct',
                          canonical=canonical, primary=primary)
@@ -41,13 +43,13 @@ class TestAPIBase(TestingBase):
     def tearDownClass(cls):
         cls.server_process.kill()
 
-    def _start_server(self, graph, annotation):
+    def _start_server(self, graph, annotation, port=None):
         construct_command = '{exe} server_query -i {graph} -a {annot} --port {port} --address {host} -p {threads}'.format(
             exe=METAGRAPH,
             graph=graph,
             annot=annotation,
             host=self.host,
-            port=self.port,
+            port=port or self.port,
             threads=2
         )
 
@@ -183,6 +185,48 @@ class TestAPIRaw(TestAPIBase):
 
         self.assertEqual(ret[0]['seq_description'], '')
 
+    def test_api_raw_align_stream(self):
+        repetitions = 20
+        fasta_str = '\n'.join([f">query{i}\nTCGATCGA" for i in range(repetitions)])
+        payload = json.dumps({"FASTA": fasta_str, "min_exact_match": 0})
+
+        expected = self.raw_post_request('align', payload).json()
+        ret = self.raw_post_request('align_stream', payload)
+
+        self.assertEqual(ret.status_code, 200)
+        self.assertEqual(ret.headers['Content-Type'], 'application/x-ndjson')
+
+        # the lines are in the order of the queries
+        lines = [json.loads(line) for line in ret.text.splitlines()]
+        self.assertListEqual(lines, expected)
+
+    def test_api_raw_align_stream_invalid_params(self):
+        payload = json.dumps({"FASTA": ">query\nTCGA", "min_exact_match": 1.1})
+        ret = self.raw_post_request('align_stream', payload)
+
+        self.assertEqual(ret.status_code, 400)
+
+    def test_api_raw_search_stream(self):
+        fasta_str = '\n'.join([f">query{i}\nCCTCTGTGGAATCCAATCTGTCTTCCATCCTGCGTGGCCGAGGG" for i in range(5)])
+        payload = json.dumps({"FASTA": fasta_str, 'num_labels': 5, 'discovery_fraction': 0.1})
+
+        expected = self.raw_post_request('search', payload).json()
+        ret = self.raw_post_request('search_stream', payload)
+
+        self.assertEqual(ret.status_code, 200)
+        self.assertEqual(ret.headers['Content-Type'], 'application/x-ndjson')
+
+        # the lines are not necessarily in the order of the queries
+        lines = [json.loads(line) for line in ret.text.splitlines()]
+        key = lambda entry: entry['seq_description']
+        self.assertListEqual(sorted(lines, key=key), sorted(expected, key=key))
+
+    def test_api_raw_search_stream_invalid_params(self):
+        payload = json.dumps({"FASTA": ">query\nTCGA", "discovery_fraction": 1.1})
+        ret = self.raw_post_request('search_stream', payload)
+
+        self.assertEqual(ret.status_code, 400)
+
     def test_api_raw_search_empty_fasta_desc(self):
         fasta_str = ">\nCCTCTGTGGAATCCAATCTGTCTTCCATCCTGCGTGGCCGAGGG"
         payload = json.dumps({"FASTA": fasta_str, 'num_labels': 5, 'min_exact_match': 0.1})
@@ -344,3 +388,83 @@ class TestAPIClientWithProperties(TestAPIBase):
     def test_api_search_property_df_empty(self):
         df = self.graph_client.search("THISSEQUENCEDOESNOTEXIST")[self.graph_name]
         self.assertTrue(df.empty)
+
+
+@unittest.skipIf(PROTEIN_MODE, "No canonical mode for Protein alphabets")
+class TestAPIRouter(TestAPIBase):
+    """
+    Testing the router forwarding requests to two identical shards and to one
+    which is unavailable
+    """
+    sample_query = 'CCTCTGTGGAATCCAATCTGTCTTCCATCCTGCGTGGCCGAGGG'
+
+    @classmethod
+    def setUpClass(cls):
+        super().setUpClass(TEST_DATA_DIR + '/transcripts_100.fa', canonical=True)
+
+        cls.second_port = cls.port + 1
+        cls.router_port = cls.port + 2
+        unavailable_port = cls.port + 3
+
+        cls.second_server_process = cls._start_server(cls, cls.graph_path,
+                                                      cls.annotation_path,
+                                                      cls.second_port)
+
+        construct_command = '{exe} server_router --port {port} --address {host} -p {threads} --backend-timeout {timeout} {backends}'.format(
+            exe=METAGRAPH,
+            host=cls.host,
+            port=cls.router_port,
+            threads=2,
+            timeout=5,
+            backends=' '.join(f'{cls.host}:{port}' for port in [cls.port,
+                                                                 cls.second_port,
+                                                                 unavailable_port])
+        )
+        cls.router_process = Popen(shlex.split(construct_command))
+
+        time.sleep(1)
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.router_process.kill()
+        cls.second_server_process.kill()
+        super().tearDownClass()
+
+    def setUp(self) -> None:
+        self.post = lambda port, cmd, payload: requests.post(url=f'http://{self.host}:{port}/{cmd}', data=payload)
+
+    def test_router_search(self):
+        fasta_str = '\n'.join([f">query{i}\n{self.sample_query}" for i in range(3)])
+        payload = json.dumps({"FASTA": fasta_str, "num_labels": 5, "discovery_fraction": 0.1})
+
+        expected = self.post(self.port, 'search', payload)
+        ret = self.post(self.router_port, 'search', payload)
+
+        self.assertEqual(ret.status_code, 200)
+        self.assertEqual(ret.json(), expected.json())
+
+    def test_router_align(self):
+        fasta_str = '\n'.join([f">query{i}\nTCGATCGA" for i in range(3)])
+        payload = json.dumps({"FASTA": fasta_str, "min_exact_match": 0})
+
+        expected = self.post(self.port, 'align', payload)
+        ret = self.post(self.router_port, 'align', payload)
+
+        self.assertEqual(ret.status_code, 200)
+        self.assertEqual(ret.json(), expected.json())
+
+    def test_router_invalid_request(self):
+        payload = json.dumps({"FASTA": ">query\nTCGA", "discovery_fraction": 1.1})
+        ret = self.post(self.router_port, 'search', payload)
+
+        self.assertEqual(ret.status_code, 400)
+
+    def test_router_backends(self):
+        self.post(self.router_port, 'align', json.dumps({"FASTA": ">query\nTCGATCGA"}))
+
+        ret = requests.get(url=f'http://{self.host}:{self.router_port}/backends').json()
+
+        self.assertEqual(len(ret), 3)
+        self.assertEqual(ret[0]['errors'], 0)
+        self.assertEqual(ret[1]['errors'], 0)
+        self.assertGreater(ret[2]['errors'], 0)
@@ -25,6 +25,7 @@
 #include "representation/annotation_matrix/static_annotators_def.hpp"
 #include "representation/column_compressed/annotate_column_compressed.hpp"
 #include "representation/row_compressed/annotate_row_compressed.hpp"
+#include "representation/row_sharded/annotate_row_sharded.hpp"
 
 
 namespace mtg {
@@ -1062,6 +1063,48 @@ void convert_to_row_annotator(const ColumnCompressed<std::string> &annotator,
                               const std::string &outfbase,
                               size_t num_threads);
 
+template <typename Label>
+void split_by_rows(const ColumnCompressed<Label> &annotator,
+                   const std::vector<uint64_t> &boundaries,
+                   const std::string &outfbase,
+                   size_t num_threads) {
+    if (boundaries.size() < 2 || boundaries.front()
+            || boundaries.back() != annotator.num_objects()
+            || !std::is_sorted(boundaries.begin(), boundaries.end()))
+        throw std::runtime_error("Invalid shard boundaries");
+
+    const std::string filebase = utils::remove_suffix(outfbase, annotator.file_extension());
+
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+    for (size_t s = 0; s + 1 < boundaries.size(); ++s) {
+        const uint64_t begin = boundaries[s];
+        const uint64_t end = boundaries[s + 1];
+
+        ColumnCompressed<Label> shard(end - begin);
+        std::vector<uint64_t> indices;
+        for (const auto &label : annotator.get_all_labels()) {
+            indices.clear();
+            annotator.get_column(label).call_ones_in_range(begin, end,
+                [&](uint64_t i) { indices.push_back(i - begin); }
+            );
+            // add the label even if the column is empty in this range,
+            // to keep the label encoders of all shards identical
+            shard.add_labels(indices, { label });
+        }
+
+        const std::string filename = RowShardedAnnotator<Label>::shard_filename(filebase, s);
+        shard.serialize(filename);
+        logger->trace("Shard {} with rows [{}, {}) serialized to {}",
+                      s, begin, end, filename + shard.file_extension());
+    }
+}
+
+template
+void split_by_rows(const ColumnCompressed<std::string> &annotator,
+                   const std::vector<uint64_t> &boundaries,
+                   const std::string &outfbase,
+                   size_t num_threads);
+
 template <typename Label>
 void convert_to_row_annotator(const ColumnCompressed<Label> &source,
                               RowCompressed<Label> *annotator,
@@ -1122,18 +1165,37 @@ void convert_to_row_diff(const std::vector<std::string> &files,
                          size_t mem_bytes,
                          uint32_t max_path_length,
                          std::filesystem::path dest_dir,
-                         bool optimize) {
+                         bool optimize,
+                         const std::vector<std::string> &query_files,
+                         uint32_t max_query_path_length,
+                         double max_extra_anchors) {
     if (!files.size())
         return;
 
     if (dest_dir.empty())
         dest_dir = "./";
 
+    const std::string anchors_fname
+            = graph_fname + kRowDiffAnchorExt + (optimize ? "" : ".unopt");
+
+    // the anchors may already be used by the row-diff columns transformed
+    // earlier, so they can be extended for the queries only when created
+    const bool anchors_exist = std::filesystem::exists(anchors_fname);
+
     build_successor(graph_fname, graph_fname, max_path_length, get_num_threads());
 
     if (optimize)
         optimize_anchors_in_row_diff(graph_fname, dest_dir, ".row_reduction.unopt");
 
+    if (!anchors_exist) {
+        optimize_anchors_for_queries(graph_fname, anchors_fname, query_files,
+                                     max_query_path_length, max_extra_anchors);
+    } else if (query_files.size()) {
+        logger->warn("Found anchors {}, which may be used by existing row-diff"
+                     " annotations. The anchors will not be changed for the queries",
+                     anchors_fname);
+    }
+
     std::filesystem::path row_reduction_fname;
 
     // load as many columns as we can fit in memory, and convert them
@@ -1179,7 +1241,7 @@ void convert_to_row_diff(const std::vector<std::string> &files,
                       file_batch.size());
 
         convert_batch_to_row_diff(
-                graph_fname, graph_fname + kRowDiffAnchorExt + (optimize ? "" : ".unopt"),
+                graph_fname, anchors_fname,
                 file_batch, dest_dir, row_reduction_fname, ROW_DIFF_BUFFER_SIZE, !optimize);
 
         logger->trace("Batch transformed in {} sec", timer.elapsed());
@@ -85,6 +85,19 @@ void convert_to_row_annotator(const ColumnCompressed<Label> &annotator,
                               RowCompressed<Label> *target,
                               size_t num_threads = 1);
 
+/**
+ * Splits the annotation into shards storing ranges of rows
+ * [boundaries[i], boundaries[i + 1]) and serializes the shards to files
+ * '<outfbase>.shard<i>'. The boundaries must start with 0 and end with the
+ * number of rows. All shards keep the full list of labels.
+ * The relation counts are not split.
+ */
+template <typename Label>
+void split_by_rows(const ColumnCompressed<Label> &annotator,
+                   const std::vector<uint64_t> &boundaries,
+                   const std::string &outfbase,
+                   size_t num_threads = 1);
+
 /**
  * Sparsifies annotations in #ColumnCompressed format by storing diffs between sucessive
  * nodes rather than the actual annotation.
@@ -102,13 +115,19 @@ void convert_to_row_annotator(const ColumnCompressed<Label> &annotator,
  * is fully stored
  * @param out_dir directory where the transformed columns will be dumped. Filenames are
  * kept, extension is changed from 'column.annodbg' to 'row_diff.annodbg'
+ * @param query_files sample queries (e.g., a query log) to optimize anchors for
+ * @param max_query_path_length maximum path length for the rows queried frequently
+ * @param max_extra_anchors maximum fraction of rows added as anchors for the queries
  */
 void convert_to_row_diff(const std::vector<std::string> &files,
                          const std::string &graph_fname,
                          size_t mem_bytes,
                          uint32_t max_path_length,
                          std::filesystem::path dest_dir,
-                         bool optimize = false);
+                         bool optimize = false,
+                         const std::vector<std::string> &query_files = {},
+                         uint32_t max_query_path_length = 5,
+                         double max_extra_anchors = 0.01);
 
 void convert_row_diff_to_col_compressed(const std::vector<std::string> &files,
                                         const std::string &outfbase);
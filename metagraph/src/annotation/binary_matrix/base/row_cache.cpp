@@ -0,0 +1,196 @@
+#include "row_cache.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace mtg {
+namespace annot {
+namespace binmat {
+
+const size_t kNumHashes = 4;
+const uint8_t kMaxFrequency = 15;
+
+
+inline uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+RowCache::RowCache(const BinaryMatrix &matrix, size_t capacity, size_t num_shards)
+      : matrix_(matrix),
+        capacity_(capacity),
+        num_shards_(std::max(size_t(1), std::min(num_shards, capacity))) {
+    shard_capacity_ = (capacity_ + num_shards_ - 1) / num_shards_;
+    capacity_ = shard_capacity_ * num_shards_;
+    shards_.reset(new Shard[num_shards_]);
+
+    // at least 4 counters per cached row, rounded up to a power of two
+    uint64_t num_counters = 64;
+    while (num_counters < kNumHashes * capacity_) {
+        num_counters <<= 1;
+    }
+    frequencies_ = std::vector<std::atomic<uint8_t>>(num_counters);
+    frequency_mask_ = num_counters - 1;
+    aging_period_ = 10 * std::max(capacity_, size_t(1));
+}
+
+RowCache::Shard& RowCache::get_shard(Row row) const {
+    return shards_[mix(row) % num_shards_];
+}
+
+void RowCache::record_access(Row row) const {
+    uint64_t hash = mix(row + 1);
+    for (size_t i = 0; i < kNumHashes; ++i, hash = (hash >> 16) | (hash << 48)) {
+        auto &counter = frequencies_[hash & frequency_mask_];
+        uint8_t value = counter.load(std::memory_order_relaxed);
+        if (value < kMaxFrequency)
+            counter.store(value + 1, std::memory_order_relaxed);
+    }
+
+    // age the counters, so that the rows that were hot a while ago can be evicted
+    if (num_accesses_.fetch_add(1, std::memory_order_relaxed) + 1 == aging_period_) {
+        for (auto &counter : frequencies_) {
+            counter.store(counter.load(std::memory_order_relaxed) >> 1,
+                          std::memory_order_relaxed);
+        }
+        num_accesses_.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint8_t RowCache::estimate_frequency(Row row) const {
+    uint8_t frequency = kMaxFrequency;
+    uint64_t hash = mix(row + 1);
+    for (size_t i = 0; i < kNumHashes; ++i, hash = (hash >> 16) | (hash << 48)) {
+        frequency = std::min(frequency, frequencies_[hash & frequency_mask_].load(
+                                                            std::memory_order_relaxed));
+    }
+    return frequency;
+}
+
+bool RowCache::lookup(Row row, SetBitPositions *codes) const {
+    record_access(row);
+
+    Shard &shard = get_shard(row);
+    std::lock_guard<std::mutex> lock(shard.mu);
+
+    auto it = shard.slot_of_row.find(row);
+    if (it == shard.slot_of_row.end()) {
+        num_misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Entry &entry = shard.slots[it->second];
+    entry.referenced = true;
+    *codes = entry.codes;
+    num_hits_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void RowCache::admit(Row row, const SetBitPositions &codes) const {
+    if (!shard_capacity_)
+        return;
+
+    Shard &shard = get_shard(row);
+    std::lock_guard<std::mutex> lock(shard.mu);
+
+    // the row could have been added by another thread
+    if (shard.slot_of_row.count(row))
+        return;
+
+    if (shard.slots.size() < shard_capacity_) {
+        shard.slot_of_row[row] = shard.slots.size();
+        shard.slots.push_back({ row, codes, false });
+        return;
+    }
+
+    // CLOCK: find the first entry not referenced since the last sweep
+    while (shard.slots[shard.hand].referenced) {
+        shard.slots[shard.hand].referenced = false;
+        shard.hand = (shard.hand + 1) % shard.slots.size();
+    }
+
+    Entry &victim = shard.slots[shard.hand];
+    shard.hand = (shard.hand + 1) % shard.slots.size();
+
+    if (estimate_frequency(row) <= estimate_frequency(victim.row))
+        return;
+
+    shard.slot_of_row.erase(victim.row);
+    shard.slot_of_row[row] = &victim - shard.slots.data();
+    victim = { row, codes, false };
+}
+
+RowCache::SetBitPositions RowCache::get_row(Row row) const {
+    SetBitPositions codes;
+    if (!lookup(row, &codes)) {
+        codes = matrix_.get_row(row);
+        admit(row, codes);
+    }
+    return codes;
+}
+
+std::vector<RowCache::SetBitPositions>
+RowCache::get_rows(const std::vector<Row> &rows) const {
+    std::vector<SetBitPositions> result(rows.size());
+
+    std::vector<Row> missing_rows;
+    std::vector<size_t> missing_positions;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (!lookup(rows[i], &result[i])) {
+            missing_rows.push_back(rows[i]);
+            missing_positions.push_back(i);
+        }
+    }
+
+    if (missing_rows.empty())
+        return result;
+
+    auto fetched = matrix_.get_rows(missing_rows);
+    assert(fetched.size() == missing_rows.size());
+
+    for (size_t j = 0; j < fetched.size(); ++j) {
+        admit(missing_rows[j], fetched[j]);
+        result[missing_positions[j]] = std::move(fetched[j]);
+    }
+
+    return result;
+}
+
+size_t RowCache::size() const {
+    size_t size = 0;
+    for (size_t i = 0; i < num_shards_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mu);
+        size += shards_[i].slots.size();
+    }
+    return size;
+}
+
+double RowCache::hit_rate() const {
+    uint64_t hits = num_hits();
+    uint64_t total = hits + num_misses();
+    return total ? static_cast<double>(hits) / total : 0;
+}
+
+void RowCache::clear() {
+    for (size_t i = 0; i < num_shards_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mu);
+        shards_[i].slot_of_row.clear();
+        shards_[i].slots.clear();
+        shards_[i].hand = 0;
+    }
+    for (auto &counter : frequencies_) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    num_accesses_ = 0;
+    num_hits_ = 0;
+    num_misses_ = 0;
+}
+
+} // namespace binmat
+} // namespace annot
+} // namespace mtg
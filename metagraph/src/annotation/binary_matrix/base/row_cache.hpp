@@ -0,0 +1,96 @@
+#ifndef __ROW_CACHE_HPP__
+#define __ROW_CACHE_HPP__
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <tsl/hopscotch_map.h>
+
+#include "binary_matrix.hpp"
+
+
+namespace mtg {
+namespace annot {
+namespace binmat {
+
+/**
+ * A thread-safe, size-bounded cache of decoded rows of a binary matrix.
+ *
+ * The cache is split into shards with a separate lock each and uses the
+ * CLOCK eviction policy within every shard. A row missing in a full shard is
+ * only admitted if it has been accessed more frequently than the row it
+ * would replace (TinyLFU admission), so that rare rows (e.g., from a single
+ * scan) do not flush the hot ones. Access frequencies are approximated with
+ * a count-min sketch with 4-bit counters, which are periodically halved.
+ */
+class RowCache {
+  public:
+    typedef BinaryMatrix::Row Row;
+    typedef BinaryMatrix::SetBitPositions SetBitPositions;
+
+    /**
+     * @param matrix the matrix to query on cache misses
+     * @param capacity the maximum number of rows stored in the cache
+     * @param num_shards the number of independently locked parts of the cache
+     */
+    RowCache(const BinaryMatrix &matrix, size_t capacity, size_t num_shards = 64);
+
+    SetBitPositions get_row(Row row) const;
+    // query all missing rows from the matrix in a single batch
+    std::vector<SetBitPositions> get_rows(const std::vector<Row> &rows) const;
+
+    size_t capacity() const { return capacity_; }
+    size_t size() const;
+
+    uint64_t num_hits() const { return num_hits_.load(std::memory_order_relaxed); }
+    uint64_t num_misses() const { return num_misses_.load(std::memory_order_relaxed); }
+    double hit_rate() const;
+
+    void clear();
+
+  private:
+    struct Entry {
+        Row row;
+        SetBitPositions codes;
+        bool referenced;
+    };
+
+    struct Shard {
+        std::mutex mu;
+        tsl::hopscotch_map<Row, size_t> slot_of_row;
+        std::vector<Entry> slots;
+        size_t hand = 0;
+    };
+
+    Shard& get_shard(Row row) const;
+
+    // return true and fetch the cached row if it's in the cache
+    bool lookup(Row row, SetBitPositions *codes) const;
+    void admit(Row row, const SetBitPositions &codes) const;
+
+    void record_access(Row row) const;
+    uint8_t estimate_frequency(Row row) const;
+
+    const BinaryMatrix &matrix_;
+    size_t capacity_;
+    size_t num_shards_;
+    size_t shard_capacity_;
+    std::unique_ptr<Shard[]> shards_;
+
+    // count-min sketch for the access frequencies
+    mutable std::vector<std::atomic<uint8_t>> frequencies_;
+    uint64_t frequency_mask_;
+    mutable std::atomic<uint64_t> num_accesses_ = 0;
+    uint64_t aging_period_;
+
+    mutable std::atomic<uint64_t> num_hits_ = 0;
+    mutable std::atomic<uint64_t> num_misses_ = 0;
+};
+
+} // namespace binmat
+} // namespace annot
+} // namespace mtg
+
+#endif // __ROW_CACHE_HPP__
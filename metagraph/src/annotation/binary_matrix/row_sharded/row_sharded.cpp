@@ -0,0 +1,127 @@
+#include "row_sharded.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+
+namespace mtg {
+namespace annot {
+namespace binmat {
+
+RowSharded::RowSharded(std::vector<const BinaryMatrix*>&& shards, size_t num_threads)
+      : shards_(std::move(shards)), offsets_(1, 0), num_threads_(num_threads) {
+    for (const BinaryMatrix *shard : shards_) {
+        assert(shard);
+
+        if (shard->num_columns() != shards_.front()->num_columns())
+            throw std::runtime_error("Shards have different number of columns");
+
+        offsets_.push_back(offsets_.back() + shard->num_rows());
+    }
+}
+
+uint64_t RowSharded::num_columns() const {
+    return shards_.size() ? shards_.front()->num_columns() : 0;
+}
+
+size_t RowSharded::get_shard_idx(Row row) const {
+    assert(row < num_rows());
+    return std::upper_bound(offsets_.begin(), offsets_.end(), row) - offsets_.begin() - 1;
+}
+
+bool RowSharded::get(Row row, Column column) const {
+    size_t s = get_shard_idx(row);
+    return shards_[s]->get(row - offsets_[s], column);
+}
+
+RowSharded::SetBitPositions RowSharded::get_row(Row row) const {
+    size_t s = get_shard_idx(row);
+    return shards_[s]->get_row(row - offsets_[s]);
+}
+
+std::vector<std::pair<std::vector<RowSharded::Row>, std::vector<size_t>>>
+RowSharded::partition_rows(const std::vector<Row> &rows) const {
+    std::vector<std::pair<std::vector<Row>, std::vector<size_t>>> parts(shards_.size());
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        size_t s = get_shard_idx(rows[i]);
+        parts[s].first.push_back(rows[i] - offsets_[s]);
+        parts[s].second.push_back(i);
+    }
+
+    return parts;
+}
+
+std::vector<RowSharded::SetBitPositions>
+RowSharded::get_rows(const std::vector<Row> &row_ids) const {
+    std::vector<SetBitPositions> rows(row_ids.size());
+
+    const auto parts = partition_rows(row_ids);
+
+    #pragma omp parallel for num_threads(num_threads_) schedule(dynamic, 1)
+    for (size_t s = 0; s < parts.size(); ++s) {
+        const auto &[shard_rows, positions] = parts[s];
+        if (shard_rows.empty())
+            continue;
+
+        auto shard_result = shards_[s]->get_rows(shard_rows);
+        for (size_t i = 0; i < positions.size(); ++i) {
+            rows[positions[i]] = std::move(shard_result[i]);
+        }
+    }
+
+    return rows;
+}
+
+std::vector<RowSharded::Row> RowSharded::get_column(Column column) const {
+    std::vector<std::vector<Row>> parts(shards_.size());
+
+    #pragma omp parallel for num_threads(num_threads_) schedule(dynamic, 1)
+    for (size_t s = 0; s < shards_.size(); ++s) {
+        parts[s] = shards_[s]->get_column(column);
+    }
+
+    std::vector<Row> result;
+    for (size_t s = 0; s < parts.size(); ++s) {
+        for (Row row : parts[s]) {
+            result.push_back(row + offsets_[s]);
+        }
+    }
+
+    return result;
+}
+
+std::vector<RowSharded::Column>
+RowSharded::slice_rows(const std::vector<Row> &row_ids) const {
+    std::vector<Column> slice;
+
+    for (const auto &row : get_rows(row_ids)) {
+        for (Column j : row) {
+            slice.push_back(j);
+        }
+        slice.push_back(std::numeric_limits<Column>::max());
+    }
+
+    return slice;
+}
+
+bool RowSharded::load(std::istream &) {
+    throw std::runtime_error("The shards of RowSharded must be loaded separately");
+}
+
+void RowSharded::serialize(std::ostream &) const {
+    throw std::runtime_error("The shards of RowSharded must be serialized separately");
+}
+
+uint64_t RowSharded::num_relations() const {
+    uint64_t num_relations = 0;
+    for (const BinaryMatrix *shard : shards_) {
+        num_relations += shard->num_relations();
+    }
+    return num_relations;
+}
+
+} // namespace binmat
+} // namespace annot
+} // namespace mtg
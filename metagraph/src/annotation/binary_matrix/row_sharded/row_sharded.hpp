@@ -0,0 +1,70 @@
+#ifndef __ROW_SHARDED_HPP__
+#define __ROW_SHARDED_HPP__
+
+#include <vector>
+
+#include "annotation/binary_matrix/base/binary_matrix.hpp"
+
+
+namespace mtg {
+namespace annot {
+namespace binmat {
+
+/**
+ * A view of a binary matrix partitioned into shards by ranges of rows.
+ * The shard i stores rows [offsets[i], offsets[i + 1]) and all shards
+ * share the same columns.
+ *
+ * Row queries are routed to the respective shards and the shards are
+ * queried in parallel with |num_threads| threads.
+ *
+ * Warning: The view doesn't own the shards and will become invalid when
+ * any of them is destroyed.
+ */
+class RowSharded : public BinaryMatrix {
+  public:
+    RowSharded(std::vector<const BinaryMatrix*>&& shards = {},
+               size_t num_threads = 1);
+
+    uint64_t num_columns() const override;
+    uint64_t num_rows() const override { return offsets_.back(); }
+
+    bool get(Row row, Column column) const override;
+    SetBitPositions get_row(Row row) const override;
+    std::vector<SetBitPositions> get_rows(const std::vector<Row> &rows) const override;
+    std::vector<Row> get_column(Column column) const override;
+    // get all selected rows appended with -1 and concatenated
+    std::vector<Column> slice_rows(const std::vector<Row> &rows) const override;
+
+    // the view can't be (de)serialized, the shards must be loaded separately
+    bool load(std::istream &in) override;
+    void serialize(std::ostream &out) const override;
+
+    // number of ones in the matrix
+    uint64_t num_relations() const override;
+
+    size_t num_shards() const { return shards_.size(); }
+    const BinaryMatrix& get_shard(size_t i) const { return *shards_.at(i); }
+    const std::vector<uint64_t>& get_offsets() const { return offsets_; }
+
+    // return the index of the shard storing the row
+    size_t get_shard_idx(Row row) const;
+
+    void set_num_threads(size_t num_threads) { num_threads_ = num_threads; }
+
+  private:
+    // Split the rows by shards. Returns, for each shard, the local row
+    // indexes and the positions of these rows in |rows|.
+    std::vector<std::pair<std::vector<Row>, std::vector<size_t>>>
+    partition_rows(const std::vector<Row> &rows) const;
+
+    std::vector<const BinaryMatrix*> shards_;
+    std::vector<uint64_t> offsets_;
+    size_t num_threads_;
+};
+
+} // namespace binmat
+} // namespace annot
+} // namespace mtg
+
+#endif // __ROW_SHARDED_HPP__
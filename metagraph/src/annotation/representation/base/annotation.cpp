@@ -120,6 +120,17 @@ MultiLabelEncoded<LabelType>
 ::count_labels(const std::vector<std::pair<Index, size_t>> &index_counts,
                size_t min_count,
                size_t count_cap) const {
+    return count_labels(index_counts, min_count, count_cap,
+                        [&](Index i) { return get_matrix().get_row(i); });
+}
+
+template <typename LabelType>
+std::vector<std::pair<uint64_t /* label_code */, size_t /* count */>>
+MultiLabelEncoded<LabelType>
+::count_labels(const std::vector<std::pair<Index, size_t>> &index_counts,
+               size_t min_count,
+               size_t count_cap,
+               const std::function<binmat::BinaryMatrix::SetBitPositions(Index)> &get_row) const {
     assert(count_cap >= min_count);
 
     if (!count_cap)
@@ -143,7 +154,7 @@ MultiLabelEncoded<LabelType>
         if (max_matched + (total_sum_count - total_checked) < min_count)
             break;
 
-        for (size_t label_code : get_matrix().get_row(i)) {
+        for (size_t label_code : get_row(i)) {
             assert(label_code < code_counts.size());
 
             code_counts[label_code] += count;
@@ -177,6 +177,13 @@ class MultiLabelEncoded : public MultiLabelAnnotation<uint64_t, LabelType> {
                  size_t min_count = 1,
                  size_t count_cap = std::numeric_limits<size_t>::max()) const;
 
+    // same as above, but get the rows through |get_row| (e.g., from a cache)
+    std::vector<std::pair<uint64_t /* label_code */, size_t /* count */>>
+    count_labels(const std::vector<std::pair<Index, size_t>> &index_counts,
+                 size_t min_count,
+                 size_t count_cap,
+                 const std::function<binmat::BinaryMatrix::SetBitPositions(Index)> &get_row) const;
+
   protected:
     LabelEncoder<Label> label_encoder_;
 };
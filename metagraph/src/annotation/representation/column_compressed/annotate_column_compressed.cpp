@@ -4,6 +4,8 @@
 #include <numeric>
 #include <algorithm>
 #include <stdexcept>
+#include <filesystem>
+#include <sstream>
 
 #include "common/serialization.hpp"
 #include "common/utils/string_utils.hpp"
@@ -319,6 +321,194 @@ bool ColumnCompressed<Label>::merge_load(const std::vector<std::string> &filenam
     return !error_occurred;
 }
 
+template <typename Label>
+bool ColumnCompressed<Label>::merge_serialize(const std::vector<std::string> &filenames,
+                                              const std::string &outfbase,
+                                              size_t mem_bytes,
+                                              size_t num_threads) {
+    // location of a serialized column in one of the input files
+    struct ColumnLocation {
+        size_t file_idx;
+        std::streamoff offset;
+        uint64_t size;
+    };
+
+    std::vector<std::string> files(filenames.size());
+    std::vector<uint64_t> num_rows(filenames.size(), 0);
+    std::vector<LabelEncoder<Label>> label_encoders(filenames.size());
+    std::vector<std::vector<ColumnLocation>> locations(filenames.size());
+
+    std::atomic<bool> error_occurred = false;
+
+    // index the columns stored in the input files
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        try {
+            files[i] = remove_suffix(filenames[i], kExtension) + kExtension;
+
+            std::ifstream instream(files[i], std::ios::binary);
+            if (!instream.good())
+                throw std::ifstream::failure("can't open stream " + files[i]);
+
+            num_rows[i] = load_number(instream);
+
+            if (!label_encoders[i].load(instream))
+                throw std::ifstream::failure("can't load label encoder from " + files[i]);
+
+            if (!label_encoders[i].size())
+                logger->warn("No labels in {}", files[i]);
+
+            const uint64_t file_size = std::filesystem::file_size(files[i]);
+
+            for (size_t c = 0; c < label_encoders[i].size(); ++c) {
+                std::streamoff offset = instream.tellg();
+                // the last column spans until the end of the file,
+                // so only the preceding columns have to be read to be skipped
+                if (c + 1 == label_encoders[i].size()) {
+                    locations[i].push_back({ i, offset, file_size - offset });
+                    break;
+                }
+
+                bit_vector_smart column;
+                if (!column.load(instream))
+                    throw std::ifstream::failure("can't load next column " + files[i]);
+
+                if (column.size() != num_rows[i])
+                    throw std::ifstream::failure("inconsistent column size " + files[i]);
+
+                locations[i].push_back({ i, offset, static_cast<uint64_t>(instream.tellg() - offset) });
+            }
+        } catch (const std::exception &e) {
+            logger->error("Caught exception when indexing columns: {}", e.what());
+            error_occurred = true;
+        } catch (...) {
+            logger->error("Unknown exception when indexing columns");
+            error_occurred = true;
+        }
+    }
+
+    if (error_occurred)
+        return false;
+
+    for (size_t i = 1; i < filenames.size(); ++i) {
+        if (num_rows[i] != num_rows[0]) {
+            logger->error("Inconsistent number of rows in {} and {}", files[0], files[i]);
+            return false;
+        }
+    }
+
+    // merge label encoders and collect the source columns for each label
+    LabelEncoder<Label> label_encoder;
+    std::vector<std::vector<ColumnLocation>> sources;
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        for (size_t c = 0; c < label_encoders[i].size(); ++c) {
+            size_t j = label_encoder.insert_and_encode(label_encoders[i].decode(c));
+            if (j == sources.size())
+                sources.emplace_back();
+
+            sources[j].push_back(locations[i][c]);
+        }
+        label_encoders[i].clear();
+    }
+
+    const std::string outfile = remove_suffix(outfbase, kExtension) + kExtension;
+    std::ofstream outstream(outfile, std::ios::binary);
+    if (!outstream.good()) {
+        logger->error("Could not open {}", outfile);
+        return false;
+    }
+
+    serialize_number(outstream, num_rows.empty() ? 0 : num_rows[0]);
+    label_encoder.serialize(outstream);
+
+    // Columns with a single source are copied as is. The others are
+    // decompressed, ORed, and compressed again.
+    const uint64_t bitmap_bytes = num_rows.empty() ? 0 : (num_rows[0] + 7) / 8;
+    auto estimate_memory = [&](const std::vector<ColumnLocation> &column_sources) {
+        uint64_t max_size = 0;
+        for (const auto &location : column_sources) {
+            max_size = std::max(max_size, location.size);
+        }
+        return column_sources.size() == 1 ? max_size : 2 * bitmap_bytes + max_size;
+    };
+
+    auto read_serialized_column = [&](const ColumnLocation &location) {
+        std::ifstream instream(files[location.file_idx], std::ios::binary);
+        instream.seekg(location.offset);
+        std::string buffer(location.size, '\0');
+        if (!instream.read(buffer.data(), buffer.size()))
+            throw std::ifstream::failure("can't read column from " + files[location.file_idx]);
+        return buffer;
+    };
+
+    auto merge_columns = [&](const std::vector<ColumnLocation> &column_sources) {
+        if (column_sources.size() == 1)
+            return read_serialized_column(column_sources[0]);
+
+        sdsl::bit_vector merged(num_rows[0], false);
+        for (const auto &location : column_sources) {
+            std::istringstream instream(read_serialized_column(location));
+            bit_vector_smart column;
+            if (!column.load(instream))
+                throw std::ifstream::failure("can't load column from " + files[location.file_idx]);
+
+            if (column.size() != num_rows[0])
+                throw std::ifstream::failure("inconsistent column size " + files[location.file_idx]);
+
+            column.add_to(&merged);
+        }
+
+        std::ostringstream out;
+        bit_vector_smart(std::move(merged)).serialize(out);
+        return out.str();
+    };
+
+    for (size_t begin = 0; begin < sources.size(); ) {
+        // form the next group of columns fitting into the memory budget
+        size_t end = begin + 1;
+        uint64_t group_memory = estimate_memory(sources[begin]);
+        while (end < sources.size()
+                && group_memory + estimate_memory(sources[end]) <= mem_bytes) {
+            group_memory += estimate_memory(sources[end++]);
+        }
+
+        std::vector<std::string> merged_columns(end - begin);
+
+        #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+        for (size_t j = begin; j < end; ++j) {
+            try {
+                merged_columns[j - begin] = merge_columns(sources[j]);
+            } catch (const std::exception &e) {
+                logger->error("Caught exception when merging columns: {}", e.what());
+                error_occurred = true;
+            } catch (...) {
+                logger->error("Unknown exception when merging columns");
+                error_occurred = true;
+            }
+        }
+
+        if (error_occurred)
+            return false;
+
+        for (const std::string &column : merged_columns) {
+            outstream.write(column.data(), column.size());
+        }
+
+        logger->trace("Merged columns {}-{} out of {}", begin, end - 1, sources.size());
+
+        begin = end;
+    }
+
+    if (!outstream.good()) {
+        logger->error("Failed to write to {}", outfile);
+        return false;
+    }
+
+    logger->trace("Annotation merging finished ({} columns)", sources.size());
+
+    return true;
+}
+
 template <typename Label>
 void ColumnCompressed<Label>::insert_rows(const std::vector<Index> &rows) {
     assert(std::is_sorted(rows.begin(), rows.end()));
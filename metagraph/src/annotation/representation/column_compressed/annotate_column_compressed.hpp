@@ -54,6 +54,17 @@ class ColumnCompressed : public MultiLabelEncoded<Label> {
     static bool merge_load(const std::vector<std::string> &filenames,
                            const ColumnCallback &callback,
                            size_t num_threads = 1);
+    /**
+     * Merge annotations from |filenames| and serialize the result to |outfbase|
+     * without loading the input annotations in memory.
+     * The columns are merged (ORed) in groups of labels, such that the columns
+     * of each group take at most |mem_bytes| bytes in memory.
+     * The relation counts are not merged.
+     */
+    static bool merge_serialize(const std::vector<std::string> &filenames,
+                                const std::string &outfbase,
+                                size_t mem_bytes,
+                                size_t num_threads = 1);
     // Dump columns to separate files in human-readable format
     bool dump_columns(const std::string &prefix, size_t num_threads = 1) const;
 
@@ -0,0 +1,283 @@
+#include "annotate_delta.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include "common/serialization.hpp"
+#include "common/utils/string_utils.hpp"
+#include "common/logger.hpp"
+
+
+namespace mtg {
+namespace annot {
+
+using utils::remove_suffix;
+using mtg::common::logger;
+
+
+DeltaAnnotation::DeltaAnnotation(std::shared_ptr<const Annotator> base, uint64_t num_rows)
+      : base_(base), num_rows_(num_rows), matrix_(*this) {
+    assert(base_.get());
+    assert(num_rows_ >= base_->num_objects());
+
+    // keep the label codes of the base annotation
+    label_encoder_.merge(base_->get_label_encoder());
+    assert(label_encoder_.size() == base_->num_labels());
+}
+
+void DeltaAnnotation::set(Index i, const VLabels &labels) {
+    assert(i < num_rows_);
+
+    if (i < base_->num_objects()) {
+        for (const Label &label : base_->get(i)) {
+            if (std::find(labels.begin(), labels.end(), label) == labels.end())
+                throw std::runtime_error("Labels of the base annotation can't be removed");
+        }
+    }
+
+    auto it = delta_rows_.find(i);
+    if (it != delta_rows_.end()) {
+        num_delta_relations_ -= it->second.size();
+        delta_rows_.erase(it);
+    }
+
+    add_labels({ i }, labels);
+}
+
+void DeltaAnnotation::add_labels(const std::vector<Index> &indices,
+                                 const VLabels &labels) {
+    std::vector<uint64_t> codes;
+    codes.reserve(labels.size());
+    for (const Label &label : labels) {
+        codes.push_back(label_encoder_.insert_and_encode(label));
+    }
+
+    std::vector<Index> base_indices;
+    for (Index i : indices) {
+        if (i < base_->num_objects())
+            base_indices.push_back(i);
+    }
+    const auto base_rows = base_->get_matrix().get_rows(base_indices);
+
+    auto base_row_it = base_rows.begin();
+
+    for (Index i : indices) {
+        assert(i < num_rows_);
+
+        const binmat::BinaryMatrix::SetBitPositions *base_row = nullptr;
+        if (i < base_->num_objects()) {
+            assert(base_row_it != base_rows.end());
+            base_row = &*base_row_it++;
+        }
+
+        for (uint64_t code : codes) {
+            // skip the relations stored in the base annotation
+            if (base_row && std::find(base_row->begin(), base_row->end(), code) != base_row->end())
+                continue;
+
+            auto &row = delta_rows_[i];
+            auto it = std::lower_bound(row.begin(), row.end(), code);
+            if (it == row.end() || *it != code) {
+                row.insert(it, code);
+                num_delta_relations_++;
+            }
+        }
+    }
+}
+
+bool DeltaAnnotation::has_label(Index i, const Label &label) const {
+    assert(i < num_rows_);
+
+    if (!label_encoder_.label_exists(label))
+        return false;
+
+    return matrix_.get(i, label_encoder_.encode(label));
+}
+
+bool DeltaAnnotation::has_labels(Index i, const VLabels &labels) const {
+    return std::all_of(labels.begin(), labels.end(),
+                       [&](const Label &label) { return has_label(i, label); });
+}
+
+void DeltaAnnotation::insert_rows(const std::vector<Index> &rows) {
+    assert(std::is_sorted(rows.begin(), rows.end()));
+
+    for (size_t j = 0; j < rows.size(); ++j) {
+        if (rows[j] != num_rows_ + j)
+            throw std::runtime_error("Only rows appended to the end can be inserted");
+    }
+    num_rows_ += rows.size();
+}
+
+void DeltaAnnotation::call_objects(const Label &label,
+                                   std::function<void(Index)> callback) const {
+    if (!label_exists(label))
+        return;
+
+    for (Index i : matrix_.get_column(label_encoder_.encode(label))) {
+        callback(i);
+    }
+}
+
+void DeltaAnnotation::add_delta(Index row,
+                                binmat::BinaryMatrix::SetBitPositions *label_codes) const {
+    auto it = delta_rows_.find(row);
+    if (it == delta_rows_.end())
+        return;
+
+    size_t size = label_codes->size();
+    label_codes->insert(label_codes->end(), it->second.begin(), it->second.end());
+    std::inplace_merge(label_codes->begin(), label_codes->begin() + size, label_codes->end());
+}
+
+void DeltaAnnotation::serialize(const std::string &filename) const {
+    std::ofstream out(remove_suffix(filename, kExtension) + kExtension, std::ios::binary);
+    if (!out.good())
+        throw std::ofstream::failure("Bad stream");
+
+    label_encoder_.serialize(out);
+    serialize_number(out, num_rows_);
+    serialize_number(out, delta_rows_.size());
+    for (const auto &[i, codes] : delta_rows_) {
+        serialize_number(out, i);
+        serialize_number(out, codes.size());
+        for (uint64_t code : codes) {
+            serialize_number(out, code);
+        }
+    }
+}
+
+bool DeltaAnnotation::merge_load(const std::vector<std::string> &filenames) {
+    if (filenames.size() != 1) {
+        logger->error("Only one delta annotation can be loaded");
+        return false;
+    }
+
+    std::ifstream in(remove_suffix(filenames[0], kExtension) + kExtension, std::ios::binary);
+    if (!in.good())
+        return false;
+
+    try {
+        LabelEncoder<Label> label_encoder;
+        if (!label_encoder.load(in))
+            return false;
+
+        // the base labels must have the same codes
+        const auto &base_labels = base_->get_all_labels();
+        if (label_encoder.size() < base_labels.size()
+                || !std::equal(base_labels.begin(), base_labels.end(),
+                               label_encoder.get_labels().begin())) {
+            logger->error("The delta annotation is incompatible with the base annotation");
+            return false;
+        }
+
+        uint64_t num_rows = load_number(in);
+        if (num_rows < base_->num_objects()) {
+            logger->error("The delta annotation is incompatible with the base annotation");
+            return false;
+        }
+
+        tsl::hopscotch_map<Index, binmat::BinaryMatrix::SetBitPositions> delta_rows;
+        uint64_t num_delta_relations = 0;
+        for (uint64_t size = load_number(in); size > 0; --size) {
+            Index i = load_number(in);
+            auto &codes = delta_rows[i];
+            codes.resize(load_number(in));
+            for (auto &code : codes) {
+                code = load_number(in);
+            }
+            num_delta_relations += codes.size();
+        }
+
+        label_encoder_ = std::move(label_encoder);
+        num_rows_ = num_rows;
+        delta_rows_ = std::move(delta_rows);
+        num_delta_relations_ = num_delta_relations;
+
+        return true;
+
+    } catch (...) {
+        return false;
+    }
+}
+
+
+bool DeltaAnnotation::DeltaMatrix::get(Row row, Column column) const {
+    assert(row < num_rows());
+    assert(column < num_columns());
+
+    auto it = anno_.delta_rows_.find(row);
+    if (it != anno_.delta_rows_.end()
+            && std::binary_search(it->second.begin(), it->second.end(), column))
+        return true;
+
+    const auto &base_matrix = anno_.base_->get_matrix();
+    return row < base_matrix.num_rows()
+            && column < base_matrix.num_columns()
+            && base_matrix.get(row, column);
+}
+
+binmat::BinaryMatrix::SetBitPositions DeltaAnnotation::DeltaMatrix::get_row(Row row) const {
+    assert(row < num_rows());
+
+    SetBitPositions label_codes;
+
+    const auto &base_matrix = anno_.base_->get_matrix();
+    if (row < base_matrix.num_rows()) {
+        label_codes = base_matrix.get_row(row);
+        std::sort(label_codes.begin(), label_codes.end());
+    }
+
+    anno_.add_delta(row, &label_codes);
+    return label_codes;
+}
+
+std::vector<binmat::BinaryMatrix::SetBitPositions>
+DeltaAnnotation::DeltaMatrix::get_rows(const std::vector<Row> &rows) const {
+    const auto &base_matrix = anno_.base_->get_matrix();
+
+    // query the base rows in a single batch
+    std::vector<Row> base_rows;
+    for (Row row : rows) {
+        if (row < base_matrix.num_rows())
+            base_rows.push_back(row);
+    }
+    auto base_row_codes = base_matrix.get_rows(base_rows);
+
+    std::vector<SetBitPositions> result(rows.size());
+    auto it = base_row_codes.begin();
+    for (size_t i = 0; i < rows.size(); ++i) {
+        assert(rows[i] < num_rows());
+
+        if (rows[i] < base_matrix.num_rows()) {
+            result[i] = std::move(*it++);
+            std::sort(result[i].begin(), result[i].end());
+        }
+        anno_.add_delta(rows[i], &result[i]);
+    }
+
+    return result;
+}
+
+std::vector<binmat::BinaryMatrix::Row>
+DeltaAnnotation::DeltaMatrix::get_column(Column column) const {
+    assert(column < num_columns());
+
+    std::vector<Row> rows;
+
+    const auto &base_matrix = anno_.base_->get_matrix();
+    if (column < base_matrix.num_columns())
+        rows = base_matrix.get_column(column);
+
+    for (const auto &[row, codes] : anno_.delta_rows_) {
+        if (std::binary_search(codes.begin(), codes.end(), column))
+            rows.push_back(row);
+    }
+
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+} // namespace annot
+} // namespace mtg
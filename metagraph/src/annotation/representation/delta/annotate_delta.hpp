@@ -0,0 +1,120 @@
+#ifndef __ANNOTATE_DELTA_HPP__
+#define __ANNOTATE_DELTA_HPP__
+
+#include <memory>
+
+#include <tsl/hopscotch_map.h>
+
+#include "annotation/representation/base/annotation.hpp"
+
+
+namespace mtg {
+namespace annot {
+
+/**
+ * DeltaAnnotation extends a static base annotation with a small dynamic delta.
+ * The relations added after the base annotation was built are stored as sparse
+ * rows in a hash map, both for the rows of the base annotation and for the
+ * rows appended after them (e.g., for the nodes added to a DeltaDBG).
+ * The label codes of the base annotation are preserved.
+ *
+ * Multithreading:
+ *  The non-const methods must be called sequentially.
+ *  Then, any subset of the public const methods can be called concurrently.
+ */
+class DeltaAnnotation : public MultiLabelEncoded<std::string> {
+  public:
+    typedef MultiLabelEncoded<std::string> Annotator;
+    using Index = Annotator::Index;
+    using Label = Annotator::Label;
+    using VLabels = Annotator::VLabels;
+
+    /**
+     * @param base the static annotation
+     * @param num_rows the number of rows, at least base->num_objects()
+     */
+    DeltaAnnotation(std::shared_ptr<const Annotator> base, uint64_t num_rows);
+
+    DeltaAnnotation(const DeltaAnnotation&) = delete;
+    DeltaAnnotation& operator=(const DeltaAnnotation&) = delete;
+
+    // The labels of the base annotation can't be removed
+    void set(Index i, const VLabels &labels) override;
+
+    void add_labels(const std::vector<Index> &indices,
+                    const VLabels &labels) override;
+
+    bool has_label(Index i, const Label &label) const override;
+    bool has_labels(Index i, const VLabels &labels) const override;
+
+    // Only appending rows is supported
+    void insert_rows(const std::vector<Index> &rows) override;
+
+    void rename_labels(const tsl::hopscotch_map<Label, Label> &) override {
+        throw std::runtime_error("Not implemented");
+    }
+
+    uint64_t num_objects() const override { return num_rows_; }
+    uint64_t num_relations() const override {
+        return base_->num_relations() + num_delta_relations_;
+    }
+    // the number of relations stored in the delta
+    uint64_t num_delta_relations() const { return num_delta_relations_; }
+
+    void call_objects(const Label &label,
+                      std::function<void(Index)> callback) const override;
+
+    const binmat::BinaryMatrix& get_matrix() const override { return matrix_; }
+
+    const Annotator& get_base_annotation() const { return *base_; }
+    std::shared_ptr<const Annotator> get_base_annotation_ptr() const { return base_; }
+
+    // Serialize the delta only
+    void serialize(const std::string &filename) const override;
+    // Load the delta. The base annotation must be the one it was built for.
+    bool merge_load(const std::vector<std::string> &filenames) override;
+
+    std::string file_extension() const override { return kExtension; }
+
+    static constexpr auto kExtension = ".delta.annodbg";
+
+  private:
+    // A view of the base matrix with the delta rows added
+    class DeltaMatrix : public binmat::BinaryMatrix {
+      public:
+        explicit DeltaMatrix(const DeltaAnnotation &annotation) : anno_(annotation) {}
+
+        uint64_t num_columns() const override { return anno_.label_encoder_.size(); }
+        uint64_t num_rows() const override { return anno_.num_rows_; }
+
+        bool get(Row row, Column column) const override;
+        SetBitPositions get_row(Row row) const override;
+        std::vector<SetBitPositions> get_rows(const std::vector<Row> &rows) const override;
+        std::vector<Row> get_column(Column column) const override;
+
+        bool load(std::istream &) override { throw std::runtime_error("Not implemented"); }
+        void serialize(std::ostream &) const override { throw std::runtime_error("Not implemented"); }
+
+        uint64_t num_relations() const override { return anno_.num_relations(); }
+
+      private:
+        const DeltaAnnotation &anno_;
+    };
+
+    // add the delta relations of |row| to the sorted |label_codes|
+    void add_delta(Index row, binmat::BinaryMatrix::SetBitPositions *label_codes) const;
+
+    std::shared_ptr<const Annotator> base_;
+    uint64_t num_rows_;
+
+    // sorted label codes added to the rows
+    tsl::hopscotch_map<Index, binmat::BinaryMatrix::SetBitPositions> delta_rows_;
+    uint64_t num_delta_relations_ = 0;
+
+    DeltaMatrix matrix_;
+};
+
+} // namespace annot
+} // namespace mtg
+
+#endif // __ANNOTATE_DELTA_HPP__
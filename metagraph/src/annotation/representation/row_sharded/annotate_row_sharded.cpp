@@ -0,0 +1,137 @@
+#include "annotate_row_sharded.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "common/logger.hpp"
+#include "common/utils/string_utils.hpp"
+
+
+namespace mtg {
+namespace annot {
+
+using mtg::common::logger;
+
+
+template <typename Label>
+std::vector<const binmat::BinaryMatrix*>
+get_shard_matrices(const std::vector<std::unique_ptr<MultiLabelEncoded<Label>>> &shards) {
+    std::vector<const binmat::BinaryMatrix*> matrices;
+    for (const auto &shard : shards) {
+        matrices.push_back(&shard->get_matrix());
+    }
+    return matrices;
+}
+
+template <typename Label>
+RowShardedAnnotator<Label>
+::RowShardedAnnotator(std::vector<std::unique_ptr<Shard>>&& shards,
+                      size_t num_threads)
+      : shards_(std::move(shards)),
+        matrix_(get_shard_matrices(shards_), num_threads),
+        num_threads_(num_threads) {
+    if (shards_.empty())
+        throw std::runtime_error("No shards passed");
+
+    label_encoder_ = shards_.front()->get_label_encoder();
+
+    for (const auto &shard : shards_) {
+        if (shard->get_all_labels() != label_encoder_.get_labels())
+            throw std::runtime_error("Shards must have identical label encoders");
+    }
+}
+
+template <typename Label>
+bool RowShardedAnnotator<Label>::has_label(Index i, const Label &label) const {
+    size_t s = matrix_.get_shard_idx(i);
+    return shards_[s]->has_label(i - matrix_.get_offsets()[s], label);
+}
+
+template <typename Label>
+bool RowShardedAnnotator<Label>::has_labels(Index i, const VLabels &labels) const {
+    size_t s = matrix_.get_shard_idx(i);
+    return shards_[s]->has_labels(i - matrix_.get_offsets()[s], labels);
+}
+
+template <typename Label>
+std::string RowShardedAnnotator<Label>
+::shard_filename(const std::string &filebase, size_t shard_idx) {
+    return filebase + ".shard" + std::to_string(shard_idx);
+}
+
+template <typename Label>
+void RowShardedAnnotator<Label>::serialize(const std::string &filename) const {
+    const std::string filebase = utils::remove_suffix(filename, file_extension());
+    for (size_t s = 0; s < shards_.size(); ++s) {
+        shards_[s]->serialize(shard_filename(filebase, s));
+    }
+}
+
+template <typename Label>
+bool RowShardedAnnotator<Label>::merge_load(const std::vector<std::string> &) {
+    logger->error("Shards must be loaded separately and passed to RowShardedAnnotator");
+    return false;
+}
+
+template <typename Label>
+std::string RowShardedAnnotator<Label>::file_extension() const {
+    return shards_.front()->file_extension();
+}
+
+template <typename Label>
+std::vector<std::pair<uint64_t, size_t>> RowShardedAnnotator<Label>
+::count_labels(const std::vector<std::pair<Index, size_t>> &index_counts,
+               size_t min_count,
+               size_t count_cap) const {
+    assert(count_cap >= min_count);
+
+    if (!count_cap)
+        return {};
+
+    min_count = std::max(min_count, size_t(1));
+
+    // route rows to their shards
+    std::vector<std::vector<std::pair<Index, size_t>>> shard_index_counts(shards_.size());
+    for (const auto &[i, count] : index_counts) {
+        size_t s = matrix_.get_shard_idx(i);
+        shard_index_counts[s].emplace_back(i - matrix_.get_offsets()[s], count);
+    }
+
+    std::vector<std::vector<std::pair<uint64_t, size_t>>> shard_counts(shards_.size());
+
+    #pragma omp parallel for num_threads(num_threads_) schedule(dynamic, 1)
+    for (size_t s = 0; s < shards_.size(); ++s) {
+        if (shard_index_counts[s].size())
+            shard_counts[s] = shards_[s]->count_labels(shard_index_counts[s]);
+    }
+
+    // merge the counts
+    std::vector<size_t> code_counts(this->num_labels(), 0);
+    for (const auto &label_counts : shard_counts) {
+        for (const auto &[label_code, count] : label_counts) {
+            assert(label_code < code_counts.size());
+            code_counts[label_code] += count;
+        }
+    }
+
+    std::vector<std::pair<uint64_t, size_t>> label_counts;
+
+    for (size_t label_code = 0; label_code < code_counts.size(); ++label_code) {
+        if (code_counts[label_code] >= min_count) {
+            label_counts.emplace_back(label_code,
+                                      std::min(code_counts[label_code], count_cap));
+        }
+    }
+
+    return label_counts;
+}
+
+template <typename Label>
+void RowShardedAnnotator<Label>::except_dyn() const {
+    throw std::runtime_error("Row-sharded annotation can't be modified");
+}
+
+template class RowShardedAnnotator<std::string>;
+
+} // namespace annot
+} // namespace mtg
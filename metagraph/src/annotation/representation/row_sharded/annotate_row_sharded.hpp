@@ -0,0 +1,83 @@
+#ifndef __ANNOTATE_ROW_SHARDED_HPP__
+#define __ANNOTATE_ROW_SHARDED_HPP__
+
+#include <memory>
+#include <vector>
+
+#include "annotation/representation/base/annotation.hpp"
+#include "annotation/binary_matrix/row_sharded/row_sharded.hpp"
+
+
+namespace mtg {
+namespace annot {
+
+/**
+ * Annotation partitioned into shards by ranges of rows.
+ *
+ * The shards are independent annotators (of any static or dynamic type)
+ * with identical label encoders, each storing a contiguous range of rows.
+ * The shard i stores rows starting from the sum of the numbers of rows
+ * of the shards 0, ..., i - 1.
+ *
+ * Row queries are routed to the respective shards, which are queried in
+ * parallel, and the results are merged. The shards are never modified.
+ */
+template <typename Label = std::string>
+class RowShardedAnnotator : public MultiLabelEncoded<Label> {
+  public:
+    using Index = typename MultiLabelEncoded<Label>::Index;
+    using VLabels = typename MultiLabelEncoded<Label>::VLabels;
+    using Shard = MultiLabelEncoded<Label>;
+
+    /**
+     * Throws std::runtime_error if the label encoders of the shards differ.
+     */
+    RowShardedAnnotator(std::vector<std::unique_ptr<Shard>>&& shards,
+                        size_t num_threads = 1);
+
+    bool has_label(Index i, const Label &label) const override;
+    bool has_labels(Index i, const VLabels &labels) const override;
+
+    // serialize the shards to files '<filename>.shard<i>'
+    void serialize(const std::string &filename) const override;
+    bool merge_load(const std::vector<std::string> &filenames) override;
+
+    uint64_t num_objects() const override { return matrix_.num_rows(); }
+    uint64_t num_relations() const override { return matrix_.num_relations(); }
+
+    void set(Index, const VLabels &) override { except_dyn(); }
+    void add_labels(const std::vector<Index> &, const VLabels &) override { except_dyn(); }
+    void insert_rows(const std::vector<Index> &) override { except_dyn(); }
+    void rename_labels(const tsl::hopscotch_map<Label, Label> &) override { except_dyn(); }
+
+    /**
+     * Count labels in the shards in parallel and merge the counts.
+     */
+    std::vector<std::pair<uint64_t /* label_code */, size_t /* count */>>
+    count_labels(const std::vector<std::pair<Index, size_t>> &index_counts,
+                 size_t min_count = 1,
+                 size_t count_cap = std::numeric_limits<size_t>::max()) const override;
+
+    const binmat::RowSharded& get_matrix() const override { return matrix_; }
+
+    size_t num_shards() const { return shards_.size(); }
+    const Shard& get_shard(size_t i) const { return *shards_.at(i); }
+
+    std::string file_extension() const override;
+
+    static std::string shard_filename(const std::string &filebase, size_t shard_idx);
+
+  private:
+    void except_dyn() const;
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    binmat::RowSharded matrix_;
+    size_t num_threads_;
+
+    using MultiLabelEncoded<Label>::label_encoder_;
+};
+
+} // namespace annot
+} // namespace mtg
+
+#endif // __ANNOTATE_ROW_SHARDED_HPP__
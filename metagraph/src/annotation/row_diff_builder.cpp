@@ -2,18 +2,22 @@
 
 #include <omp.h>
 #include <progress_bar.hpp>
+#include <tsl/hopscotch_map.h>
 
 #include "annotation/binary_matrix/row_diff/row_diff.hpp"
 #include "annotation/representation/annotation_matrix/static_annotators_def.hpp"
 #include "common/threads/threading.hpp"
 #include "common/file_merger.hpp"
+#include "common/unix_tools.hpp"
 #include "common/utils/file_utils.hpp"
 #include "common/vectors/bit_vector_sd.hpp"
 #include "graph/annotated_dbg.hpp"
+#include "seq_io/sequence_io.hpp"
 
 constexpr uint64_t BLOCK_SIZE = 1 << 25;
 constexpr uint64_t ROW_REDUCTION_WIDTH = 32;
 constexpr uint32_t MAX_NUM_FILES_OPEN = 2000;
+constexpr uint64_t QUERY_BATCH_SIZE = 10'000;
 
 namespace mtg {
 namespace annot {
@@ -675,5 +679,193 @@ void optimize_anchors_in_row_diff(const std::string &graph_fname,
     logger->trace("Serialized optimized anchors to {}", graph_fname + kRowDiffAnchorExt);
 }
 
+/**
+ * Count the queried rows (with multiplicity) by mapping the query sequences
+ * to the graph.
+ */
+tsl::hopscotch_map<uint64_t, uint64_t>
+count_queried_rows(const graph::DBGSuccinct &graph,
+                   const std::vector<std::string> &query_files,
+                   size_t num_threads) {
+    tsl::hopscotch_map<uint64_t, uint64_t> row_counts;
+
+    std::vector<std::string> batch;
+    auto process_batch = [&]() {
+        std::vector<std::vector<uint64_t>> rows(batch.size());
+
+        #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+        for (size_t i = 0; i < batch.size(); ++i) {
+            graph.map_to_nodes(batch[i], [&](auto node) {
+                if (node)
+                    rows[i].push_back(graph::AnnotatedSequenceGraph::graph_to_anno_index(node));
+            });
+        }
+
+        for (const auto &seq_rows : rows) {
+            for (uint64_t row : seq_rows) {
+                row_counts[row]++;
+            }
+        }
+        batch.clear();
+    };
+
+    for (const auto &file : query_files) {
+        logger->trace("Mapping queries from {}", file);
+        seq_io::read_fasta_file_critical(file, [&](kseq_t *read) {
+            batch.emplace_back(read->seq.s, read->seq.l);
+            if (batch.size() == QUERY_BATCH_SIZE)
+                process_batch();
+        });
+    }
+    process_batch();
+
+    return row_counts;
+}
+
+/**
+ * Return the number of successors to reach an anchor from |row| (the number
+ * of diffs merged when reconstructing the row is that plus one), traversing
+ * at most |max_depth| successors. If no anchor is reached, return |max_depth|
+ * and set |last_row| to the row reached last.
+ */
+uint32_t get_row_diff_depth(const graph::DBGSuccinct &graph,
+                            const sdsl::bit_vector &anchors,
+                            uint64_t row,
+                            uint32_t max_depth,
+                            uint64_t *last_row = nullptr) {
+    const graph::boss::BOSS &boss = graph.get_boss();
+    graph::boss::BOSS::edge_index boss_edge = graph.kmer_to_boss_index(
+            graph::AnnotatedSequenceGraph::anno_to_graph_index(row));
+
+    uint32_t depth = 0;
+    while (!anchors[row] && depth < max_depth) {
+        graph::boss::BOSS::TAlphabet w = boss.get_W(boss_edge);
+        assert(boss_edge > 1 && w != 0);
+
+        // same as in RowDiff: follow the last outgoing edge
+        boss_edge = boss.fwd(boss_edge, w % boss.alph_size);
+        row = graph::AnnotatedSequenceGraph::graph_to_anno_index(
+                graph.boss_to_kmer_index(boss_edge));
+        depth++;
+    }
+
+    if (last_row)
+        *last_row = row;
+
+    return depth;
+}
+
+void optimize_anchors_for_queries(const std::string &graph_fname,
+                                  const std::string &anchors_fname,
+                                  const std::vector<std::string> &query_files,
+                                  uint32_t max_depth,
+                                  double max_extra_anchors) {
+    if (query_files.empty())
+        return;
+
+    logger->trace("Optimizing anchors for the queries in {} files", query_files.size());
+
+    graph::DBGSuccinct graph(2);
+    if (!graph.load(graph_fname)) {
+        logger->error("Cannot load graph from {}", graph_fname);
+        std::exit(1);
+    }
+
+    sdsl::bit_vector anchors;
+    {
+        anchor_bv_type old_anchors;
+        std::ifstream f(anchors_fname, ios::binary);
+        if (!old_anchors.load(f)) {
+            logger->error("Cannot load anchors from {}", anchors_fname);
+            std::exit(1);
+        }
+        if (old_anchors.size() != graph.num_nodes()) {
+            logger->error("Anchors {}: {} and graph: {} are incompatible",
+                          anchors_fname, old_anchors.size(), graph.num_nodes());
+            exit(1);
+        }
+        anchors = old_anchors.convert_to<sdsl::bit_vector>();
+    }
+    const uint64_t num_anchors_old = sdsl::util::cnt_one_bits(anchors);
+
+    const size_t num_threads = get_num_threads();
+
+    Timer timer;
+    auto row_counts = count_queried_rows(graph, query_files, num_threads);
+
+    // process the most frequently queried rows first
+    std::vector<std::pair<uint64_t, uint64_t>> queried_rows(row_counts.begin(),
+                                                            row_counts.end());
+    row_counts = decltype(row_counts)();
+    std::sort(queried_rows.begin(), queried_rows.end(),
+              [](const auto &a, const auto &b) {
+                  return a.second > b.second || (a.second == b.second && a.first < b.first);
+              });
+
+    uint64_t num_queried_kmers = 0;
+    for (const auto &[row, count] : queried_rows) {
+        num_queried_kmers += count;
+    }
+    logger->trace("Mapped {} queried k-mers to {} distinct rows in {} sec",
+                  num_queried_kmers, queried_rows.size(), timer.elapsed());
+
+    // every row-diff path ends in an anchor, so compute the full path lengths
+    const uint32_t kMaxDepth = std::numeric_limits<uint32_t>::max();
+
+    auto report_depths = [&](const char *stage) {
+        uint64_t total_depth = 0;
+        uint32_t max_row_depth = 0;
+        uint64_t num_bounded = 0;
+
+        #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1024) \
+                                 reduction(+:total_depth,num_bounded) reduction(max:max_row_depth)
+        for (size_t i = 0; i < queried_rows.size(); ++i) {
+            const auto &[row, count] = queried_rows[i];
+            uint32_t depth = get_row_diff_depth(graph, anchors, row, kMaxDepth);
+            total_depth += depth * count;
+            max_row_depth = std::max(max_row_depth, depth);
+            if (depth <= max_depth)
+                num_bounded += count;
+        }
+
+        logger->trace("{}: average row-diff path length per queried k-mer: {:.3f},"
+                      " max: {}, k-mers within {} steps: {:.2f}%",
+                      stage, num_queried_kmers ? (double)total_depth / num_queried_kmers : 0.,
+                      max_row_depth, max_depth,
+                      num_queried_kmers ? 100. * num_bounded / num_queried_kmers : 100.);
+    };
+
+    report_depths("Before");
+
+    const uint64_t max_num_new_anchors = max_extra_anchors * anchors.size();
+    uint64_t num_new_anchors = 0;
+
+    for (const auto &[row, count] : queried_rows) {
+        if (num_new_anchors == max_num_new_anchors)
+            break;
+
+        uint64_t last_row;
+        if (get_row_diff_depth(graph, anchors, row, max_depth, &last_row) == max_depth
+                && !anchors[last_row]) {
+            // cut the path at depth |max_depth|, all rows upstream benefit too
+            anchors[last_row] = true;
+            num_new_anchors++;
+        }
+    }
+
+    report_depths("After");
+
+    logger->trace("Added {} anchors for queried rows (budget: {}), number of anchors"
+                  " increased from {} to {} ({:.2f}% of rows are stored in full)",
+                  num_new_anchors, max_num_new_anchors, num_anchors_old,
+                  num_anchors_old + num_new_anchors,
+                  100. * (num_anchors_old + num_new_anchors) / std::max(anchors.size(), size_t(1)));
+
+    anchor_bv_type ranchors(std::move(anchors));
+    std::ofstream f(anchors_fname, ios::binary);
+    ranchors.serialize(f);
+    logger->trace("Serialized optimized anchors to {}", anchors_fname);
+}
+
 } // namespace annot
 } // namespace mtg
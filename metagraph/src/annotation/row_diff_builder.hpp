@@ -29,5 +29,20 @@ void optimize_anchors_in_row_diff(const std::string &graph_fname,
                                   const std::filesystem::path &dest_dir,
                                   const std::string &row_reduction_extension);
 
+/**
+ * Add anchors to bound the row-diff path lengths of the rows queried
+ * frequently, as sampled from the sequences in |query_files| (e.g., a query
+ * log or sample reads). The rows are processed from the most frequent and
+ * the paths longer than |max_depth| are cut with a new anchor, until
+ * |max_extra_anchors| * num_rows anchors are added.
+ * The anchors in |anchors_fname| are updated in place, hence, this must be
+ * called before any row-diff annotation is computed with them.
+ */
+void optimize_anchors_for_queries(const std::string &graph_fname,
+                                  const std::string &anchors_fname,
+                                  const std::vector<std::string> &query_files,
+                                  uint32_t max_depth,
+                                  double max_extra_anchors);
+
 } // namespace annot
 } // namespace mtg
@@ -5,6 +5,7 @@
 #include "common/threads/threading.hpp"
 #include "graph/representation/succinct/dbg_succinct.hpp"
 #include "graph/representation/canonical_dbg.hpp"
+#include "graph/graph_extensions/minimizer_index.hpp"
 #include "graph/alignment/dbg_aligner.hpp"
 #include "graph/alignment/aligner_methods.hpp"
 #include "seq_io/sequence_io.hpp"
@@ -34,6 +35,7 @@ DBGAlignerConfig initialize_aligner_config(size_t k, const Config &config) {
     aligner_config.min_seed_length = config.alignment_min_seed_length;
     aligner_config.max_seed_length = config.alignment_max_seed_length;
     aligner_config.max_num_seeds_per_locus = config.alignment_max_num_seeds_per_locus;
+    aligner_config.max_num_seed_chains = config.alignment_max_num_seed_chains;
     aligner_config.max_nodes_per_seq_char = config.alignment_max_nodes_per_seq_char;
     aligner_config.max_ram_per_alignment = config.alignment_max_ram;
     aligner_config.min_cell_score = config.alignment_min_cell_score;
@@ -43,6 +45,7 @@ DBGAlignerConfig initialize_aligner_config(size_t k, const Config &config) {
     aligner_config.gap_opening_penalty = -config.alignment_gap_opening_penalty;
     aligner_config.gap_extension_penalty = -config.alignment_gap_extension_penalty;
     aligner_config.forward_and_reverse_complement = config.align_both_strands;
+    aligner_config.wavefront_extension = config.alignment_wavefront;
     aligner_config.alignment_edit_distance = config.alignment_edit_distance;
     aligner_config.alignment_match_score = config.alignment_match_score;
     aligner_config.alignment_mm_transition_score = config.alignment_mm_transition_score;
@@ -60,6 +63,7 @@ DBGAlignerConfig initialize_aligner_config(size_t k, const Config &config) {
     logger->trace("\t Min seed length: {}", aligner_config.min_seed_length);
     logger->trace("\t Max seed length: {}", aligner_config.max_seed_length);
     logger->trace("\t Max num seeds per locus: {}", aligner_config.max_num_seeds_per_locus);
+    logger->trace("\t Max num seed chains: {}", aligner_config.max_num_seed_chains);
     logger->trace("\t Max num nodes per sequence char: {}", aligner_config.max_nodes_per_seq_char);
     logger->trace("\t Max RAM per alignment: {}", aligner_config.max_ram_per_alignment);
     logger->trace("\t Gap opening penalty: {}", int64_t(aligner_config.gap_opening_penalty));
@@ -69,6 +73,7 @@ DBGAlignerConfig initialize_aligner_config(size_t k, const Config &config) {
     logger->trace("\t Bandwidth: {}", aligner_config.bandwidth);
     logger->trace("\t X drop-off: {}", aligner_config.xdrop);
     logger->trace("\t Exact nucleotide match threshold: {}", aligner_config.min_exact_match);
+    logger->trace("\t Extension: {}", aligner_config.wavefront_extension ? "wavefront" : "DP");
 
     logger->trace("\t Scoring matrix: {}", config.alignment_edit_distance ? "unit costs" : "matrix");
     if (!config.alignment_edit_distance) {
@@ -90,6 +95,15 @@ std::unique_ptr<IDBGAligner> build_aligner(const DeBruijnGraph &graph, const Con
     return build_aligner(graph, initialize_aligner_config(graph.get_k(), config));
 }
 
+template <class Seeder>
+std::unique_ptr<IDBGAligner> make_aligner(const DeBruijnGraph &graph,
+                                          const DBGAlignerConfig &aligner_config) {
+    if (aligner_config.wavefront_extension)
+        return std::make_unique<DBGAligner<Seeder, WavefrontExtender<>>>(graph, aligner_config);
+
+    return std::make_unique<DBGAligner<Seeder>>(graph, aligner_config);
+}
+
 std::unique_ptr<IDBGAligner> build_aligner(const DeBruijnGraph &graph,
                                            const DBGAlignerConfig &aligner_config) {
     assert(aligner_config.min_seed_length <= aligner_config.max_seed_length);
@@ -105,24 +119,25 @@ std::unique_ptr<IDBGAligner> build_aligner(const DeBruijnGraph &graph,
 
         // Use the seeder that seeds to node suffixes
         if (aligner_config.max_seed_length == k) {
-            return std::make_unique<DBGAligner<SuffixSeeder<ExactSeeder<>>>>(
-                graph, aligner_config
-            );
+            return make_aligner<SuffixSeeder<ExactSeeder<>>>(graph, aligner_config);
         } else {
-            return std::make_unique<DBGAligner<SuffixSeeder<UniMEMSeeder<>>>>(
-                graph, aligner_config
-            );
+            return make_aligner<SuffixSeeder<UniMEMSeeder<>>>(graph, aligner_config);
         }
 
     } else if (aligner_config.max_seed_length == k) {
         assert(aligner_config.min_seed_length == k);
 
         // seeds are single k-mers
-        return std::make_unique<DBGAligner<>>(graph, aligner_config);
+        if (graph.get_extension<MinimizerIndex>()) {
+            // look up only the k-mers sampled by the minimizer index
+            return make_aligner<MinimizerSeeder<>>(graph, aligner_config);
+        }
+
+        return make_aligner<ExactSeeder<>>(graph, aligner_config);
 
     } else {
         // seeds are maximal matches within unitigs (uni-MEMs)
-        return std::make_unique<DBGAligner<UniMEMSeeder<>>>(graph, aligner_config);
+        return make_aligner<UniMEMSeeder<>>(graph, aligner_config);
     }
 }
 
@@ -296,9 +311,11 @@ void gfa_map_files(const Config *config,
     logger->trace("Starting GFA mapping:");
 
     tsl::ordered_set<uint64_t> is_unitig_end_node;
+    std::mutex unitig_end_mutex;
 
     graph->call_unitigs(
         [&](const auto &, const auto &path) {
+            std::lock_guard<std::mutex> lock(unitig_end_mutex);
             is_unitig_end_node.insert(path.back());
         },
         get_num_threads()
@@ -440,6 +457,28 @@ int align_to_graph(Config *config) {
         exit(1);
     }
 
+    if (config->alignment_minimizer_seeds) {
+        if (config->canonical && !graph->is_canonical_mode()) {
+            logger->error("Minimizer seeds not supported with --canonical flag");
+            exit(1);
+        }
+
+        if (aligner_config.min_seed_length != graph->get_k()
+                || aligner_config.max_seed_length != graph->get_k()) {
+            logger->error("Minimizer seeds must have length k");
+            exit(1);
+        }
+
+        auto minimizer_index = graph->load_extension<MinimizerIndex>(config->infbase);
+        if (!minimizer_index || !minimizer_index->is_compatible(*graph)) {
+            logger->error("Cannot load a minimizer index for graph {}", config->infbase);
+            exit(1);
+        }
+
+        logger->trace("Loaded minimizer index with {} sampled k-mers",
+                      minimizer_index->num_sampled_kmers());
+    }
+
     for (const auto &file : files) {
         logger->trace("Align sequences from file '{}'", file);
         seq_io::FastaParser fasta_parser(file, config->forward_and_reverse);
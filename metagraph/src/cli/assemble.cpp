@@ -181,7 +181,8 @@ int assemble(Config *config) {
 
     seq_io::FastaWriter writer(config->outfbase, config->header,
                                config->enumerate_out_sequences,
-                               get_num_threads() > 1);
+                               get_num_threads() > 1, "w",
+                               config->compression_level);
     std::mutex write_mutex;
 
     if (config->unitigs || config->min_tip_size > 1) {
@@ -55,6 +55,46 @@ void push_sequences(const std::vector<std::string> &files,
     }
 }
 
+// Read the input files once, extract the k-mers of all |suffixes| into
+// a single container, and serialize the chunks to OUTFBASE.<suffix>, which
+// are the same files as built with --suffix.
+void build_boss_chunks_single_pass(const Config &config,
+                                   size_t boss_k,
+                                   const std::vector<std::string> &suffixes) {
+    Timer timer;
+
+    auto constructor = boss::IBOSSMultiChunkConstructor::initialize(
+        boss_k,
+        config.canonical,
+        config.count_width,
+        suffixes,
+        get_num_threads(),
+        config.memory_available * kBytesInGigabyte,
+        config.tmp_dir.empty() ? kmer::ContainerType::VECTOR
+                               : kmer::ContainerType::VECTOR_DISK,
+        config.tmp_dir.empty() ? std::filesystem::path(config.outfbase).remove_filename()
+                               : config.tmp_dir,
+        config.disk_cap_bytes
+    );
+
+    logger->trace("Extracting k-mers for {} suffixes in a single pass", suffixes.size());
+
+    push_sequences(config.fnames, config, timer, constructor.get());
+
+    logger->trace("Extracted k-mers for all suffixes in {} sec", timer.elapsed());
+    timer.reset();
+
+    constructor->call_chunks([&](size_t i, boss::BOSS::Chunk&& chunk) {
+        logger->trace("Graph chunk for suffix '{}' with {} k-mers was built in {} sec",
+                      suffixes[i], chunk.size() - 1, timer.elapsed());
+        chunk.serialize(config.outfbase + "." + suffixes[i]);
+        timer.reset();
+    });
+
+    logger->info("Serialized {} graph chunks to '{}.<suffix>'", suffixes.size(),
+                 config.outfbase);
+}
+
 int build_graph(Config *config) {
     assert(config);
 
@@ -74,6 +114,20 @@ int build_graph(Config *config) {
     if (config->canonical)
         config->forward_and_reverse = false;
 
+    if (config->single_pass
+            && (config->graph_type != Config::GraphType::SUCCINCT || config->dynamic
+                    || !config->suffix_len || config->suffix.size())) {
+        logger->error("Single pass construction is only supported for Succinct graphs"
+                      " built from chunks with --len-suffix");
+        exit(1);
+    }
+
+    if (config->num_superkmer_bins && (config->suffix_len || config->suffix.size())) {
+        logger->error("Super-k-mer bins can't be combined with k-mer suffixes,"
+                      " the input is read only once in this mode");
+        exit(1);
+    }
+
     if (config->complete) {
         if (config->graph_type != Config::GraphType::BITMAP) {
             logger->error("Only bitmap-graph can be built in complete mode");
@@ -95,6 +149,11 @@ int build_graph(Config *config) {
             suffixes = kmer::KmerExtractorBOSS::generate_suffixes(config->suffix_len);
         }
 
+        if (config->single_pass) {
+            build_boss_chunks_single_pass(*config, boss_graph->get_k(), suffixes);
+            return 0;
+        }
+
         boss::BOSS::Chunk graph_data;
 
         //one pass per suffix
@@ -116,7 +175,8 @@ int build_graph(Config *config) {
                                         : kmer::ContainerType::VECTOR_DISK,
                 config->tmp_dir.empty() ? std::filesystem::path(config->outfbase).remove_filename()
                                         : config->tmp_dir,
-                config->disk_cap_bytes
+                config->disk_cap_bytes,
+                config->num_superkmer_bins
             );
 
             push_sequences(files, *config, timer, constructor.get());
@@ -182,7 +242,10 @@ int build_graph(Config *config) {
                     config->count_width,
                     suffix,
                     get_num_threads(),
-                    config->memory_available * kBytesInGigabyte
+                    config->memory_available * kBytesInGigabyte,
+                    config->tmp_dir.empty() ? std::filesystem::path(config->outfbase).remove_filename()
+                                            : config->tmp_dir,
+                    config->num_superkmer_bins
                 )
             );
 
@@ -161,7 +161,8 @@ int clean_graph(Config *config) {
                                                  graph->get_k(),
                                                  config->header,
                                                  config->enumerate_out_sequences,
-                                                 get_num_threads() > 1);
+                                                 get_num_threads() > 1, "w",
+                                                 config->compression_level);
             call_contigs([&](const std::string &contig, const auto &path) {
                 std::vector<uint32_t> kmer_counts;
                 kmer_counts.reserve(path.size());
@@ -176,7 +177,8 @@ int clean_graph(Config *config) {
         } else {
             FastaWriter writer(outfbase, config->header,
                                config->enumerate_out_sequences,
-                               get_num_threads() > 1);
+                               get_num_threads() > 1, "w",
+                               config->compression_level);
 
             call_contigs([&](const std::string &contig, const auto &) {
                 std::lock_guard<std::mutex> lock(seq_mutex);
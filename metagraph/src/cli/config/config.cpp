@@ -60,6 +60,8 @@ Config::Config(int argc, char *argv[]) {
         identity = QUERY;
     } else if (!strcmp(argv[1], "server_query")) {
         identity = SERVER_QUERY;
+    } else if (!strcmp(argv[1], "server_router")) {
+        identity = SERVER_ROUTER;
     } else if (!strcmp(argv[1], "transform")) {
         identity = TRANSFORM;
     } else if (!strcmp(argv[1], "transform_anno")) {
@@ -103,6 +105,8 @@ Config::Config(int argc, char *argv[]) {
     for (int i = 2; i < argc; ++i) {
         if (!strcmp(argv[i], "-v") || !strcmp(argv[i], "--verbose")) {
             common::set_verbose(true);
+        } else if (!strcmp(argv[i], "--dump-metrics")) {
+            metrics_file = std::string(get_value(i++));
         } else if (!strcmp(argv[i], "--print")) {
             print_graph = true;
         } else if (!strcmp(argv[i], "--print-col-names")) {
@@ -121,6 +125,8 @@ Config::Config(int argc, char *argv[]) {
             complete = true;
         } else if (!strcmp(argv[i], "--dynamic")) {
             dynamic = true;
+        } else if (!strcmp(argv[i], "--single-pass")) {
+            single_pass = true;
         } else if (!strcmp(argv[i], "--mask-dummy")) {
             mark_dummy_kmers = true;
         } else if (!strcmp(argv[i], "--anno-filename")) {
@@ -141,14 +147,24 @@ Config::Config(int argc, char *argv[]) {
             num_columns_cached = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "--fast")) {
             fast = true;
+        } else if (!strcmp(argv[i], "--numa")) {
+            numa = true;
         } else if (!strcmp(argv[i], "--batch-size")) {
             query_batch_size_in_bytes = atoll(get_value(i++));
         } else if (!strcmp(argv[i], "-p") || !strcmp(argv[i], "--parallel")) {
             set_num_threads(atoi(get_value(i++)));
         } else if (!strcmp(argv[i], "--parallel-nodes")) {
             parallel_nodes = atoi(get_value(i++));
+        } else if (!strcmp(argv[i], "--row-shards")) {
+            num_row_shards = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "--max-path-length")) {
             max_path_length = atoi(get_value(i++));
+        } else if (!strcmp(argv[i], "--anchors-for-queries")) {
+            row_diff_query_files.push_back(get_value(i++));
+        } else if (!strcmp(argv[i], "--max-query-path-length")) {
+            max_query_path_length = atoi(get_value(i++));
+        } else if (!strcmp(argv[i], "--max-extra-anchors")) {
+            max_extra_anchors = std::stod(get_value(i++));
         } else if (!strcmp(argv[i], "--parts-total")) {
             parts_total = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "--part-idx")) {
@@ -195,6 +211,8 @@ Config::Config(int argc, char *argv[]) {
             max_hull_depth = atoll(get_value(i++));
         } else if (!strcmp(argv[i], "--batch-align")) {
             batch_align = true;
+        } else if (!strcmp(argv[i], "--align-label")) {
+            alignment_labels.emplace_back(get_value(i++));
         } else if (!strcmp(argv[i], "--align-length")) {
             alignment_length = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "--align-queue-size")) {
@@ -225,6 +243,12 @@ Config::Config(int argc, char *argv[]) {
             alignment_max_seed_length = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "--align-max-num-seeds-per-locus")) {
             alignment_max_num_seeds_per_locus = atoi(get_value(i++));
+        } else if (!strcmp(argv[i], "--align-max-num-seed-chains")) {
+            alignment_max_num_seed_chains = atoi(get_value(i++));
+        } else if (!strcmp(argv[i], "--align-minimizer-seeds")) {
+            alignment_minimizer_seeds = true;
+        } else if (!strcmp(argv[i], "--align-wavefront")) {
+            alignment_wavefront = true;
         } else if (!strcmp(argv[i], "--align-max-nodes-per-seq-char")) {
             alignment_max_nodes_per_seq_char = std::stof(get_value(i++));
         } else if (!strcmp(argv[i], "--align-min-exact-match")) {
@@ -255,6 +279,8 @@ Config::Config(int argc, char *argv[]) {
             port = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "--address")) {
             host_address = get_value(i++);
+        } else if (!strcmp(argv[i], "--backend-timeout")) {
+            backend_timeout = atoi(get_value(i++));
         }else if (!strcmp(argv[i], "--suffix")) {
             suffix = get_value(i++);
         } else if (!strcmp(argv[i], "--initialize-bloom")) {
@@ -295,6 +321,8 @@ Config::Config(int argc, char *argv[]) {
             unitigs = true;
         } else if (!strcmp(argv[i], "--primary-kmers")) {
             kmers_in_single_form = true;
+        } else if (!strcmp(argv[i], "--compression-level")) {
+            compression_level = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "--header")) {
             header = std::string(get_value(i++));
         } else if (!strcmp(argv[i], "--prune-tips")) {
@@ -311,6 +339,8 @@ Config::Config(int argc, char *argv[]) {
             clear_dummy = true;
         } else if (!strcmp(argv[i], "--index-ranges")) {
             node_suffix_length = atoi(get_value(i++));
+        } else if (!strcmp(argv[i], "--index-minimizers")) {
+            minimizer_length = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "--no-postprocessing")) {
             clear_dummy = false;
         } else if (!strcmp(argv[i], "-l") || !strcmp(argv[i], "--len-suffix")) {
@@ -331,8 +361,8 @@ Config::Config(int argc, char *argv[]) {
             arity_brwt = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "--relax-arity")) {
             relax_arity_brwt = atoi(get_value(i++));
-        // } else if (!strcmp(argv[i], "--cache-size")) {
-        //     row_cache_size = atoi(get_value(i++));
+        } else if (!strcmp(argv[i], "--cache-size")) {
+            row_cache_size = atoll(get_value(i++));
         } else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
             print_welcome_message();
             print_usage(argv[0], identity);
@@ -353,6 +383,8 @@ Config::Config(int argc, char *argv[]) {
             tmp_dir = get_value(i++);
         } else if (!strcmp(argv[i], "--disk-cap-gb")) {
             disk_cap_bytes = atoi(get_value(i++)) * 1e9;
+        } else if (!strcmp(argv[i], "--superkmer-bins")) {
+            num_superkmer_bins = atoi(get_value(i++));
         } else if (!strcmp(argv[i], "--anchors-file")) {
             anchors = get_value(i++);
         } else if (argv[i][0] == '-') {
@@ -382,6 +414,7 @@ Config::Config(int argc, char *argv[]) {
 
     if (!fnames.size() && identity != STATS
                       && identity != SERVER_QUERY
+                      && identity != SERVER_ROUTER
                       && !(identity == BUILD && complete)
                       && !(identity == CONCATENATE && !infbase.empty())) {
         std::string line;
@@ -404,6 +437,11 @@ Config::Config(int argc, char *argv[]) {
     if (!count_kmers)
         count_width = 0;
 
+    if (compression_level < 0 || compression_level > 9) {
+        std::cerr << "Error: compression level must be in range [0, 9]" << std::endl;
+        print_usage_and_exit = true;
+    }
+
     if (count_width > 32) {
         std::cerr << "Error: bad value for count-width, can use maximum 32 bits"
                      " to represent k-mer abundance" << std::endl;
@@ -468,6 +506,10 @@ Config::Config(int argc, char *argv[]) {
                           && alignment_num_alternative_paths != 1)
         print_usage_and_exit = true;
 
+    // label-constrained alignment is done against the full graph
+    if (alignment_labels.size() && (identity != QUERY || !align_sequences || batch_align))
+        print_usage_and_exit = true;
+
     if (identity == ALIGN && infbase.empty())
         print_usage_and_exit = true;
 
@@ -521,7 +563,7 @@ Config::Config(int argc, char *argv[]) {
     if (identity == EXTEND && infbase.empty())
         print_usage_and_exit = true;
 
-    if ((identity == QUERY || identity == SERVER_QUERY) && infbase_annotators.size() != 1)
+    if ((identity == QUERY || identity == SERVER_QUERY) && infbase_annotators.empty())
         print_usage_and_exit = true;
 
     if ((identity == TRANSFORM
@@ -609,6 +651,10 @@ std::string Config::state_to_string(BOSS::State state) {
             return "small";
         case BOSS::State::FAST:
             return "fast";
+        case BOSS::State::OCC:
+            return "occ";
+        case BOSS::State::INTERLEAVED:
+            return "interleaved";
         default:
             assert(false);
             return "Never happens";
@@ -624,6 +670,10 @@ BOSS::State Config::string_to_state(const std::string &string) {
         return BOSS::State::SMALL;
     } else if (string == "fast") {
         return BOSS::State::FAST;
+    } else if (string == "occ") {
+        return BOSS::State::OCC;
+    } else if (string == "interleaved") {
+        return BOSS::State::INTERLEAVED;
     } else {
         throw std::runtime_error("Error: unknown graph state");
     }
@@ -765,6 +815,7 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
 
             fprintf(stderr, "\tquery\t\tannotate sequences from fast[a|q] files\n\n");
             fprintf(stderr, "\tserver_query\tannotate received sequences and send annotations back\n\n");
+            fprintf(stderr, "\tserver_router\tforward received requests to several servers and merge their responses\n\n");
 
             return;
         }
@@ -796,11 +847,15 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
             fprintf(stderr, "\t   --dynamic \t\tuse dynamic build method [off]\n");
             fprintf(stderr, "\t-l --len-suffix [INT] \tk-mer suffix length for building graph from chunks [0]\n");
             fprintf(stderr, "\t   --suffix \t\tbuild graph chunk only for k-mers with the suffix given [off]\n");
+            fprintf(stderr, "\t   --single-pass \tread the input once and write the chunks for all suffixes of length\n");
+            fprintf(stderr, "\t                 \t--len-suffix to OUTFILE_BASE.<suffix> (only for Succinct graph) [off]\n");
             fprintf(stderr, "\t-o --outfile-base [STR]\tbasename of output file []\n");
             fprintf(stderr, "\t   --mask-dummy \tbuild mask for dummy k-mers (only for Succinct graph) [off]\n");
             fprintf(stderr, "\t-p --parallel [INT] \tuse multiple threads for computation [1]\n");
             fprintf(stderr, "\t   --disk-swap [STR] \tdirectory to use for temporary files [off]\n");
             fprintf(stderr, "\t   --disk-cap-gb [INT] \tmax temp disk space to use before forcing a merge, in GB [inf]\n");
+            fprintf(stderr, "\t   --superkmer-bins [INT] split reads into super-k-mers binned by minimizers on disk\n");
+            fprintf(stderr, "\t                      \tand collect k-mers from each bin independently (0: off) [0]\n");
         } break;
         case CLEAN: {
             fprintf(stderr, "Usage: %s clean -o <outfile-base> [options] GRAPH\n\n", prog_name.c_str());
@@ -823,6 +878,7 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
             fprintf(stderr, "\t   --unitigs \t\t\textract unitigs instead of contigs [off]\n");
             fprintf(stderr, "\t   --to-fasta \t\t\tdump clean sequences to compressed FASTA file [off]\n");
             fprintf(stderr, "\t   --enumerate \t\t\tenumerate sequences in FASTA [off]\n");
+            fprintf(stderr, "\t   --compression-level [INT] \tgzip compression level of the FASTA output (0-9) [6]\n");
             // fprintf(stderr, "\t-p --parallel [INT] \tuse multiple threads for computation [1]\n");
         } break;
         case EXTEND: {
@@ -877,6 +933,7 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
             fprintf(stderr, "\t   --align-vertical-bandwidth [INT]\t\tmaximum width of a window to consider in alignment step [inf]\n");
             fprintf(stderr, "\t   --align-max-nodes-per-seq-char [FLOAT]\t\tmaximum number of nodes to consider per sequence character [10.0]\n");
             fprintf(stderr, "\t   --align-max-ram [FLOAT]\t\tmaximum amount of RAM used per alignment in MB [200.0]\n");
+            fprintf(stderr, "\t   --align-wavefront \t\t\textend seeds with a wavefront search, faster for high-identity queries [off]\n");
             fprintf(stderr, "\n");
             fprintf(stderr, "Advanced options for scoring:\n");
             fprintf(stderr, "\t   --align-match-score [INT]\t\t\tpositive match score [2]\n");
@@ -892,6 +949,8 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
             fprintf(stderr, "\t   --align-max-seed-length [INT]\t\tthe maximum length of a seed [graph k]\n");
             fprintf(stderr, "\t   --align-min-exact-match [FLOAT] fraction of matching nucleotides required to align sequence [0.7]\n");
             fprintf(stderr, "\t   --align-max-num-seeds-per-locus [INT]\tthe maximum number of allowed inexact seeds per locus [inf]\n");
+            fprintf(stderr, "\t   --align-max-num-seed-chains [INT]\tchain colinear seeds and extend only the top chains (0: extend all seeds) [0]\n");
+            fprintf(stderr, "\t   --align-minimizer-seeds \t\tlook up only the query k-mers sampled by the minimizer index of the graph (see transform --index-minimizers) [off]\n");
         } break;
         case COMPARE: {
             fprintf(stderr, "Usage: %s compare [options] GRAPH1 GRAPH2\n\n", prog_name.c_str());
@@ -929,11 +988,13 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
             fprintf(stderr, "\t   --index-ranges [INT]\tindex all node ranges in BOSS for suffixes of given length [%zu]\n", kDefaultIndexSuffixLen);
             fprintf(stderr, "\t   --clear-dummy \terase all redundant dummy edges and build an edgemask for non-redundant [off]\n");
             fprintf(stderr, "\t   --prune-tips [INT] \tprune all dead ends of this length and shorter [0]\n");
-            fprintf(stderr, "\t   --state [STR] \tchange state of succinct graph: small / dynamic / fast [stat]\n");
+            fprintf(stderr, "\t   --state [STR] \tchange state of succinct graph: small / dynamic / fast / occ / interleaved [stat]\n");
             fprintf(stderr, "\t   --to-adj-list \twrite adjacency list to file [off]\n");
             fprintf(stderr, "\t   --to-fasta \t\textract sequences from graph and dump to compressed FASTA file [off]\n");
             fprintf(stderr, "\t   --enumerate \t\tenumerate sequences in FASTA [off]\n");
+            fprintf(stderr, "\t   --compression-level [INT] gzip compression level of the FASTA output (0-9) [6]\n");
             fprintf(stderr, "\t   --initialize-bloom \tconstruct a Bloom filter for faster detection of non-existing k-mers [off]\n");
+            fprintf(stderr, "\t   --index-minimizers [INT] index the k-mers starting with their minimizer of given length for minimizer seeding [off]\n");
             fprintf(stderr, "\t   --unitigs \t\textract all unitigs from graph and dump to compressed FASTA file [off]\n");
 #if ! _PROTEIN_GRAPH
             fprintf(stderr, "\t   --primary-kmers \toutput each k-mer only in one if its forms (canonical/non-canonical) [off]\n");
@@ -956,6 +1017,7 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
             fprintf(stderr, "\t   --prune-tips [INT] \tprune all dead ends of this length and shorter [0]\n");
             fprintf(stderr, "\t   --unitigs \t\textract unitigs [off]\n");
             fprintf(stderr, "\t   --enumerate \t\tenumerate sequences assembled and dumped to FASTA [off]\n");
+            fprintf(stderr, "\t   --compression-level [INT] gzip compression level of the FASTA output (0-9) [6]\n");
 #if ! _PROTEIN_GRAPH
             fprintf(stderr, "\t   --primary-kmers \toutput each k-mer only in one if its forms (canonical/non-canonical) [off]\n");
 #endif
@@ -1036,6 +1098,7 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
             fprintf(stderr, "\t   --anno-type [STR] \ttarget annotation representation [column]\n");
             fprintf(stderr, "\t\t"); fprintf(stderr, annotation_list); fprintf(stderr, "\n");
             // fprintf(stderr, "\t   --sparse \t\tuse the row-major sparse matrix to annotate graph [off]\n");
+            fprintf(stderr, "\t   --mem-cap-gb [INT] \tmemory for merging columns, in GB (column only) [1]\n");
             fprintf(stderr, "\t-p --parallel [INT] \tuse multiple threads for computation [1]\n");
         } break;
         case TRANSFORM_ANNOTATION: {
@@ -1059,12 +1122,18 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
             fprintf(stderr, "\t   --subsample [INT] \tnumber of rows subsampled for distance estimation in column clustering [1000000]\n");
             fprintf(stderr, "\t   --fast \t\ttransform annotation in memory without streaming [off]\n");
             fprintf(stderr, "\t   --dump-text-anno \tdump the columns of the annotator as separate text files [off]\n");
+            fprintf(stderr, "\t   --row-shards [INT] \tsplit the annotation into shards by ranges of rows (column only) [off]\n");
+            fprintf(stderr, "\t                       \tthe shards are aligned to the BOSS nodes of the graph passed with -i\n");
             fprintf(stderr, "\t   --disk-swap [STR] \tdirectory for temporary files [OUT_BASEDIR]\n");
             fprintf(stderr, "\t-p --parallel [INT] \tuse multiple threads for computation [1]\n");
             fprintf(stderr, "\n");
             fprintf(stderr, "\t   --parallel-nodes [INT] \tnumber of nodes processed in parallel in brwt tree [n_threads]\n");
             fprintf(stderr, "\t   --max-path-length [INT] \tmaximum path length in row_diff annotation [50]\n");
             fprintf(stderr, "\t   --optimize \t\t\toptimize anchors in row_diff annotation [off]\n");
+            fprintf(stderr, "\t   --anchors-for-queries [STR] \tsample queries (e.g., a query log) to add row_diff anchors for\n"
+                            "\t                       \t\t(can be passed multiple times, used only when the anchors are created) []\n");
+            fprintf(stderr, "\t   --max-query-path-length [INT] \tmaximum row_diff path length for the rows queried frequently [5]\n");
+            fprintf(stderr, "\t   --max-extra-anchors [FLOAT] \tmaximum fraction of rows added as anchors for the queries [0.01]\n");
         } break;
         case RELAX_BRWT: {
             fprintf(stderr, "Usage: %s relax_brwt -o <annotation-basename> [options] ANNOTATOR\n\n", prog_name.c_str());
@@ -1075,7 +1144,8 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
         } break;
         case QUERY: {
             fprintf(stderr, "Usage: %s query -i <GRAPH> -a <ANNOTATION> [options] FILE1 [[FILE2] ...]\n"
-                            "\tEach input file is given in FASTA or FASTQ format.\n\n", prog_name.c_str());
+                            "\tEach input file is given in FASTA or FASTQ format.\n"
+                            "\tPass -a multiple times to query an annotation split into row shards.\n\n", prog_name.c_str());
 
             fprintf(stderr, "Available options for query:\n");
 #if ! _PROTEIN_GRAPH
@@ -1093,9 +1163,10 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
             // fprintf(stderr, "\t-d --distance [INT] \tmax allowed alignment distance [0]\n");
             fprintf(stderr, "\n");
             fprintf(stderr, "\t-p --parallel [INT] \tuse multiple threads for computation [1]\n");
-            // fprintf(stderr, "\t   --cache-size [INT] \tnumber of uncompressed rows to store in the cache [0]\n");
+            fprintf(stderr, "\t   --cache-size [INT] \tnumber of decoded annotation rows to store in the cache [0]\n");
             fprintf(stderr, "\t   --fast \t\tquery in batches [off]\n");
             fprintf(stderr, "\t   --batch-size \tquery batch size (number of base pairs) [100000000]\n");
+            fprintf(stderr, "\t   --numa \t\tinterleave the index across NUMA nodes and pin worker threads to them [off]\n");
             fprintf(stderr, "\n");
             fprintf(stderr, "Available options for --align:\n");
             fprintf(stderr, "\t   --align-both-strands \t\t\treturn best alignments for either input sequence or its reverse complement [off]\n");
@@ -1106,6 +1177,8 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
             fprintf(stderr, "\t   --align-vertical-bandwidth [INT]\t\tmaximum width of a window to consider in alignment step [inf]\n");
             fprintf(stderr, "\t   --align-max-nodes-per-seq-char [FLOAT]\tmaximum number of nodes to consider per sequence character [10.0]\n");
             fprintf(stderr, "\t   --align-max-ram [FLOAT]\t\tmaximum amount of RAM used per alignment in MB [200.0]\n");
+            fprintf(stderr, "\t   --align-wavefront \t\t\textend seeds with a wavefront search, faster for high-identity queries [off]\n");
+            fprintf(stderr, "\t   --align-label [STR] \t\t\talign only to nodes annotated with this label, can be passed multiple times []\n");
             fprintf(stderr, "\n");
             fprintf(stderr, "\t   --batch-align \t\talign against query graph [off]\n");
             fprintf(stderr, "\t   --max-hull-forks [INT]\tmaximum number of forks to take when expanding query graph [4]\n");
@@ -1125,9 +1198,11 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
             fprintf(stderr, "\t   --align-max-seed-length [INT]\t\tthe maximum length of a seed [graph k]\n");
             fprintf(stderr, "\t   --align-min-exact-match [FLOAT] fraction of matching nucleotides required to align sequence [0.7]\n");
             fprintf(stderr, "\t   --align-max-num-seeds-per-locus [INT]\tthe maximum number of allowed inexact seeds per locus [inf]\n");
+            fprintf(stderr, "\t   --align-max-num-seed-chains [INT]\tchain colinear seeds and extend only the top chains (0: extend all seeds) [0]\n");
         } break;
         case SERVER_QUERY: {
-            fprintf(stderr, "Usage: %s server_query -i <GRAPH> -a <ANNOTATION> [options]\n\n", prog_name.c_str());
+            fprintf(stderr, "Usage: %s server_query -i <GRAPH> -a <ANNOTATION> [options]\n"
+                            "\tPass -a multiple times to query an annotation split into row shards.\n\n", prog_name.c_str());
 
             fprintf(stderr, "Available options for server_query:\n");
             fprintf(stderr, "\t   --port [INT] \tTCP port for incoming connections [5555]\n");
@@ -1136,12 +1211,24 @@ void Config::print_usage(const std::string &prog_name, IdentityType identity) {
             // fprintf(stderr, "\t-o --outfile-base [STR] \tbasename of output file []\n");
             // fprintf(stderr, "\t-d --distance [INT] \tmax allowed alignment distance [0]\n");
             fprintf(stderr, "\t-p --parallel [INT] \tmaximum number of parallel connections [1]\n");
-            // fprintf(stderr, "\t   --cache-size [INT] \tnumber of uncompressed rows to store in the cache [0]\n");
+            fprintf(stderr, "\t   --numa \t\tinterleave the index across NUMA nodes and pin worker threads to them [off]\n");
+            fprintf(stderr, "\t   --cache-size [INT] \tnumber of decoded annotation rows to store in the cache [0]\n");
+        } break;
+        case SERVER_ROUTER: {
+            fprintf(stderr, "Usage: %s server_router [options] <HOST:PORT> [[HOST:PORT] ...]\n"
+                            "\tEach backend is a server_query instance serving a shard of the index.\n\n", prog_name.c_str());
+
+            fprintf(stderr, "Available options for server_router:\n");
+            fprintf(stderr, "\t   --port [INT] \tTCP port for incoming connections [5555]\n");
+            fprintf(stderr, "\t   --address \t\tinterface for incoming connections (default: all)\n");
+            fprintf(stderr, "\t   --backend-timeout [INT] \ttimeout for requests to each backend, in seconds [30]\n");
+            fprintf(stderr, "\t-p --parallel [INT] \tmaximum number of parallel connections [1]\n");
         } break;
     }
 
     fprintf(stderr, "\n\tGeneral options:\n");
     fprintf(stderr, "\t-v --verbose \t\tswitch on verbose output [off]\n");
+    fprintf(stderr, "\t   --dump-metrics [STR] \tdump performance counters at exit ('-' for stderr) []\n");
     fprintf(stderr, "\t-h --help \t\tprint usage info\n");
     fprintf(stderr, "\n");
 }
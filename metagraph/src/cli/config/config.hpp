@@ -25,6 +25,7 @@ class Config {
     bool canonical = false;
     bool complete = false;
     bool dynamic = false;
+    bool single_pass = false;
     bool mark_dummy_kmers = false;
     bool filename_anno = false;
     bool annotate_sequence_headers = false;
@@ -43,6 +44,7 @@ class Config {
     bool dump_text_anno = false;
     bool sparse = false;
     bool fast = false;
+    bool numa = false;
     bool batch_align = false;
     bool count_labels = false;
     bool suppress_unlabeled = false;
@@ -54,6 +56,8 @@ class Config {
     bool separately = false;
     bool files_sequentially = false;
     bool map_sequences = false;
+    bool alignment_minimizer_seeds = false;
+    bool alignment_wavefront = false;
     bool align_sequences = false;
     bool align_both_strands = false;
     bool filter_by_kmer = false;
@@ -69,12 +73,14 @@ class Config {
     unsigned int node_suffix_length = kDefaultIndexSuffixLen;
     unsigned int distance = 0;
     unsigned int parallel_nodes = -1;  // if not set, redefined by |parallel|
+    unsigned int num_row_shards = 0;
     unsigned int num_bins_per_thread = 1;
     unsigned int parts_total = 1;
     unsigned int part_idx = 0;
     unsigned int suffix_len = 0;
     unsigned int frequency = 1;
     unsigned int alignment_length = 0;
+    unsigned int minimizer_length = 0;
     unsigned int memory_available = 1;
     unsigned int min_count = 1;
     unsigned int max_count = std::numeric_limits<unsigned int>::max();
@@ -85,9 +91,12 @@ class Config {
     unsigned int min_tip_size = 1;
     unsigned int min_unitig_median_kmer_abundance = 1;
     int fallback_abundance_cutoff = 1;
+    int compression_level = 6;
     unsigned int port = 5555;
+    unsigned int backend_timeout = 30;
     unsigned int bloom_max_num_hash_functions = 10;
     unsigned int num_columns_cached = 10;
+    unsigned long long int row_cache_size = 0;
     unsigned int max_hull_forks = 4;
 
     unsigned long long int query_batch_size_in_bytes = 100'000'000;
@@ -116,6 +125,7 @@ class Config {
     size_t alignment_min_seed_length = 0;
     size_t alignment_max_seed_length = std::numeric_limits<size_t>::max();
     size_t alignment_max_num_seeds_per_locus = std::numeric_limits<size_t>::max();
+    size_t alignment_max_num_seed_chains = 0;
 
     double discovery_fraction = 0.7;
     double label_mask_in_fraction = 1.0;
@@ -135,9 +145,12 @@ class Config {
     std::vector<std::string> infbase_annotators;
     std::vector<std::string> label_mask_in;
     std::vector<std::string> label_mask_out;
+    std::vector<std::string> alignment_labels;
+    std::vector<std::string> row_diff_query_files;
     std::string outfbase;
     std::string infbase;
     std::string rename_instructions_file;
+    std::string metrics_file;
     std::string refpath;
     std::string suffix;
     std::string fasta_header_delimiter;
@@ -146,11 +159,14 @@ class Config {
     std::string header = "";
     std::string host_address;
     uint32_t max_path_length = 50;
+    uint32_t max_query_path_length = 5;
+    double max_extra_anchors = 0.01;
     std::string anchors;
 
     std::filesystem::path tmp_dir;
 
     size_t disk_cap_bytes = -1;
+    unsigned int num_superkmer_bins = 0;
 
     enum IdentityType {
         NO_IDENTITY = -1,
@@ -171,6 +187,7 @@ class Config {
         RELAX_BRWT,
         QUERY,
         SERVER_QUERY,
+        SERVER_ROUTER,
     };
     IdentityType identity = NO_IDENTITY;
 
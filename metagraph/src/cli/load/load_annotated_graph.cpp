@@ -4,9 +4,11 @@
 #include "annotation/binary_matrix/column_sparse/column_major.hpp"
 #include "annotation/binary_matrix/row_diff/row_diff.hpp"
 #include "annotation/binary_matrix/row_sparse/row_sparse.hpp"
+#include "annotation/representation/row_sharded/annotate_row_sharded.hpp"
 #include "graph/representation/canonical_dbg.hpp"
 #include "graph/annotated_dbg.hpp"
 #include "common/logger.hpp"
+#include "common/threads/threading.hpp"
 #include "cli/config/config.hpp"
 #include "load_graph.hpp"
 #include "load_annotation.hpp"
@@ -30,6 +32,47 @@ std::unique_ptr<AnnotatedDBG> initialize_annotated_dbg(std::shared_ptr<DeBruijnG
     if (const auto *canonical = dynamic_cast<const CanonicalDBG*>(graph.get()))
         max_index = canonical->get_graph().max_index();
 
+    if (config.infbase_annotators.size() > 1) {
+        // multiple annotators are row shards of the same annotation
+        std::vector<std::unique_ptr<annot::MultiLabelEncoded<std::string>>> shards;
+        for (const auto &file : config.infbase_annotators) {
+            const Config::AnnotationType input_anno_type = parse_annotation_type(file);
+            if (input_anno_type == Config::AnnotationType::RowDiff
+                || input_anno_type == Config::AnnotationType::RowDiffBRWT
+                || input_anno_type == Config::AnnotationType::RowDiffRowSparse) {
+                logger->error("Row-diff annotations can't be loaded as row shards");
+                exit(1);
+            }
+            shards.push_back(initialize_annotation(file, config, 0));
+            if (!shards.back()->load(file)) {
+                logger->error("Cannot load annotation shard {}, file corrupted", file);
+                exit(1);
+            }
+            logger->trace("Loaded annotation shard {} with {} rows",
+                          file, shards.back()->num_objects());
+        }
+
+        std::unique_ptr<annot::MultiLabelEncoded<std::string>> annotation;
+        try {
+            annotation = std::make_unique<annot::RowShardedAnnotator<>>(
+                std::move(shards), get_num_threads()
+            );
+        } catch (const std::exception &e) {
+            logger->error("Cannot combine annotation shards: {}", e.what());
+            exit(1);
+        }
+
+        auto anno_graph
+                = std::make_unique<AnnotatedDBG>(std::move(graph), std::move(annotation));
+
+        if (!anno_graph->check_compatibility()) {
+            logger->error("Graph and annotation shards are not compatible");
+            exit(1);
+        }
+
+        return anno_graph;
+    }
+
     auto annotation_temp = config.infbase_annotators.size()
             ? initialize_annotation(config.infbase_annotators.at(0), config, 0)
             : initialize_annotation(config.anno_type, config, max_index);
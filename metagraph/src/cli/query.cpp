@@ -1,16 +1,20 @@
 #include "query.hpp"
 
+#include <omp.h>
 #include <ips4o.hpp>
 #include <tsl/ordered_set.h>
 
 #include "common/logger.hpp"
 #include "common/unix_tools.hpp"
 #include "common/hashers/hash.hpp"
+#include "common/perf_counters.hpp"
 #include "common/utils/template_utils.hpp"
+#include "common/threads/numa.hpp"
 #include "common/threads/threading.hpp"
 #include "common/vectors/vector_algorithm.hpp"
 #include "annotation/representation/annotation_matrix/static_annotators_def.hpp"
 #include "graph/alignment/dbg_aligner.hpp"
+#include "graph/annotated_graph_algorithm.hpp"
 #include "graph/representation/hash/dbg_hash_ordered.hpp"
 #include "graph/representation/succinct/dbg_succinct.hpp"
 #include "graph/representation/succinct/boss_construct.hpp"
@@ -25,6 +29,8 @@ namespace mtg {
 namespace cli {
 
 const size_t kRowBatchSize = 100'000;
+// number of independent sets used for deduplicating the annotation rows
+const size_t kNumRowSetPartitions = 256;
 const bool kPrefilterWithBloom = true;
 const char ALIGNED_SEQ_HEADER_FORMAT[] = "{}:{}:{}:{}";
 
@@ -48,6 +54,35 @@ QueryExecutor::QueryExecutor(const Config &config,
         thread_pool_(thread_pool) {
     if (aligner_config_ && aligner_config_->forward_and_reverse_complement)
         throw std::runtime_error("Error: align_both_strands must be off when querying");
+
+    if (aligner_config_ && config_.alignment_labels.size()) {
+        auto graph = std::dynamic_pointer_cast<const DeBruijnGraph>(
+            anno_graph_.get_graph_ptr()
+        );
+        assert(graph);
+
+        // suffix seeds are looked up directly in the succinct graph
+        if (aligner_config_->min_seed_length < graph->get_k())
+            throw std::runtime_error("Error: seeds of length < k are not supported"
+                                     " in label-constrained alignment");
+
+        std::vector<std::string> labels;
+        for (const auto &label : config_.alignment_labels) {
+            if (anno_graph_.label_exists(label)) {
+                labels.push_back(label);
+            } else {
+                logger->warn("Label '{}' not found in the annotation", label);
+            }
+        }
+
+        // the labels are only checked for the nodes reached while aligning
+        align_graph_ = std::make_shared<MaskedDeBruijnGraph>(
+            graph,
+            mask_nodes_by_labels_cached(anno_graph_, labels),
+            false,
+            graph->is_canonical_mode()
+        );
+    }
 }
 
 std::string QueryExecutor::execute_query(const std::string &seq_name,
@@ -59,6 +94,13 @@ std::string QueryExecutor::execute_query(const std::string &seq_name,
                                          double discovery_fraction,
                                          std::string anno_labels_delimiter,
                                          const AnnotatedDBG &anno_graph) {
+    static auto &num_queries = common::get_counter("metagraph_queried_sequences_total",
+                                                   "Number of query sequences processed");
+    static auto &latency = common::get_histogram("metagraph_execute_query_seconds",
+                                                 "Time spent querying labels of a sequence");
+    num_queries.add();
+    common::ScopedLatency query_timer(latency);
+
     std::string output;
     output.reserve(1'000);
 
@@ -158,44 +200,52 @@ struct HullPathContext {
     size_t fork_count;
 };
 
-// Expand the query graph by traversing around its nodes which are forks in the
-// full graph.
-// |continue_traversal| is given a node and the distrance traversed so far and
-// returns whether traversal should continue.
+typedef std::function<bool(node_index last_node,
+                           size_t depth,
+                           size_t fork_count)> ContinueHullTraversal;
+
+// Schedule traversals from the outgoing nodes of |node| in the full graph,
+// whose k-mer is |kmer|. The paths not to be extended are passed to |callback|.
 template <class ContigCallback>
-void call_hull_sequences(const DeBruijnGraph &full_dbg,
+void schedule_hull_paths(const DeBruijnGraph &full_dbg,
+                         node_index node,
                          std::string kmer,
+                         size_t depth,
+                         size_t fork_count,
                          const ContigCallback &callback,
-                         const std::function<bool(std::string_view seq,
-                                                  node_index last_node,
-                                                  size_t depth,
-                                                  size_t fork_count)> &continue_traversal) {
-    // DFS from branching points
-    node_index node = full_dbg.kmer_to_node(kmer);
-    if (!node)
-        return;
-
-    kmer.erase(kmer.begin());
+                         const ContinueHullTraversal &continue_traversal,
+                         std::vector<HullPathContext> *paths_to_extend) {
+    kmer.erase(kmer.begin(), kmer.end() - full_dbg.get_k() + 1);
     kmer.push_back('$');
-    std::vector<HullPathContext> paths_to_extend;
     full_dbg.call_outgoing_kmers(node, [&](node_index next_node, char c) {
         if (c == '$')
             return;
 
         kmer.back() = c;
         assert(full_dbg.kmer_to_node(kmer) == next_node);
-        if (continue_traversal(kmer, next_node, 1, 0)) {
-            paths_to_extend.emplace_back(HullPathContext{
+        if (continue_traversal(next_node, depth, fork_count)) {
+            paths_to_extend->emplace_back(HullPathContext{
                 .last_kmer = kmer,
                 .last_node = next_node,
-                .depth = 1,
-                .fork_count = 0
+                .depth = depth,
+                .fork_count = fork_count
             });
         } else {
             callback(kmer, std::vector<node_index>{ next_node });
         }
     });
+}
 
+// Expand the query graph by traversing around its nodes which are forks in the
+// full graph, starting from the paths in |paths_to_extend|.
+// |continue_traversal| is given a node and the distrance traversed so far and
+// returns whether traversal should continue.
+template <class ContigCallback>
+void call_hull_sequences(const DeBruijnGraph &full_dbg,
+                         std::vector<HullPathContext>&& paths_to_extend,
+                         const ContigCallback &callback,
+                         const ContinueHullTraversal &continue_traversal) {
+    // DFS from branching points
     while (paths_to_extend.size()) {
         HullPathContext hull_path = std::move(paths_to_extend.back());
         paths_to_extend.pop_back();
@@ -217,7 +267,7 @@ void call_hull_sequences(const DeBruijnGraph &full_dbg,
                 seq.push_back(c);
             });
             depth++;
-            extend = continue_traversal(seq, path.back(), depth, fork_count);
+            extend = continue_traversal(path.back(), depth, fork_count);
         }
 
         assert(path.size() == seq.length() - full_dbg.get_k() + 1);
@@ -231,29 +281,10 @@ void call_hull_sequences(const DeBruijnGraph &full_dbg,
         // a fork or a sink has been reached before the path has reached max depth
         assert(!full_dbg.has_single_outgoing(path.back()));
 
-        node = path.back();
-        path.resize(0);
-        seq.erase(seq.begin(), seq.end() - full_dbg.get_k() + 1);
-        seq.push_back('$');
-
         // schedule further traversals
-        full_dbg.call_outgoing_kmers(node, [&](node_index next_node, char c) {
-            if (c == '$')
-                return;
-
-            seq.back() = c;
-            assert(full_dbg.kmer_to_node(seq) == next_node);
-            if (continue_traversal(seq, next_node, depth + 1, fork_count + 1)) {
-                paths_to_extend.emplace_back(HullPathContext{
-                    .last_kmer = seq,
-                    .last_node = next_node,
-                    .depth = depth + 1,
-                    .fork_count = fork_count + 1
-                });
-            } else {
-                callback(seq, std::vector<node_index>{ next_node });
-            }
-        });
+        schedule_hull_paths(full_dbg, path.back(), std::move(seq),
+                            depth + 1, fork_count + 1,
+                            callback, continue_traversal, &paths_to_extend);
     }
 }
 
@@ -266,6 +297,7 @@ void call_hull_sequences(const DeBruijnGraph &full_dbg,
  * @param[in]  full_to_small    The mapping between the rows in the full matrix
  *                              and its submatrix.
  * @param[in]  num_threads      The number of threads used.
+ * @param[in]  row_cache        The cache of the full annotation rows (optional).
  *
  * @return     Annotation submatrix in the UniqueRowAnnotator representation
  */
@@ -273,7 +305,12 @@ std::unique_ptr<annot::UniqueRowAnnotator>
 slice_annotation(const AnnotatedDBG::Annotator &full_annotation,
                  uint64_t num_rows,
                  std::vector<std::pair<uint64_t, uint64_t>>&& full_to_small,
-                 size_t num_threads) {
+                 size_t num_threads,
+                 const annot::binmat::RowCache *row_cache = nullptr) {
+    static auto &latency = common::get_histogram("metagraph_annotation_slicing_seconds",
+                                                 "Time spent slicing the annotation for query graphs");
+    common::ScopedLatency slicing_timer(latency);
+
     if (auto *rb = dynamic_cast<const RainbowMatrix *>(&full_annotation.get_matrix())) {
         // shortcut construction for Rainbow<> annotation
         std::vector<uint64_t> row_indexes(full_to_small.size());
@@ -317,10 +354,28 @@ slice_annotation(const AnnotatedDBG::Annotator &full_annotation,
                                     std::allocator<BinaryMatrix::SetBitPositions>,
                                     std::vector<BinaryMatrix::SetBitPositions>,
                                     uint32_t>;
-    RowSet unique_rows { BinaryMatrix::SetBitPositions() };
+    // The rows are distributed between independent sets by their hash, so
+    // the threads deduplicate them concurrently, each locking only the
+    // partitions it inserts to. The empty row is not inserted, it has rank 0.
+    std::vector<RowSet> unique_rows(kNumRowSetPartitions);
+    std::vector<std::mutex> partition_mutexes(kNumRowSetPartitions);
+    // rank of the row in its partition, shifted by one (0 is the empty row)
     std::vector<uint32_t> row_rank(num_rows, 0);
+    std::vector<uint8_t> row_partition(num_rows, 0);
+    std::atomic<bool> too_many_rows = false;
 
-    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+    auto get_partition = [](const BinaryMatrix::SetBitPositions &row) {
+        static_assert(kNumRowSetPartitions == 1 << 8);
+        // take the high bits of the mixed hash
+        return (utils::VectorHash()(row) * 0x9E3779B97F4A7C15ull) >> 56;
+    };
+
+    Timer timer;
+    double fetch_time = 0;
+    double dedup_time = 0;
+
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic) \
+                             reduction(+:fetch_time,dedup_time)
     for (uint64_t batch_begin = 0;
                         batch_begin < full_to_small.size();
                                         batch_begin += kRowBatchSize) {
@@ -328,6 +383,8 @@ slice_annotation(const AnnotatedDBG::Annotator &full_annotation,
             = std::min(batch_begin + kRowBatchSize,
                        static_cast<uint64_t>(full_to_small.size()));
 
+        Timer batch_timer;
+
         std::vector<uint64_t> row_indexes;
         row_indexes.reserve(batch_end - batch_begin);
         for (uint64_t i = batch_begin; i < batch_end; ++i) {
@@ -336,26 +393,78 @@ slice_annotation(const AnnotatedDBG::Annotator &full_annotation,
             row_indexes.push_back(full_to_small[i].first);
         }
 
-        auto rows = full_annotation.get_matrix().get_rows(row_indexes);
+        auto rows = row_cache ? row_cache->get_rows(row_indexes)
+                              : full_annotation.get_matrix().get_rows(row_indexes);
 
         assert(rows.size() == batch_end - batch_begin);
 
-        #pragma omp critical
-        {
-            for (uint64_t i = batch_begin; i < batch_end; ++i) {
-                const auto &row = rows[i - batch_begin];
-                auto it = unique_rows.emplace(row).first;
-                row_rank[full_to_small[i].second] = it - unique_rows.begin();
-                if (unique_rows.size() == std::numeric_limits<uint32_t>::max())
-                    throw std::runtime_error("There must be less than 2^32 unique rows."
-                                             " Reduce the query batch size.");
+        fetch_time += batch_timer.elapsed();
+        batch_timer.reset();
+
+        // group the rows by partition to lock each partition once per batch
+        std::vector<std::vector<uint32_t>> batch_partitions(kNumRowSetPartitions);
+        for (uint64_t i = 0; i < rows.size(); ++i) {
+            if (rows[i].size())
+                batch_partitions[get_partition(rows[i])].push_back(i);
+        }
+
+        for (size_t p = 0; p < kNumRowSetPartitions; ++p) {
+            if (batch_partitions[p].empty())
+                continue;
+
+            std::lock_guard<std::mutex> lock(partition_mutexes[p]);
+            for (uint32_t i : batch_partitions[p]) {
+                if (unique_rows[p].size() + 1 == std::numeric_limits<uint32_t>::max()) {
+                    too_many_rows = true;
+                    break;
+                }
+                auto it = unique_rows[p].emplace(std::move(rows[i])).first;
+                uint64_t small_row = full_to_small[batch_begin + i].second;
+                row_rank[small_row] = it - unique_rows[p].begin() + 1;
+                row_partition[small_row] = p;
             }
         }
+
+        dedup_time += batch_timer.elapsed();
     }
 
-    auto &annotation_rows = const_cast<std::vector<BinaryMatrix::SetBitPositions>&>(
-        unique_rows.values_container()
-    );
+    // offsets of the partitions in the merged row set (the empty row is first)
+    std::vector<uint64_t> offsets(kNumRowSetPartitions + 1, 1);
+    for (size_t p = 0; p < kNumRowSetPartitions; ++p) {
+        offsets[p + 1] = offsets[p] + unique_rows[p].size();
+    }
+
+    if (too_many_rows || offsets.back() >= std::numeric_limits<uint32_t>::max())
+        throw std::runtime_error("There must be less than 2^32 unique rows."
+                                 " Reduce the query batch size.");
+
+    logger->trace("[Query graph construction] Rows fetched in {} sec and"
+                  " deduplicated in {} sec (total thread time), {} sec elapsed",
+                  fetch_time, dedup_time, timer.elapsed());
+    timer.reset();
+
+    std::vector<BinaryMatrix::SetBitPositions> annotation_rows(offsets.back());
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        #pragma omp for schedule(dynamic)
+        for (size_t p = 0; p < kNumRowSetPartitions; ++p) {
+            auto &rows = const_cast<std::vector<BinaryMatrix::SetBitPositions>&>(
+                unique_rows[p].values_container()
+            );
+            std::move(rows.begin(), rows.end(), annotation_rows.begin() + offsets[p]);
+            unique_rows[p] = RowSet();
+        }
+
+        #pragma omp for
+        for (uint64_t i = 0; i < row_rank.size(); ++i) {
+            if (row_rank[i])
+                row_rank[i] += offsets[row_partition[i]] - 1;
+        }
+    }
+
+    logger->trace("[Query graph construction] Merged {} unique rows in {} sec",
+                  annotation_rows.size(), timer.elapsed());
 
     // copy annotations from the full graph to the query graph
     return std::make_unique<annot::UniqueRowAnnotator>(
@@ -412,60 +521,69 @@ void add_nodes_with_suffix_matches(const DBGSuccinct &full_dbg,
     }
 }
 
+// The minimum depths at which the nodes of the full graph have been reached
+// in the hull traversals. The nodes are split between independent maps by
+// their hash, so concurrent traversals rarely contend for the same lock.
+class HullNodeDepths {
+  public:
+    // Return true if |node| has not been reached before at the same or
+    // a smaller depth, i.e., if the traversal through it must continue.
+    bool update(node_index node, uint32_t depth) {
+        // take the high bits of the mixed hash
+        size_t p = (node * 0x9E3779B97F4A7C15ull) >> (64 - kLogNumPartitions);
+        std::lock_guard<std::mutex> lock(mutexes_[p]);
+        auto [it, inserted] = depths_[p].emplace(node, depth);
+        if (inserted)
+            return true;
+
+        if (depth >= it->second)
+            return false;
+
+        it.value() = depth;
+        return true;
+    }
+
+  private:
+    static constexpr size_t kLogNumPartitions = 6;
+
+    std::mutex mutexes_[1 << kLogNumPartitions];
+    tsl::hopscotch_map<node_index, uint32_t> depths_[1 << kLogNumPartitions];
+};
+
 void add_hull_contigs(const DeBruijnGraph &full_dbg,
                       const DeBruijnGraph &batch_graph,
                       size_t max_hull_forks,
                       size_t max_hull_depth,
                       std::vector<std::pair<std::string, std::vector<node_index>>> *contigs) {
-    tsl::hopscotch_map<node_index, uint32_t> distance_traversed_until_node;
+    const size_t num_threads = get_num_threads();
 
-    std::vector<std::pair<std::string, std::vector<node_index>>> contig_buffer;
+    // The nodes of the full graph with k-mers in the batch graph.
+    // The traversals are cut off at these, since they are covered anyway.
+    // The contigs cover all k-mers of the batch graph, so this replaces
+    // looking up the k-mers of the traversed nodes in the batch graph.
+    std::vector<node_index> batch_nodes;
+    // k-mers to start the traversals from
+    std::vector<std::string> start_kmers;
 
-    #pragma omp parallel for num_threads(get_num_threads()) schedule(dynamic)
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
     for (size_t i = 0; i < contigs->size(); ++i) {
         const auto &[contig, path] = (*contigs)[i];
-        std::vector<std::pair<std::string, std::vector<node_index>>> added_paths;
-        // TODO: combine these two callbacks into one?
-        auto callback = [&](const std::string &sequence,
-                            const std::vector<node_index> &path) {
-            added_paths.emplace_back(sequence, path);
-            if (full_dbg.is_canonical_mode()) {
-                added_paths.back().second.resize(0);
-                full_dbg.map_to_nodes(sequence,
-                    [&](node_index cn) { added_paths.back().second.push_back(cn); }
-                );
-            }
-        };
-        auto continue_traversal = [&](std::string_view seq,
-                                      node_index last_node,
-                                      size_t depth,
-                                      size_t fork_count) {
-            if (fork_count > max_hull_forks || depth >= max_hull_depth)
-                return false;
-
-            // if the last node is already in the graph, cut off traversal
-            // since this node will be covered in another traversal
-            if (batch_graph.find(seq.substr(seq.length() - batch_graph.get_k()))) {
-                return false;
-            }
-
-            // when a node which has already been accessed is visited,
-            // only continue traversing if the previous access was in a
-            // longer path (i.e., it cut off earlier)
-            bool extend;
-            // TODO: check the number of forks too (shorter paths may have more forks)
-            #pragma omp critical
-            {
-                auto [it, inserted]
-                    = distance_traversed_until_node.emplace(last_node, depth);
 
-                extend = inserted || depth < it->second;
+        std::vector<node_index> nodes;
+        nodes.reserve(path.size() * (1 + batch_graph.is_canonical_mode()));
+        if (full_dbg.is_canonical_mode()) {
+            // |path| stores the canonical nodes, so map the contig as it is
+            full_dbg.map_to_nodes_sequentially(contig, [&](node_index node) {
+                if (node)
+                    nodes.push_back(node);
+            });
+        } else {
+            // the contig has already been mapped to the full graph
+            std::copy_if(path.begin(), path.end(), std::back_inserter(nodes),
+                         [](node_index node) { return node; });
+        }
 
-                if (!inserted && depth < it->second)
-                    it.value() = depth;
-            }
-            return extend;
-        };
+        std::vector<std::string> kmers;
 
         for (size_t j = 0; j < path.size(); ++j) {
             if (!path[j]) {
@@ -475,8 +593,7 @@ void add_hull_contigs(const DeBruijnGraph &full_dbg,
                 // forward expansion from the incoming nodes
                 batch_graph.adjacent_incoming_nodes(batch_graph.kmer_to_node(kmer),
                     [&](node_index next) {
-                        call_hull_sequences(full_dbg, batch_graph.get_node_sequence(next),
-                                            callback, continue_traversal);
+                        kmers.push_back(batch_graph.get_node_sequence(next));
                     }
                 );
                 if (batch_graph.is_canonical_mode()) {
@@ -486,8 +603,7 @@ void add_hull_contigs(const DeBruijnGraph &full_dbg,
                     reverse_complement(kmer);
                     batch_graph.adjacent_incoming_nodes(batch_graph.kmer_to_node(kmer),
                         [&](node_index next) {
-                            call_hull_sequences(full_dbg, batch_graph.get_node_sequence(next),
-                                                callback, continue_traversal);
+                            kmers.push_back(batch_graph.get_node_sequence(next));
                         }
                     );
                 }
@@ -498,26 +614,107 @@ void add_hull_contigs(const DeBruijnGraph &full_dbg,
 
         std::string last_kmer = contig.substr(contig.length() - full_dbg.get_k(), full_dbg.get_k());
         if (!batch_graph.outdegree(batch_graph.kmer_to_node(last_kmer)))
-            call_hull_sequences(full_dbg, last_kmer, callback, continue_traversal);
+            kmers.push_back(std::move(last_kmer));
 
         if (batch_graph.is_canonical_mode()) {
-            last_kmer = contig.substr(0, full_dbg.get_k());
-            reverse_complement(last_kmer);
+            std::string rev_contig = contig;
+            reverse_complement(rev_contig);
+            full_dbg.map_to_nodes_sequentially(rev_contig, [&](node_index node) {
+                if (node)
+                    nodes.push_back(node);
+            });
+
+            last_kmer = rev_contig.substr(rev_contig.length() - full_dbg.get_k(),
+                                          full_dbg.get_k());
             if (!batch_graph.outdegree(batch_graph.kmer_to_node(last_kmer)))
-                call_hull_sequences(full_dbg, last_kmer, callback, continue_traversal);
+                kmers.push_back(std::move(last_kmer));
         }
 
         #pragma omp critical
         {
-            for (auto&& pair : added_paths) {
-                assert(pair.second.size() == pair.first.length() - full_dbg.get_k() + 1);
-                contig_buffer.emplace_back(std::move(pair));
+            batch_nodes.insert(batch_nodes.end(), nodes.begin(), nodes.end());
+            for (auto&& kmer : kmers) {
+                start_kmers.push_back(std::move(kmer));
             }
         }
     }
 
-    for (auto&& pair : contig_buffer) {
-        contigs->emplace_back(std::move(pair));
+    ips4o::parallel::sort(batch_nodes.begin(), batch_nodes.end(),
+                          std::less<node_index>(), num_threads);
+    batch_nodes.erase(std::unique(batch_nodes.begin(), batch_nodes.end()),
+                      batch_nodes.end());
+
+    // when a node which has already been accessed is visited,
+    // only continue traversing if the previous access was in a
+    // longer path (i.e., it cut off earlier)
+    // TODO: check the number of forks too (shorter paths may have more forks)
+    HullNodeDepths node_depths;
+
+    auto continue_traversal = [&](node_index last_node,
+                                  size_t depth,
+                                  size_t fork_count) {
+        if (fork_count > max_hull_forks || depth >= max_hull_depth)
+            return false;
+
+        // if the last node is already in the graph, cut off traversal
+        // since this node will be covered in another traversal
+        if (std::binary_search(batch_nodes.begin(), batch_nodes.end(), last_node))
+            return false;
+
+        return node_depths.update(last_node, depth);
+    };
+
+    std::vector<std::vector<std::pair<std::string, std::vector<node_index>>>>
+        added_paths(num_threads);
+
+    auto callback = [&](const std::string &sequence, const std::vector<node_index> &path) {
+        auto &paths = added_paths[omp_get_thread_num()];
+        paths.emplace_back(sequence, path);
+        if (full_dbg.is_canonical_mode()) {
+            paths.back().second.resize(0);
+            full_dbg.map_to_nodes(sequence,
+                [&](node_index cn) { paths.back().second.push_back(cn); }
+            );
+        }
+        assert(paths.back().second.size() == sequence.length() - full_dbg.get_k() + 1);
+    };
+
+    // the first steps from all starting points form the initial frontier,
+    // which is then partitioned between the threads
+    std::vector<HullPathContext> frontier;
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        std::vector<HullPathContext> paths_to_extend;
+
+        #pragma omp for schedule(dynamic, 64) nowait
+        for (size_t i = 0; i < start_kmers.size(); ++i) {
+            if (node_index node = full_dbg.kmer_to_node(start_kmers[i])) {
+                schedule_hull_paths(full_dbg, node, std::move(start_kmers[i]), 1, 0,
+                                    callback, continue_traversal, &paths_to_extend);
+            }
+        }
+
+        #pragma omp critical
+        {
+            for (auto&& hull_path : paths_to_extend) {
+                frontier.push_back(std::move(hull_path));
+            }
+        }
+    }
+
+    start_kmers = decltype(start_kmers)();
+
+    #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+    for (size_t i = 0; i < frontier.size(); ++i) {
+        call_hull_sequences(full_dbg, { std::move(frontier[i]) },
+                            callback, continue_traversal);
+    }
+
+    for (auto &paths : added_paths) {
+        for (auto&& pair : paths) {
+            contigs->emplace_back(std::move(pair));
+        }
     }
 }
 
@@ -569,6 +766,10 @@ construct_query_graph(const AnnotatedDBG &anno_graph,
                       size_t num_threads,
                       bool canonical,
                       const Config *config) {
+    static auto &latency = common::get_histogram("metagraph_query_graph_construction_seconds",
+                                                 "Time spent constructing query graphs");
+    common::ScopedLatency construction_timer(latency);
+
     const auto &full_dbg = anno_graph.get_graph();
     const auto &full_annotation = anno_graph.get_annotation();
     const auto *dbg_succ = dynamic_cast<const DBGSuccinct *>(&full_dbg);
@@ -773,7 +974,8 @@ construct_query_graph(const AnnotatedDBG &anno_graph,
     auto annotation = slice_annotation(full_annotation,
                                        graph->max_index(),
                                        std::move(from_full_to_small),
-                                       num_threads);
+                                       num_threads,
+                                       anno_graph.get_row_cache());
 
     logger->trace("[Query graph construction] Query annotation with {} labels"
                   " and {} set bits constructed in {} sec",
@@ -790,12 +992,25 @@ int query_graph(Config *config) {
 
     const auto &files = config->fnames;
 
-    assert(config->infbase_annotators.size() == 1);
+    assert(config->infbase_annotators.size() >= 1);
+
+    if (config->numa) {
+        logger->trace("Interleaving the index across {} NUMA nodes", get_num_numa_nodes());
+        set_numa_interleave(true);
+        set_numa_pinning(true);
+    }
 
     std::shared_ptr<DeBruijnGraph> graph = load_critical_dbg(config->infbase);
 
     std::unique_ptr<AnnotatedDBG> anno_graph = initialize_annotated_dbg(graph, *config);
 
+    if (config->row_cache_size)
+        anno_graph->set_row_cache(config->row_cache_size);
+
+    // allocate the working memory locally
+    if (config->numa)
+        set_numa_interleave(false);
+
     ThreadPool thread_pool(std::max(1u, get_num_threads()) - 1, 1000);
 
     Timer timer;
@@ -856,9 +1071,11 @@ void align_sequence(std::string &name, std::string &seq,
 std::string query_sequence(size_t id, std::string name, std::string seq,
                            const AnnotatedDBG &anno_graph,
                            const Config &config,
-                           const align::DBGAlignerConfig *aligner_config) {
+                           const align::DBGAlignerConfig *aligner_config,
+                           const DeBruijnGraph *align_graph = nullptr) {
     if (aligner_config) {
-        align_sequence(name, seq, anno_graph.get_graph(), *aligner_config);
+        align_sequence(name, seq, align_graph ? *align_graph : anno_graph.get_graph(),
+                       *aligner_config);
     }
 
     return QueryExecutor::execute_query(fmt::format_int(id).str() + '\t' + name, seq,
@@ -874,9 +1091,37 @@ void QueryExecutor::query_fasta(const string &file,
 
     seq_io::FastaParser fasta_parser(file, config_.forward_and_reverse);
 
+    query_sequences(
+        [&](const auto &call_sequence) {
+            for (const seq_io::kseq_t &kseq : fasta_parser) {
+                call_sequence(std::string_view(kseq.name.s, kseq.name.l),
+                              std::string_view(kseq.seq.s, kseq.seq.l));
+            }
+        },
+        file, callback, []() { return false; }
+    );
+}
+
+void QueryExecutor::query_fasta_buffer(std::string_view fasta,
+                                       const std::function<void(const std::string &)> &callback,
+                                       const std::function<bool()> &terminate) {
+    query_sequences(
+        [&](const auto &call_sequence) {
+            seq_io::read_fasta_from_buffer(fasta, call_sequence,
+                                           config_.forward_and_reverse);
+        },
+        "<buffer>", callback, terminate
+    );
+}
+
+void QueryExecutor
+::query_sequences(const NamedSequenceGenerator &generate_sequences,
+                  const std::string &source,
+                  const std::function<void(const std::string &)> &callback,
+                  const std::function<bool()> &terminate) {
     if (config_.fast) {
         // Construct a query graph and query against it
-        batched_query_fasta(fasta_parser, callback);
+        batched_query_sequences(generate_sequences, source, callback, terminate);
         return;
     }
 
@@ -884,39 +1129,35 @@ void QueryExecutor::query_fasta(const string &file,
 
     size_t seq_count = 0;
 
-    for (const seq_io::kseq_t &kseq : fasta_parser) {
+    generate_sequences([&](std::string_view name, std::string_view seq) {
+        if (terminate())
+            return;
+
         thread_pool_.enqueue([&](const auto&... args) {
             callback(query_sequence(args..., anno_graph_,
-                                    config_, aligner_config_.get()));
-        }, seq_count++, std::string(kseq.name.s), std::string(kseq.seq.s));
-    }
+                                    config_, aligner_config_.get(),
+                                    align_graph_.get()));
+        }, seq_count++, std::string(name), std::string(seq));
+    });
 
     // wait while all threads finish processing the current file
     thread_pool_.join();
 }
 
 void QueryExecutor
-::batched_query_fasta(seq_io::FastaParser &fasta_parser,
-                      const std::function<void(const std::string &)> &callback) {
-    auto it = fasta_parser.begin();
-    auto end = fasta_parser.end();
-
+::batched_query_sequences(const NamedSequenceGenerator &generate_sequences,
+                          const std::string &source,
+                          const std::function<void(const std::string &)> &callback,
+                          const std::function<bool()> &terminate) {
     const uint64_t batch_size = config_.query_batch_size_in_bytes;
 
     std::atomic<size_t> seq_count = 0;
 
-    while (it != end) {
-        Timer batch_timer;
+    uint64_t num_bytes_read = 0;
+    std::vector<std::pair<std::string, std::string>> seq_batch;
 
-        uint64_t num_bytes_read = 0;
-        // A generator that can be called multiple times until all sequences
-        // are called.
-        std::vector<std::pair<std::string, std::string>> seq_batch;
-        num_bytes_read = 0;
-        for ( ; it != end && num_bytes_read <= batch_size; ++it) {
-            seq_batch.emplace_back(it->name.s, it->seq.s);
-            num_bytes_read += it->seq.l;
-        }
+    auto query_batch = [&]() {
+        Timer batch_timer;
 
         if (aligner_config_ && !config_.batch_align) {
             logger->trace("Aligning sequences from batch against the full graph...");
@@ -925,7 +1166,8 @@ void QueryExecutor
             #pragma omp parallel for num_threads(get_num_threads()) schedule(dynamic)
             for (size_t i = 0; i < seq_batch.size(); ++i) {
                 align_sequence(seq_batch[i].first, seq_batch[i].second,
-                               anno_graph_.get_graph(), *aligner_config_);
+                               align_graph_ ? *align_graph_ : anno_graph_.get_graph(),
+                               *aligner_config_);
             }
             logger->trace("Sequences alignment took {} sec", batch_timer.elapsed());
             batch_timer.reset();
@@ -945,7 +1187,7 @@ void QueryExecutor
 
         logger->trace("Query graph constructed for batch of sequences"
                       " with {} bases from '{}' in {} sec",
-                      num_bytes_read, fasta_parser.get_filename(), batch_timer.elapsed());
+                      num_bytes_read, source, batch_timer.elapsed());
         batch_timer.reset();
 
         #pragma omp parallel for num_threads(get_num_threads()) schedule(dynamic)
@@ -956,8 +1198,27 @@ void QueryExecutor
         }
 
         logger->trace("Batch of {} bytes from '{}' queried in {} sec", num_bytes_read,
-                      fasta_parser.get_filename(), batch_timer.elapsed());
-    }
+                      source, batch_timer.elapsed());
+
+        seq_batch.clear();
+        num_bytes_read = 0;
+    };
+
+    // the batch is closed by the first sequence exceeding the batch size
+    generate_sequences([&](std::string_view name, std::string_view seq) {
+        // the remaining records are still parsed, but not queried
+        if (terminate())
+            return;
+
+        seq_batch.emplace_back(name, seq);
+        num_bytes_read += seq.size();
+
+        if (num_bytes_read > batch_size)
+            query_batch();
+    });
+
+    if (seq_batch.size() && !terminate())
+        query_batch();
 }
 
 } // namespace cli
@@ -5,17 +5,15 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 
 class ThreadPool;
 
 namespace mtg {
 
-namespace seq_io {
-    class FastaParser;
-}
-
 namespace graph {
     class AnnotatedDBG;
+    class DeBruijnGraph;
     namespace align {
         class DBGAlignerConfig;
     }
@@ -27,6 +25,8 @@ namespace cli {
 class Config;
 
 using StringGenerator = std::function<void(std::function<void(const std::string &)>)>;
+using NamedSequenceGenerator
+    = std::function<void(std::function<void(std::string_view name, std::string_view seq)>)>;
 
 /**
  * Construct a query graph and augment it with neighboring paths around it
@@ -55,6 +55,12 @@ class QueryExecutor {
     void query_fasta(const std::string &file_path,
                      const std::function<void(const std::string &)> &callback);
 
+    // query the fasta/fastq records held in memory, without writing them to disk,
+    // and stop querying further records once |terminate| returns true
+    void query_fasta_buffer(std::string_view fasta,
+                            const std::function<void(const std::string &)> &callback,
+                            const std::function<bool()> &terminate = []() { return false; });
+
     static std::string execute_query(const std::string &seq_name,
                                      const std::string &sequence,
                                      bool count_labels,
@@ -69,10 +75,19 @@ class QueryExecutor {
     const Config &config_;
     const graph::AnnotatedDBG &anno_graph_;
     std::unique_ptr<graph::align::DBGAlignerConfig> aligner_config_;
+    // the subgraph to align to in label-constrained alignment, null otherwise
+    std::shared_ptr<const graph::DeBruijnGraph> align_graph_;
     ThreadPool &thread_pool_;
 
-    void batched_query_fasta(mtg::seq_io::FastaParser &fasta_parser,
-                             const std::function<void(const std::string &)> &callback);
+    void query_sequences(const NamedSequenceGenerator &generate_sequences,
+                         const std::string &source,
+                         const std::function<void(const std::string &)> &callback,
+                         const std::function<bool()> &terminate);
+
+    void batched_query_sequences(const NamedSequenceGenerator &generate_sequences,
+                                 const std::string &source,
+                                 const std::function<void(const std::string &)> &callback,
+                                 const std::function<bool()> &terminate);
 };
 
 
@@ -0,0 +1,420 @@
+#include "router.hpp"
+
+#include <algorithm>
+#include <future>
+#include <unordered_set>
+
+#include <json/json.h>
+#include <client_http.hpp>
+#include <server_http.hpp>
+
+#include "common/logger.hpp"
+#include "common/perf_counters.hpp"
+#include "common/unix_tools.hpp"
+#include "common/threads/threading.hpp"
+#include "seq_io/sequence_io.hpp"
+#include "config/config.hpp"
+#include "server_utils.hpp"
+
+
+namespace mtg {
+namespace cli {
+
+using mtg::common::logger;
+using mtg::common::render_perf_counters;
+
+using HttpClient = SimpleWeb::Client<SimpleWeb::HTTP>;
+
+const std::string FASTA_JSON_FIELD = "FASTA";
+const std::string SEARCH_RESULTS_JSON_FIELD = "results";
+const std::string SAMPLE_JSON_FIELD = "sample";
+const std::string KMER_COUNT_JSON_FIELD = "kmer_count";
+
+
+// A server_query instance serving a shard of the index
+struct Backend {
+    std::string address; // host:port
+    common::LatencyHistogram &latency;
+    common::Counter &num_errors;
+};
+
+std::vector<Backend> init_backends(const std::vector<std::string> &addresses) {
+    std::vector<Backend> backends;
+    for (size_t i = 0; i < addresses.size(); ++i) {
+        std::string prefix = "metagraph_router_backend_" + std::to_string(i);
+        backends.push_back({
+            addresses[i],
+            common::get_histogram(prefix + "_seconds",
+                                  "Time spent waiting for backend " + addresses[i]),
+            common::get_counter(prefix + "_errors_total",
+                                "Number of failed requests to backend " + addresses[i])
+        });
+    }
+    return backends;
+}
+
+// Send a request to the backend and return its parsed response, or null if
+// the backend is unavailable, timed out, or failed. Rejected requests are
+// reported to the client as they are invalid for all backends.
+Json::Value query_backend(const Backend &backend,
+                          const std::string &method,
+                          const std::string &path,
+                          const std::string &payload,
+                          unsigned int timeout) {
+    HttpClient client(backend.address);
+    client.config.timeout = timeout;
+    client.config.timeout_connect = timeout;
+
+    std::shared_ptr<HttpClient::Response> response;
+    Timer timer;
+    try {
+        response = client.request(method, path, payload,
+                                  { { "Content-Type", "application/json" } });
+    } catch (const std::exception &e) {
+        backend.latency.observe(timer.elapsed());
+        backend.num_errors.add();
+        logger->warn("[Router] Backend {} failed after {} sec: {}",
+                     backend.address, timer.elapsed(), e.what());
+        return Json::nullValue;
+    }
+    backend.latency.observe(timer.elapsed());
+    logger->trace("[Router] Backend {} responded to {} in {} sec",
+                  backend.address, path, timer.elapsed());
+
+    Json::Value json;
+    try {
+        json = parse_json_string(response->content.string());
+    } catch (const std::exception &e) {
+        backend.num_errors.add();
+        logger->warn("[Router] Bad response from backend {}: {}", backend.address, e.what());
+        return Json::nullValue;
+    }
+
+    if (response->status_code.compare(0, 3, "200")) {
+        if (response->status_code[0] == '4' && json.isMember("error"))
+            throw std::domain_error(json["error"].asString());
+
+        backend.num_errors.add();
+        logger->warn("[Router] Backend {} returned {}", backend.address,
+                     response->status_code);
+        return Json::nullValue;
+    }
+
+    return json;
+}
+
+// Send the request to all backends concurrently and return their responses
+std::vector<Json::Value> fan_out(const std::vector<Backend> &backends,
+                                 ThreadPool &pool,
+                                 const std::string &method,
+                                 const std::string &path,
+                                 const std::string &payload,
+                                 unsigned int timeout) {
+    std::vector<std::future<Json::Value>> futures;
+    for (const Backend &backend : backends) {
+        futures.push_back(pool.enqueue([&, b = &backend]() {
+            return query_backend(*b, method, path, payload, timeout);
+        }));
+    }
+
+    // wait for all backends before rethrowing, since they reference this frame
+    for (auto &future : futures) {
+        future.wait();
+    }
+
+    std::vector<Json::Value> responses;
+    for (auto &future : futures) {
+        responses.push_back(future.get());
+    }
+
+    if (std::all_of(responses.begin(), responses.end(),
+                    [](const auto &response) { return response.isNull(); }))
+        throw std::runtime_error("None of the backends responded");
+
+    return responses;
+}
+
+// Replace the names of the input sequences with their indexes, so that the
+// entries of the responses can be matched even when a backend omits some of
+// them. Return the original names.
+std::vector<std::string> index_sequences(Json::Value *json) {
+    const auto &fasta = (*json)[FASTA_JSON_FIELD];
+    if (fasta.isNull())
+        throw std::domain_error("No input sequences received from client");
+
+    const char *fasta_begin;
+    const char *fasta_end;
+    if (!fasta.getString(&fasta_begin, &fasta_end))
+        throw std::domain_error("Input sequences must be passed as a string");
+
+    std::vector<std::string> names;
+    std::string indexed_fasta;
+    seq_io::read_fasta_from_buffer(std::string_view(fasta_begin, fasta_end - fasta_begin),
+                                   [&](std::string_view name, std::string_view seq) {
+        indexed_fasta += ">" + std::to_string(names.size()) + "\n";
+        indexed_fasta += seq;
+        indexed_fasta += "\n";
+        names.emplace_back(name);
+    });
+
+    (*json)[FASTA_JSON_FIELD] = indexed_fasta;
+
+    return names;
+}
+
+// Merge the per-sequence entries returned by the backends. The items in
+// |list_field| are concatenated and deduplicated by |key_field|, and the top
+// |max_size| ones by |rank_field| are kept. If |report_all| is false, the
+// sequences without items are omitted, as server_query does for /search.
+Json::Value merge_responses(const std::vector<Json::Value> &responses,
+                            const std::vector<std::string> &names,
+                            const std::string &list_field,
+                            const std::string &key_field,
+                            const std::string &rank_field,
+                            uint64_t max_size,
+                            bool report_all) {
+    std::vector<Json::Value> merged(names.size());
+
+    for (const Json::Value &response : responses) {
+        if (!response.isArray())
+            continue;
+
+        for (const Json::Value &entry : response) {
+            uint64_t id;
+            try {
+                id = std::stoull(entry[SEQ_DESCRIPTION_JSON_FIELD].asString());
+            } catch (...) {
+                continue;
+            }
+            if (id >= names.size())
+                continue;
+
+            Json::Value &target = merged[id];
+            if (target.isNull()) {
+                target = entry;
+                continue;
+            }
+
+            for (const Json::Value &item : entry[list_field]) {
+                target[list_field].append(item);
+            }
+
+            // sequences aligned before the search keep the best alignment
+            if (entry.isMember(SCORE_JSON_FIELD)
+                    && entry[SCORE_JSON_FIELD].asInt() > target[SCORE_JSON_FIELD].asInt()) {
+                for (const auto &field : { SEQUENCE_JSON_FIELD,
+                                           SCORE_JSON_FIELD,
+                                           CIGAR_JSON_FIELD }) {
+                    target[field] = entry[field];
+                }
+            }
+        }
+    }
+
+    Json::Value root = Json::Value(Json::arrayValue);
+
+    for (size_t i = 0; i < merged.size(); ++i) {
+        Json::Value &entry = merged[i];
+        if (entry.isNull()) {
+            if (!report_all)
+                continue;
+
+            entry[list_field] = Json::Value(Json::arrayValue);
+        }
+
+        entry[SEQ_DESCRIPTION_JSON_FIELD] = names[i];
+
+        std::vector<Json::Value> items(entry[list_field].begin(), entry[list_field].end());
+        std::stable_sort(items.begin(), items.end(), [&](const auto &a, const auto &b) {
+            return a[rank_field].asDouble() > b[rank_field].asDouble();
+        });
+
+        Json::Value top_items = Json::Value(Json::arrayValue);
+        std::unordered_set<std::string> keys;
+        for (const Json::Value &item : items) {
+            if (top_items.size() >= max_size)
+                break;
+
+            if (keys.insert(item[key_field].asString()).second)
+                top_items.append(item);
+        }
+        entry[list_field] = std::move(top_items);
+
+        root.append(std::move(entry));
+    }
+
+    return root;
+}
+
+std::string route_search_request(const std::string &received_message,
+                                 const std::vector<Backend> &backends,
+                                 ThreadPool &pool,
+                                 const Config &config) {
+    Json::Value json = parse_json_string(received_message);
+    std::vector<std::string> names = index_sequences(&json);
+
+    uint64_t num_labels = json.get("num_labels", config.num_top_labels).asUInt64();
+
+    auto responses = fan_out(backends, pool, "POST", "/search",
+                             Json::writeString(Json::StreamWriterBuilder(), json),
+                             config.backend_timeout);
+
+    Json::Value root = merge_responses(responses, names,
+                                       SEARCH_RESULTS_JSON_FIELD,
+                                       SAMPLE_JSON_FIELD,
+                                       KMER_COUNT_JSON_FIELD,
+                                       num_labels, false);
+
+    return Json::writeString(Json::StreamWriterBuilder(), root);
+}
+
+std::string route_align_request(const std::string &received_message,
+                                const std::vector<Backend> &backends,
+                                ThreadPool &pool,
+                                const Config &config) {
+    Json::Value json = parse_json_string(received_message);
+    std::vector<std::string> names = index_sequences(&json);
+
+    uint64_t num_alignments = std::max(
+        json.get("max_alternative_alignments",
+                 (uint64_t)config.alignment_num_alternative_paths).asUInt64(),
+        (uint64_t)1
+    );
+
+    auto responses = fan_out(backends, pool, "POST", "/align",
+                             Json::writeString(Json::StreamWriterBuilder(), json),
+                             config.backend_timeout);
+
+    Json::Value root = merge_responses(responses, names,
+                                       ALIGNMENT_JSON_FIELD,
+                                       SEQUENCE_JSON_FIELD,
+                                       SCORE_JSON_FIELD,
+                                       num_alignments, true);
+
+    return Json::writeString(Json::StreamWriterBuilder(), root);
+}
+
+std::string route_column_label_request(const std::vector<Backend> &backends,
+                                       ThreadPool &pool,
+                                       const Config &config) {
+    auto responses = fan_out(backends, pool, "GET", "/column_labels", "",
+                             config.backend_timeout);
+
+    Json::Value root = Json::Value(Json::arrayValue);
+    std::unordered_set<std::string> labels;
+    for (const Json::Value &response : responses) {
+        for (const Json::Value &label : response) {
+            if (labels.insert(label.asString()).second)
+                root.append(label);
+        }
+    }
+
+    return Json::writeString(Json::StreamWriterBuilder(), root);
+}
+
+std::string process_backends_request(const std::vector<Backend> &backends) {
+    Json::Value root = Json::Value(Json::arrayValue);
+
+    for (const Backend &backend : backends) {
+        Json::Value entry;
+        entry["address"] = backend.address;
+        entry["requests"] = backend.latency.count();
+        entry["errors"] = backend.num_errors.get();
+        entry["mean_latency_seconds"] = backend.latency.count()
+                ? backend.latency.sum() / backend.latency.count()
+                : 0.0;
+        root.append(entry);
+    }
+
+    return Json::writeString(Json::StreamWriterBuilder(), root);
+}
+
+int run_router(Config *config) {
+    assert(config);
+    assert(config->fnames.size());
+
+    const std::vector<Backend> backends = init_backends(config->fnames);
+
+    for (const Backend &backend : backends) {
+        logger->info("[Router] Forwarding requests to {}", backend.address);
+    }
+
+    // the requests to backends block, so there are enough workers for all
+    // backends of every request served concurrently
+    ThreadPool pool(backends.size() * std::max(1u, get_num_threads()));
+
+    // defaults for the server
+    config->num_top_labels = 10000;
+
+    HttpServer server;
+    server.resource["^/search"]["POST"] = [&](std::shared_ptr<HttpServer::Response> response,
+                                              std::shared_ptr<HttpServer::Request> request) {
+        static auto &latency = common::get_histogram("metagraph_router_search_request_seconds",
+                                                     "Time spent routing /search requests");
+        common::ScopedLatency request_timer(latency);
+
+        process_request(response, request, [&](const std::string &content) {
+            return route_search_request(content, backends, pool, *config);
+        });
+    };
+
+    server.resource["^/align"]["POST"] = [&](std::shared_ptr<HttpServer::Response> response,
+                                             std::shared_ptr<HttpServer::Request> request) {
+        static auto &latency = common::get_histogram("metagraph_router_align_request_seconds",
+                                                     "Time spent routing /align requests");
+        common::ScopedLatency request_timer(latency);
+
+        process_request(response, request, [&](const std::string &content) {
+            return route_align_request(content, backends, pool, *config);
+        });
+    };
+
+    server.resource["^/column_labels"]["GET"] = [&](std::shared_ptr<HttpServer::Response> response,
+                                                    std::shared_ptr<HttpServer::Request> request) {
+        process_request(response, request, [&](const std::string &) {
+            return route_column_label_request(backends, pool, *config);
+        });
+    };
+
+    // latency and errors of every backend
+    server.resource["^/backends"]["GET"] = [&](std::shared_ptr<HttpServer::Response> response,
+                                               std::shared_ptr<HttpServer::Request> request) {
+        process_request(response, request, [&](const std::string &) {
+            return process_backends_request(backends);
+        });
+    };
+
+    // performance counters in the Prometheus text format
+    server.resource["^/metrics"]["GET"] = [&](std::shared_ptr<HttpServer::Response> response,
+                                              std::shared_ptr<HttpServer::Request>) {
+        SimpleWeb::CaseInsensitiveMultimap header;
+        header.emplace("Content-Type", "text/plain; version=0.0.4");
+        response->write(SimpleWeb::StatusCode::success_ok, render_perf_counters(), header);
+    };
+
+    server.default_resource["GET"] = [](std::shared_ptr<HttpServer::Response> response,
+                                        std::shared_ptr<HttpServer::Request> request) {
+        logger->info("Not found " + request->path);
+        response->write(SimpleWeb::StatusCode::client_error_not_found,
+                        "Could not find path " + request->path);
+    };
+    server.default_resource["POST"] = server.default_resource["GET"];
+
+    server.on_error = [](std::shared_ptr<HttpServer::Request> /*request*/,
+                         const SimpleWeb::error_code &ec) {
+        // Handle errors here, ignoring a few trivial ones.
+        if (ec.value() != asio::stream_errc::eof
+                && ec.value() != asio::error::operation_aborted) {
+            logger->info("[Router] Got error {} {} {}",
+                         ec.message(), ec.category().name(), ec.value());
+        }
+    };
+
+    std::thread server_thread = start_server(server, *config);
+    server_thread.join();
+
+    return 0;
+}
+
+} // namespace cli
+} // namespace mtg
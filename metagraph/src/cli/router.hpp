@@ -0,0 +1,20 @@
+#ifndef __SERVER_ROUTER_HPP__
+#define __SERVER_ROUTER_HPP__
+
+
+namespace mtg {
+namespace cli {
+
+class Config;
+
+/**
+ * Serve /search and /align requests by forwarding them concurrently to
+ * several server_query instances (shards of the index), given in
+ * config->fnames as host:port, and merging their responses.
+ */
+int run_router(Config *config);
+
+} // namespace cli
+} // namespace mtg
+
+#endif // __SERVER_ROUTER_HPP__
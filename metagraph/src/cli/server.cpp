@@ -1,10 +1,19 @@
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <tuple>
+
 #include <json/json.h>
 #include <server_http.hpp>
 
 #include "common/logger.hpp"
+#include "common/perf_counters.hpp"
 #include "common/unix_tools.hpp"
+#include "common/threads/numa.hpp"
+#include "common/threads/threading.hpp"
 #include "common/utils/string_utils.hpp"
-#include "common/utils/file_utils.hpp"
 #include "graph/alignment/dbg_aligner.hpp"
 #include "graph/annotated_dbg.hpp"
 #include "seq_io/sequence_io.hpp"
@@ -20,15 +29,19 @@ namespace mtg {
 namespace cli {
 
 using mtg::common::logger;
+using mtg::common::render_perf_counters;
 using mtg::graph::AnnotatedDBG;
 
 using HttpServer = SimpleWeb::Server<SimpleWeb::HTTP>;
 
-const std::string SEQ_DESCRIPTION_JSON_FIELD = "seq_description";
-const std::string SCORE_JSON_FIELD = "score";
-const std::string SEQUENCE_JSON_FIELD = "sequence";
-const std::string ALIGNMENT_JSON_FIELD = "alignments";
-const std::string CIGAR_JSON_FIELD = "cigar";
+// sequences of /align requests are aligned in batches of at least this many bases
+const uint64_t kMinAlignBatchBases = 10'000;
+const uint64_t kNumAlignBatchesPerThread = 4;
+
+// sequences of streamed /search_stream requests are queried in batches of this many bases
+const unsigned long long kStreamingBatchSize = 1'000'000;
+// results of streamed requests are sent in chunks of about this many bytes
+const size_t kStreamingChunkSize = 64 * 1024;
 
 // convert values into proper types, i.e. 'nan' -> null, strings representing numbers -> numbers
 Json::Value adjust_for_types(const std::string &v) {
@@ -42,64 +55,78 @@ Json::Value adjust_for_types(const std::string &v) {
     return Json::Value(v);
 }
 
-std::string convert_query_response_to_json(const std::string &ret_str) {
-    // TODO: we are parsing back the string generated by the 'query' code, which is ugly.
-    // we should have an intermediate representation which can be converted to a string (when
-    // query is invoked from the command line) or to a json (string) when invoked by the server.
-    std::vector<std::string> queries = utils::split_string(ret_str, "\n");
+// Convert a line printed by the query code to JSON, return null if no labels were found
+Json::Value convert_query_result_to_json(const std::string &line, long long *id) {
+    std::vector<std::string> parts = utils::split_string(line, "\t", false);
 
-    std::vector<std::pair<long long, Json::Value>> query_results;
-    query_results.reserve(query_results.size());
+    if (parts.size() <= 2)
+        return Json::nullValue; // no sequences found
 
-    for (auto qit = queries.begin(); qit != queries.end(); ++qit) {
-        std::vector<std::string> parts = utils::split_string(*qit, "\t", false);
+    Json::Value res_obj;
+    std::vector<std::string> query_desc_parts = utils::split_string(parts[1], ":");
 
-        if (parts.size() <= 2)
-            continue; // no sequences found
+    res_obj[SEQ_DESCRIPTION_JSON_FIELD] = "";
+    if (!query_desc_parts.empty())
+        res_obj[SEQ_DESCRIPTION_JSON_FIELD] = query_desc_parts[0];
 
-        Json::Value res_obj;
-        std::vector<std::string> query_desc_parts = utils::split_string(parts[1], ":");
+    if (query_desc_parts.size() > 1) {
+        // we aligned first, so extracting aligned sequence and score:
 
-        res_obj[SEQ_DESCRIPTION_JSON_FIELD] = "";
-        if (!query_desc_parts.empty())
-            res_obj[SEQ_DESCRIPTION_JSON_FIELD] = query_desc_parts[0];
+        res_obj[SEQUENCE_JSON_FIELD] = query_desc_parts[1];
+        res_obj[SCORE_JSON_FIELD] = (int)atoi(query_desc_parts[2].c_str());
+        res_obj[CIGAR_JSON_FIELD] = query_desc_parts[3];
+    }
 
-        if (query_desc_parts.size() > 1) {
-            // we aligned first, so extracting aligned sequence and score:
+    res_obj["results"] = Json::Value(Json::arrayValue);
 
-            res_obj[SEQUENCE_JSON_FIELD] = query_desc_parts[1];
-            res_obj[SCORE_JSON_FIELD] = (int)atoi(query_desc_parts[2].c_str());
-            res_obj[CIGAR_JSON_FIELD] = query_desc_parts[3];
-        }
+    for (size_t i = 2; i < parts.size(); ++i) {
+        Json::Value sampleEntry;
 
-        res_obj["results"] = Json::Value(Json::arrayValue);
+        std::vector<std::string> entries = utils::split_string(parts[i], ":");
 
-        for (size_t i = 2; i < parts.size(); ++i) {
-            Json::Value sampleEntry;
+        std::vector<std::string> labels
+            = utils::split_string(entries[0].substr(1, entries[0].size() - 2), ";");
 
-            std::vector<std::string> entries = utils::split_string(parts[i], ":");
+        sampleEntry["sample"] = labels[0];
 
-            std::vector<std::string> labels
-                = utils::split_string(entries[0].substr(1, entries[0].size() - 2), ";");
+        Json::Value properties = Json::objectValue;
 
-            sampleEntry["sample"] = labels[0];
+        for (auto lit = ++labels.begin(); lit != labels.end(); ++lit) {
+            std::vector<std::string> key_value = utils::split_string(*lit, "=");
+            properties[key_value[0]] = adjust_for_types(key_value[1]);
+        }
 
-            Json::Value properties = Json::objectValue;
+        if (properties.size() > 0) {
+            sampleEntry["properties"] = properties;
+        }
+        sampleEntry["kmer_count"] = (int)atoi(entries[1].c_str());
 
-            for (auto lit = ++labels.begin(); lit != labels.end(); ++lit) {
-                std::vector<std::string> key_value = utils::split_string(*lit, "=");
-                properties[key_value[0]] = adjust_for_types(key_value[1]);
-            }
+        res_obj["results"].append(sampleEntry);
+    }
 
-            if (properties.size() > 0) {
-                sampleEntry["properties"] = properties;
-            }
-            sampleEntry["kmer_count"] = (int)atoi(entries[1].c_str());
+    *id = atoll(parts[0].c_str());
 
-            res_obj["results"].append(sampleEntry);
-        }
+    return res_obj;
+}
 
-        query_results.emplace_back(atoll(parts[0].c_str()), std::move(res_obj));
+std::string convert_query_response_to_json(const std::string &ret_str) {
+    static auto &latency = common::get_histogram("metagraph_json_rendering_seconds",
+                                                 "Time spent rendering query results to JSON");
+    common::ScopedLatency rendering_timer(latency);
+
+    // TODO: we are parsing back the string generated by the 'query' code, which is ugly.
+    // we should have an intermediate representation which can be converted to a string (when
+    // query is invoked from the command line) or to a json (string) when invoked by the server.
+    std::vector<std::string> queries = utils::split_string(ret_str, "\n");
+
+    std::vector<std::pair<long long, Json::Value>> query_results;
+    query_results.reserve(query_results.size());
+
+    for (const std::string &query : queries) {
+        long long id;
+        Json::Value res_obj = convert_query_result_to_json(query, &id);
+        if (!res_obj.isNull())
+            query_results.emplace_back(id, std::move(res_obj));
     }
 
     std::sort(query_results.begin(), query_results.end(), utils::LessFirst());
@@ -114,69 +141,83 @@ std::string convert_query_response_to_json(const std::string &ret_str) {
     return Json::writeString(builder, root);
 }
 
-
-std::string process_search_request(const std::string &received_message,
-                                   const graph::AnnotatedDBG &anno_graph,
-                                   const Config &config_orig) {
-    Json::Value json = parse_json_string(received_message);
-
+// Return the sequences passed in the request
+std::string_view get_request_fasta(const Json::Value &json) {
     const auto &fasta = json["FASTA"];
     if (fasta.isNull())
         throw std::domain_error("No input sequences received from client");
 
-    Config config(config_orig);
+    // view the sequences in the parsed request, they are never copied or written to disk
+    const char *fasta_begin;
+    const char *fasta_end;
+    if (!fasta.getString(&fasta_begin, &fasta_end))
+        throw std::domain_error("Input sequences must be passed as a string");
+
+    return std::string_view(fasta_begin, fasta_end - fasta_begin);
+}
+
+// Set the search parameters passed in the request and return the aligner
+// config if the sequences must be aligned first
+std::unique_ptr<graph::align::DBGAlignerConfig>
+init_search_config(const Json::Value &json,
+                   const graph::AnnotatedDBG &anno_graph,
+                   Config *config) {
     // discovery_fraction a proxy of 1 - %similarity
-    config.discovery_fraction
-            = json.get("discovery_fraction", config.discovery_fraction).asDouble();
+    config->discovery_fraction
+            = json.get("discovery_fraction", config->discovery_fraction).asDouble();
 
-    config.alignment_min_exact_match
+    config->alignment_min_exact_match
             = json.get("min_exact_match",
-                       config.alignment_min_exact_match).asDouble();
+                       config->alignment_min_exact_match).asDouble();
 
-    config.alignment_max_nodes_per_seq_char = json.get(
+    config->alignment_max_nodes_per_seq_char = json.get(
         "max_num_nodes_per_seq_char",
-        config.alignment_max_nodes_per_seq_char).asDouble();
+        config->alignment_max_nodes_per_seq_char).asDouble();
 
-    if (config.discovery_fraction < 0.0 || config.discovery_fraction > 1.0) {
+    if (config->discovery_fraction < 0.0 || config->discovery_fraction > 1.0) {
         throw std::domain_error(
                 "Discovery fraction should be within [0, 1.0]. Instead got "
-                + std::to_string(config.discovery_fraction));
+                + std::to_string(config->discovery_fraction));
     }
 
-    if (config.alignment_min_exact_match < 0.0
-            || config.alignment_min_exact_match > 1.0) {
+    if (config->alignment_min_exact_match < 0.0
+            || config->alignment_min_exact_match > 1.0) {
         throw std::domain_error(
                 "Minimum exact match should be within [0, 1.0]. Instead got "
-                + std::to_string(config.alignment_min_exact_match));
+                + std::to_string(config->alignment_min_exact_match));
     }
 
-    config.count_labels = true;
-    config.num_top_labels = json.get("num_labels", config.num_top_labels).asInt();
-    config.fast = json.get("fast", config.fast).asBool();
+    config->count_labels = true;
+    config->num_top_labels = json.get("num_labels", config->num_top_labels).asInt();
+    config->fast = json.get("fast", config->fast).asBool();
 
     std::unique_ptr<graph::align::DBGAlignerConfig> aligner_config;
     if (json.get("align", false).asBool()) {
         aligner_config.reset(new graph::align::DBGAlignerConfig(
-            initialize_aligner_config(anno_graph.get_graph().get_k(), config)
+            initialize_aligner_config(anno_graph.get_graph().get_k(), *config)
         ));
     }
 
+    return aligner_config;
+}
+
+std::string process_search_request(const std::string &received_message,
+                                   const graph::AnnotatedDBG &anno_graph,
+                                   const Config &config_orig) {
+    Json::Value json = parse_json_string(received_message);
+    std::string_view fasta = get_request_fasta(json);
+
+    Config config(config_orig);
+    auto aligner_config = init_search_config(json, anno_graph, &config);
+
     std::ostringstream oss;
     std::mutex oss_mutex;
 
-    // writing to temporary file in order to reuse query code. This is not optimal and
-    // may turn out to be an issue in production. However, adapting FastaParser to
-    // work on strings seems non-trivial. An alternative would be to use
-    // read_fasta_from_string for non fast queries.
-    utils::TempFile tf(config.tmp_dir);
-    tf.ofstream() << fasta.asString();
-    tf.ofstream().close();
-
     // dummy pool doing everything in the caller thread
     ThreadPool dummy_pool(0);
     QueryExecutor engine(config, anno_graph, std::move(aligner_config), dummy_pool);
 
-    engine.query_fasta(tf.name(),
+    engine.query_fasta_buffer(fasta,
         [&](const std::string &res) {
             std::lock_guard<std::mutex> lock(oss_mutex);
             oss << res;
@@ -186,14 +227,124 @@ std::string process_search_request(const std::string &received_message,
     return convert_query_response_to_json(oss.str());
 }
 
-std::string process_align_request(const std::string &received_message,
-                                  const graph::DeBruijnGraph &graph,
-                                  const Config &config_orig) {
+// Query the sequences in batches and write the results as they come, one
+// JSON object per line (NDJSON), in chunks of about kStreamingChunkSize bytes
+void stream_search_request(const std::string &received_message,
+                           const graph::AnnotatedDBG &anno_graph,
+                           const Config &config_orig,
+                           const std::function<void(const std::string &)> &write_chunk) {
+    Json::Value json = parse_json_string(received_message);
+    std::string_view fasta = get_request_fasta(json);
+
+    Config config(config_orig);
+    auto aligner_config = init_search_config(json, anno_graph, &config);
+
+    // small batches for the first results to come out early
+    config.query_batch_size_in_bytes = std::min(config.query_batch_size_in_bytes,
+                                                kStreamingBatchSize);
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+
+    std::string chunk;
+    std::mutex chunk_mutex;
+    // the callback may be called from parallel regions, so it must not throw
+    std::exception_ptr write_error;
+
+    // dummy pool doing everything in the caller thread
+    ThreadPool dummy_pool(0);
+    QueryExecutor engine(config, anno_graph, std::move(aligner_config), dummy_pool);
+
+    engine.query_fasta_buffer(fasta,
+        [&](const std::string &res) {
+            std::string lines;
+            for (const std::string &line : utils::split_string(res, "\n")) {
+                long long id;
+                Json::Value res_obj = convert_query_result_to_json(line, &id);
+                if (!res_obj.isNull())
+                    lines += Json::writeString(builder, res_obj) + "\n";
+            }
+
+            std::lock_guard<std::mutex> lock(chunk_mutex);
+            if (write_error)
+                return;
+
+            chunk += lines;
+            // the workers wait while the chunk is sent, which bounds the memory
+            if (chunk.size() >= kStreamingChunkSize) {
+                try {
+                    write_chunk(chunk);
+                } catch (...) {
+                    write_error = std::current_exception();
+                }
+                chunk.clear();
+            }
+        },
+        // stop querying once the client has disconnected
+        [&]() {
+            std::lock_guard<std::mutex> lock(chunk_mutex);
+            return bool(write_error);
+        }
+    );
+
+    if (write_error)
+        std::rethrow_exception(write_error);
+
+    write_chunk(chunk);
+}
+
+// Return an aligner for the given parameters, reusing the ones built for
+// previous requests with the same parameters.
+std::shared_ptr<const graph::align::IDBGAligner>
+get_cached_aligner(const graph::DeBruijnGraph &graph, const Config &config) {
+    // the parameters which can be set in requests, all others are fixed
+    typedef std::tuple<uint64_t, double, double> AlignerKey;
+    // the parameters come from clients, so the number of aligners is bounded
+    static constexpr size_t kMaxNumCachedAligners = 64;
+
+    static std::mutex mu;
+    static const graph::DeBruijnGraph *cached_graph = nullptr;
+    static std::map<AlignerKey, std::shared_ptr<const graph::align::IDBGAligner>> aligners;
+
+    AlignerKey key(config.alignment_num_alternative_paths,
+                   config.alignment_min_exact_match,
+                   config.alignment_max_nodes_per_seq_char);
+
+    std::lock_guard<std::mutex> lock(mu);
+
+    if (cached_graph != &graph) {
+        aligners.clear();
+        cached_graph = &graph;
+    }
+
+    auto it = aligners.find(key);
+    if (it != aligners.end())
+        return it->second;
+
+    if (aligners.size() >= kMaxNumCachedAligners)
+        aligners.erase(aligners.begin());
+
+    return aligners.emplace(key, build_aligner(graph, config)).first->second;
+}
+
+// Align the sequences of the request in batches on |compute_pool| and call
+// the rendered JSON entries of every batch, in the order of the request, as
+// soon as the batch and all batches before it are aligned
+void align_request(const std::string &received_message,
+                   const graph::DeBruijnGraph &graph,
+                   const Config &config_orig,
+                   ThreadPool &compute_pool,
+                   const std::function<void(const std::vector<std::string> &)> &callback) {
     Json::Value json = parse_json_string(received_message);
 
     const auto &fasta = json["FASTA"];
+    if (fasta.isNull())
+        throw std::domain_error("No input sequences received from client");
 
-    Json::Value root = Json::Value(Json::arrayValue);
+    const char *fasta_begin;
+    const char *fasta_end;
+    if (!fasta.getString(&fasta_begin, &fasta_end))
+        throw std::domain_error("Input sequences must be passed as a string");
 
     Config config(config_orig);
 
@@ -223,35 +374,145 @@ std::string process_align_request(const std::string &received_message,
         "max_num_nodes_per_seq_char",
         config.alignment_max_nodes_per_seq_char).asDouble();
 
-    std::unique_ptr<graph::align::IDBGAligner> aligner = build_aligner(graph, config);
+    auto aligner = get_cached_aligner(graph, config);
+
+    // views into the request, which is kept alive until all alignments finish
+    typedef std::vector<std::pair<std::string_view, std::string_view>> SeqBatch;
+    SeqBatch seqs;
+    // sequences wrapped over multiple lines are not contiguous in the request
+    std::deque<std::string> wrapped_seqs;
+    uint64_t num_bases = 0;
+    std::string_view request_fasta(fasta_begin, fasta_end - fasta_begin);
+    seq_io::read_fasta_from_buffer(request_fasta, [&](std::string_view name,
+                                                      std::string_view seq) {
+        if (std::less<const char *>()(seq.data(), fasta_begin)
+                || std::less<const char *>()(fasta_end, seq.data() + seq.size()))
+            seq = wrapped_seqs.emplace_back(seq);
+
+        seqs.emplace_back(name, seq);
+        num_bases += seq.size();
+    });
 
-    // TODO: make parallel?
-    seq_io::read_fasta_from_string(fasta.asString(),
-                                   [&](seq_io::kseq_t *read_stream) {
-        const auto paths = aligner->align(read_stream->seq.s);
+    // split the request into a few batches per worker to balance the load
+    const uint64_t batch_size = std::max(kMinAlignBatchBases,
+                                         num_bases / (kNumAlignBatchesPerThread
+                                                        * get_num_threads()) + 1);
 
-        Json::Value align_entry;
-        align_entry[SEQ_DESCRIPTION_JSON_FIELD] = read_stream->name.s;
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+
+    // the entries are rendered by the workers as soon as their alignments
+    // finish, and the batches are passed in the order of the request
+    std::vector<std::vector<std::string>> rendered_batches;
+
+    auto align_batch = [&](SeqBatch::const_iterator begin, SeqBatch::const_iterator end,
+                           std::vector<std::string> *rendered) {
+        aligner->align_batch(
+            [&](const auto &query_callback) {
+                for (auto it = begin; it != end; ++it) {
+                    query_callback(it->first, it->second, false /* orientation of seq */);
+                }
+            },
+            [&](std::string_view header, auto&& paths) {
+                Json::Value align_entry;
+                align_entry[SEQ_DESCRIPTION_JSON_FIELD] = std::string(header);
+
+                // not supporting reverse complement yet
+                Json::Value alignments = Json::Value(Json::arrayValue);
+
+                for (const auto &path : paths) {
+                    Json::Value a;
+                    a[SCORE_JSON_FIELD] = path.get_score();
+                    a[SEQUENCE_JSON_FIELD] = path.get_sequence();
+                    a[CIGAR_JSON_FIELD] = path.get_cigar().to_string();
+
+                    alignments.append(a);
+                };
+
+                align_entry[ALIGNMENT_JSON_FIELD] = alignments;
+
+                rendered->push_back(Json::writeString(builder, align_entry));
+            }
+        );
+    };
 
-        // not supporting reverse complement yet
-        Json::Value alignments = Json::Value(Json::arrayValue);
+    std::vector<std::pair<SeqBatch::const_iterator, SeqBatch::const_iterator>> batch_ranges;
+    for (auto it = seqs.cbegin(); it != seqs.cend(); ) {
+        auto batch_begin = it;
+        for (uint64_t batch_bases = 0; it != seqs.cend() && batch_bases < batch_size; ++it) {
+            batch_bases += it->second.size();
+        }
+        batch_ranges.emplace_back(batch_begin, it);
+    }
 
-        for (const auto &path : paths) {
-            Json::Value a;
-            a[SCORE_JSON_FIELD] = path.get_score();
-            a[SEQUENCE_JSON_FIELD] = path.get_sequence();
-            a[CIGAR_JSON_FIELD] = path.get_cigar().to_string();
+    rendered_batches.resize(batch_ranges.size());
 
-            alignments.append(a);
-        };
+    std::vector<std::future<void>> batches;
+    for (size_t i = 0; i < batch_ranges.size(); ++i) {
+        batches.push_back(compute_pool.enqueue(align_batch, batch_ranges[i].first,
+                                               batch_ranges[i].second,
+                                               &rendered_batches[i]));
+    }
 
-        align_entry[ALIGNMENT_JSON_FIELD] = alignments;
+    // wait for all batches before rethrowing, since they reference this frame
+    std::exception_ptr error;
+    for (size_t i = 0; i < batches.size(); ++i) {
+        batches[i].wait();
+        if (error)
+            continue;
+
+        try {
+            batches[i].get();
+            callback(rendered_batches[i]);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        rendered_batches[i] = std::vector<std::string>();
+    }
 
-        root.append(align_entry);
-    });
+    if (error)
+        std::rethrow_exception(error);
+}
 
-    Json::StreamWriterBuilder builder;
-    return Json::writeString(builder, root);
+std::string process_align_request(const std::string &received_message,
+                                  const graph::DeBruijnGraph &graph,
+                                  const Config &config,
+                                  ThreadPool &compute_pool) {
+    std::string result = "[";
+    align_request(received_message, graph, config, compute_pool,
+        [&](const std::vector<std::string> &entries) {
+            for (const std::string &entry : entries) {
+                if (result.size() > 1)
+                    result += ",";
+                result += entry;
+            }
+        }
+    );
+    return result + "]";
+}
+
+// Align the sequences in batches and write the results in the order of the
+// request as the batches finish, one JSON object per line (NDJSON), in chunks
+// of about kStreamingChunkSize bytes
+void stream_align_request(const std::string &received_message,
+                          const graph::DeBruijnGraph &graph,
+                          const Config &config,
+                          ThreadPool &compute_pool,
+                          const std::function<void(const std::string &)> &write_chunk) {
+    std::string chunk;
+    align_request(received_message, graph, config, compute_pool,
+        [&](const std::vector<std::string> &entries) {
+            for (const std::string &entry : entries) {
+                chunk += entry;
+                chunk += "\n";
+            }
+            if (chunk.size() >= kStreamingChunkSize) {
+                write_chunk(chunk);
+                chunk.clear();
+            }
+        }
+    );
+    write_chunk(chunk);
 }
 
 std::string process_column_label_request(const graph::AnnotatedDBG &anno_graph) {
@@ -289,21 +550,18 @@ std::string process_stats_request(const graph::AnnotatedDBG &anno_graph,
 
     root["annotation"] = annotation_stats;
 
-    Json::StreamWriterBuilder builder;
-    return Json::writeString(builder, root);
-}
-
-std::thread start_server(HttpServer &server_startup, Config &config) {
-    server_startup.config.thread_pool_size = std::max(1u, get_num_threads());
-
-    if (config.host_address != "") {
-        server_startup.config.address = config.host_address;
+    if (const auto *row_cache = anno_graph.get_row_cache()) {
+        Json::Value cache_stats;
+        cache_stats["capacity"] = static_cast<uint64_t>(row_cache->capacity());
+        cache_stats["size"] = static_cast<uint64_t>(row_cache->size());
+        cache_stats["hits"] = row_cache->num_hits();
+        cache_stats["misses"] = row_cache->num_misses();
+        cache_stats["hit_rate"] = row_cache->hit_rate();
+        root["row_cache"] = cache_stats;
     }
-    server_startup.config.port = config.port;
 
-    logger->info("[Server] Will listen on {} port {}", config.host_address,
-                 server_startup.config.port);
-    return std::thread([&server_startup]() { server_startup.start(); });
+    Json::StreamWriterBuilder builder;
+    return Json::writeString(builder, root);
 }
 
 template<typename T>
@@ -321,7 +579,7 @@ bool check_data_ready(std::shared_future<T> &data, shared_ptr<HttpServer::Respon
 int run_server(Config *config) {
     assert(config);
 
-    assert(config->infbase_annotators.size() == 1);
+    assert(config->infbase_annotators.size() >= 1);
 
     ThreadPool graph_loader(1, 1);
 
@@ -331,22 +589,51 @@ int run_server(Config *config) {
     config->canonical = true;
 
     auto anno_graph = graph_loader.enqueue([&]() {
+        // the memory policy is set per thread
+        if (config->numa) {
+            logger->info("[Server] Interleaving the index across {} NUMA nodes",
+                         get_num_numa_nodes());
+            set_numa_interleave(true);
+        }
+
         auto graph = load_critical_dbg(config->infbase);
         logger->info("[Server] Graph loaded. Current mem usage: {} MiB", get_curr_RSS() >> 20);
 
         auto anno_graph = initialize_annotated_dbg(graph, *config);
         logger->info("[Server] Annotated graph loaded too. Current mem usage: {} MiB", get_curr_RSS() >> 20);
+
+        if (config->row_cache_size) {
+            anno_graph->set_row_cache(config->row_cache_size);
+            logger->info("[Server] Caching up to {} annotation rows", config->row_cache_size);
+        }
+
+        if (config->numa)
+            set_numa_interleave(false);
+
         return anno_graph;
     });
 
+    // pin the threads serving requests
+    if (config->numa)
+        set_numa_pinning(true);
+
     // defaults for the server
     config->num_top_labels = 10000;
     config->fast = true;
 
+    // workers shared by all requests for the compute-heavy parts
+    ThreadPool compute_pool(get_num_threads());
+    // workers serving streamed requests, which block while writing the response
+    ThreadPool streaming_pool(std::max(1u, get_num_threads()));
+
     // the actual server
     HttpServer server;
     server.resource["^/search"]["POST"] = [&](shared_ptr<HttpServer::Response> response,
                                               shared_ptr<HttpServer::Request> request) {
+        static auto &latency = common::get_histogram("metagraph_search_request_seconds",
+                                                     "Time spent processing /search requests");
+        common::ScopedLatency request_timer(latency);
+
         if (check_data_ready(anno_graph, response)) {
             process_request(response, request, [&](const std::string &content) {
                 return process_search_request(content, *anno_graph.get(), *config);
@@ -354,15 +641,61 @@ int run_server(Config *config) {
         }
     };
 
+    server.resource["^/search_stream"]["POST"] = [&](shared_ptr<HttpServer::Response> response,
+                                                     shared_ptr<HttpServer::Request> request) {
+        if (!check_data_ready(anno_graph, response))
+            return;
+
+        // the response is written from another thread, so that the threads
+        // of the server are free to send the chunks
+        streaming_pool.force_enqueue([&, response, request]() mutable {
+            static auto &latency = common::get_histogram("metagraph_search_stream_request_seconds",
+                                                         "Time spent processing /search_stream requests");
+            common::ScopedLatency request_timer(latency);
+
+            process_streaming_request(response, request,
+                [&](const std::string &content, const auto &write_chunk) {
+                    stream_search_request(content, *anno_graph.get(), *config, write_chunk);
+                }
+            );
+        });
+    };
+
     server.resource["^/align"]["POST"] = [&](shared_ptr<HttpServer::Response> response,
                                              shared_ptr<HttpServer::Request> request) {
+        static auto &latency = common::get_histogram("metagraph_align_request_seconds",
+                                                     "Time spent processing /align requests");
+        common::ScopedLatency request_timer(latency);
+
         if (check_data_ready(anno_graph, response)) {
             process_request(response, request, [&](const std::string &content) {
-                return process_align_request(content, anno_graph.get()->get_graph(), *config);
+                return process_align_request(content, anno_graph.get()->get_graph(),
+                                             *config, compute_pool);
             });
         }
     };
 
+    server.resource["^/align_stream"]["POST"] = [&](shared_ptr<HttpServer::Response> response,
+                                                    shared_ptr<HttpServer::Request> request) {
+        if (!check_data_ready(anno_graph, response))
+            return;
+
+        // the response is written from another thread, so that the threads
+        // of the server are free to send the chunks
+        streaming_pool.force_enqueue([&, response, request]() mutable {
+            static auto &latency = common::get_histogram("metagraph_align_stream_request_seconds",
+                                                         "Time spent processing /align_stream requests");
+            common::ScopedLatency request_timer(latency);
+
+            process_streaming_request(response, request,
+                [&](const std::string &content, const auto &write_chunk) {
+                    stream_align_request(content, anno_graph.get()->get_graph(),
+                                         *config, compute_pool, write_chunk);
+                }
+            );
+        });
+    };
+
     server.resource["^/column_labels"]["GET"] = [&](shared_ptr<HttpServer::Response> response,
                                                     shared_ptr<HttpServer::Request> request) {
         if (check_data_ready(anno_graph, response)) {
@@ -382,6 +715,14 @@ int run_server(Config *config) {
         }
     };
 
+    // performance counters in the Prometheus text format
+    server.resource["^/metrics"]["GET"] = [&](shared_ptr<HttpServer::Response> response,
+                                              shared_ptr<HttpServer::Request>) {
+        SimpleWeb::CaseInsensitiveMultimap header;
+        header.emplace("Content-Type", "text/plain; version=0.0.4");
+        response->write(SimpleWeb::StatusCode::success_ok, render_perf_counters(), header);
+    };
+
     server.default_resource["GET"] = [](shared_ptr<HttpServer::Response> response,
                                         shared_ptr<HttpServer::Request> request) {
         logger->info("Not found " + request->path);
@@ -1,8 +1,14 @@
+#include <future>
+#include <tuple>
 #include <zlib.h>
 #include <json/json.h>
 #include <server_http.hpp>
 
 #include "common/logger.hpp"
+#include "common/perf_counters.hpp"
+#include "common/threads/numa.hpp"
+#include "common/threads/threading.hpp"
+#include "config/config.hpp"
 #include "server_utils.hpp"
 
 
@@ -100,6 +106,18 @@ std::string json_str_with_error_msg(const std::string &msg) {
 void process_request(std::shared_ptr<HttpServer::Response> &response,
                      const std::shared_ptr<HttpServer::Request> &request,
                      const std::function<std::string(const std::string &)> &process) {
+    // pin the thread serving the request to a NUMA node on its first request
+    if (get_numa_pinning()) {
+        static thread_local bool pinned = pin_thread_to_next_numa_node();
+        std::ignore = pinned;
+    }
+
+    static auto &num_requests = common::get_counter("metagraph_requests_total",
+                                                    "Number of requests processed");
+    static auto &num_errors = common::get_counter("metagraph_request_errors_total",
+                                                  "Number of requests failed");
+    num_requests.add();
+
     // Retrieve string:
     std::string content = request->content.string();
     logger->info("[Server] {} request from {}", request->path,
@@ -110,15 +128,121 @@ void process_request(std::shared_ptr<HttpServer::Response> &response,
         write_response(SimpleWeb::StatusCode::success_ok, ret, response,
                        is_compression_requested(request));
     } catch (const std::exception &e) {
+        num_errors.add();
         logger->info("[Server] Error on request\n{}", e.what());
         response->write(SimpleWeb::StatusCode::client_error_bad_request,
                         json_str_with_error_msg(e.what()));
     } catch (...) {
+        num_errors.add();
         logger->info("[Server] Error on request");
         response->write(SimpleWeb::StatusCode::server_error_internal_server_error,
                         json_str_with_error_msg("Internal server error"));
     }
 }
 
+void process_streaming_request(std::shared_ptr<HttpServer::Response> &response,
+                               const std::shared_ptr<HttpServer::Request> &request,
+                               const std::function<void(const std::string &,
+                                                        const std::function<void(const std::string &)> &)> &process) {
+    // pin the thread serving the request to a NUMA node on its first request
+    if (get_numa_pinning()) {
+        static thread_local bool pinned = pin_thread_to_next_numa_node();
+        std::ignore = pinned;
+    }
+
+    static auto &num_requests = common::get_counter("metagraph_requests_total",
+                                                    "Number of requests processed");
+    static auto &num_errors = common::get_counter("metagraph_request_errors_total",
+                                                  "Number of requests failed");
+    num_requests.add();
+
+    std::string content = request->content.string();
+    logger->info("[Server] {} request from {}", request->path,
+                 request->remote_endpoint().address().to_string());
+
+    bool headers_sent = false;
+    bool connection_lost = false;
+    bool error_sent = false;
+
+    auto write_headers = [&]() {
+        SimpleWeb::CaseInsensitiveMultimap header;
+        header.emplace("Content-Type", "application/x-ndjson");
+        header.emplace("Transfer-Encoding", "chunked");
+        response->write(SimpleWeb::StatusCode::success_ok, header);
+        headers_sent = true;
+    };
+
+    auto write_chunk = [&](const std::string &chunk) {
+        if (chunk.empty())
+            return;
+
+        if (!headers_sent)
+            write_headers();
+
+        *response << std::hex << chunk.size() << std::dec << "\r\n" << chunk << "\r\n";
+
+        // wait until the chunk is sent to avoid buffering the whole response
+        std::promise<SimpleWeb::error_code> sent;
+        response->send([&sent](const SimpleWeb::error_code &ec) { sent.set_value(ec); });
+        if (SimpleWeb::error_code ec = sent.get_future().get()) {
+            connection_lost = true;
+            throw std::runtime_error("Connection lost: " + ec.message());
+        }
+    };
+
+    auto write_error = [&](SimpleWeb::StatusCode status, const std::string &msg) {
+        num_errors.add();
+        if (connection_lost)
+            return;
+
+        if (!headers_sent) {
+            response->write(status, json_str_with_error_msg(msg));
+            error_sent = true;
+            return;
+        }
+
+        Json::Value root;
+        root["error"] = msg;
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+        try {
+            write_chunk(Json::writeString(builder, root) + "\n");
+        } catch (...) {}
+    };
+
+    try {
+        process(content, write_chunk);
+    } catch (const std::exception &e) {
+        logger->info("[Server] Error on request\n{}", e.what());
+        write_error(SimpleWeb::StatusCode::client_error_bad_request, e.what());
+    } catch (...) {
+        logger->info("[Server] Error on request");
+        write_error(SimpleWeb::StatusCode::server_error_internal_server_error,
+                    "Internal server error");
+    }
+
+    if (connection_lost || error_sent)
+        return;
+
+    if (!headers_sent)
+        write_headers();
+
+    // the last chunk is sent when the response is released
+    *response << "0\r\n\r\n";
+}
+
+std::thread start_server(HttpServer &server_startup, Config &config) {
+    server_startup.config.thread_pool_size = std::max(1u, get_num_threads());
+
+    if (config.host_address != "") {
+        server_startup.config.address = config.host_address;
+    }
+    server_startup.config.port = config.port;
+
+    logger->info("[Server] Will listen on {} port {}", config.host_address,
+                 server_startup.config.port);
+    return std::thread([&server_startup]() { server_startup.start(); });
+}
+
 } // namespace cli
 } // namespace mtg
@@ -1,20 +1,45 @@
 #ifndef __METAGRAPH_SERVER_UTILS_HPP__
 #define __METAGRAPH_SERVER_UTILS_HPP__
 
+#include <string>
+#include <thread>
+
 #include <server_http.hpp>
 
 
 namespace mtg {
 namespace cli {
 
+class Config;
+
 using HttpServer = SimpleWeb::Server<SimpleWeb::HTTP>;
 
+const std::string SEQ_DESCRIPTION_JSON_FIELD = "seq_description";
+const std::string SCORE_JSON_FIELD = "score";
+const std::string SEQUENCE_JSON_FIELD = "sequence";
+const std::string ALIGNMENT_JSON_FIELD = "alignments";
+const std::string CIGAR_JSON_FIELD = "cigar";
+
 void process_request(std::shared_ptr<HttpServer::Response> &response,
                      const std::shared_ptr<HttpServer::Request> &request,
                      const std::function<std::string(const std::string &)> &process);
 
+/**
+ * Same as process_request, but |process| writes the response as NDJSON in
+ * chunks passed to its callback, each sent to the client before it returns.
+ * The headers are sent with the first chunk, so the errors thrown before are
+ * reported with the status code, and the ones after as the last line.
+ */
+void process_streaming_request(std::shared_ptr<HttpServer::Response> &response,
+                               const std::shared_ptr<HttpServer::Request> &request,
+                               const std::function<void(const std::string &,
+                                                        const std::function<void(const std::string &)> &)> &process);
+
 Json::Value parse_json_string(const std::string &msg);
 
+// Start serving requests in a new thread
+std::thread start_server(HttpServer &server_startup, Config &config);
+
 } // namespace cli
 } // namespace mtg
 
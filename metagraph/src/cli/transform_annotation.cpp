@@ -8,8 +8,11 @@
 #include "annotation/representation/annotation_matrix/static_annotators_def.hpp"
 #include "annotation/binary_matrix/multi_brwt/clustering.hpp"
 #include "annotation/annotation_converters.hpp"
+#include "graph/representation/succinct/dbg_succinct.hpp"
+#include "graph/representation/succinct/boss.hpp"
 #include "config/config.hpp"
 #include "load/load_annotation.hpp"
+#include "load/load_graph.hpp"
 
 
 namespace mtg {
@@ -41,6 +44,61 @@ void convert(std::unique_ptr<AnnotatorFrom> annotator,
     target_annotator->serialize(config.outfbase);
 }
 
+/**
+ * Split the rows into |num_shards| ranges of (roughly) equal size.
+ * If |graph| is DBGSuccinct, the boundaries are moved forward to the ends of
+ * the BOSS node groups (the edges sharing the same source node), so that all
+ * outgoing edges of a BOSS node are annotated in the same shard.
+ */
+std::vector<uint64_t> get_row_shard_boundaries(uint64_t num_rows,
+                                               size_t num_shards,
+                                               const graph::DeBruijnGraph *graph) {
+    assert(num_shards);
+
+    const auto *dbg_succ = dynamic_cast<const graph::DBGSuccinct *>(graph);
+    if (graph && !dbg_succ)
+        logger->warn("Row shards are not aligned to BOSS nodes for non-succinct graphs");
+
+    if (dbg_succ && dbg_succ->max_index() != num_rows) {
+        logger->error("Graph and annotation are not compatible");
+        exit(1);
+    }
+
+    std::vector<uint64_t> boundaries { 0 };
+
+    for (size_t s = 1; s < num_shards; ++s) {
+        uint64_t row = num_rows * s / num_shards;
+
+        if (dbg_succ && row < num_rows) {
+            const auto &boss = dbg_succ->get_boss();
+            // row i corresponds to node i + 1
+            uint64_t edge = dbg_succ->kmer_to_boss_index(row + 1);
+            // move to the first edge of the next BOSS node
+            if (edge > 1 && !boss.get_last(edge - 1)) {
+                while (!boss.get_last(edge)) {
+                    ++edge;
+                }
+                ++edge;
+            }
+            // skip the edges masked out in the graph
+            while (edge <= boss.num_edges()
+                    && dbg_succ->boss_to_kmer_index(edge) == graph::DeBruijnGraph::npos) {
+                ++edge;
+            }
+            row = edge <= boss.num_edges()
+                    ? dbg_succ->boss_to_kmer_index(edge) - 1
+                    : num_rows;
+        }
+
+        if (row > boundaries.back() && row < num_rows)
+            boundaries.push_back(row);
+    }
+
+    boundaries.push_back(num_rows);
+
+    return boundaries;
+}
+
 int transform_annotation(Config *config) {
     assert(config);
 
@@ -164,6 +222,41 @@ int transform_annotation(Config *config) {
         return 0;
     }
 
+    /********************************************************/
+    /*************** split into row shards ******************/
+    /********************************************************/
+
+    if (config->num_row_shards) {
+        if (input_anno_type != Config::ColumnCompressed) {
+            logger->error("Only ColumnCompressed annotations can be split into row shards");
+            exit(1);
+        }
+
+        auto annotation = std::make_unique<ColumnCompressed<>>(0, config->num_columns_cached);
+
+        logger->trace("Loading annotation...");
+        if (!annotation->merge_load(files)) {
+            logger->error("Cannot load annotations");
+            exit(1);
+        }
+        logger->trace("Annotation loaded in {} sec", timer.elapsed());
+
+        std::shared_ptr<graph::DeBruijnGraph> graph;
+        if (config->infbase.size())
+            graph = load_critical_dbg(config->infbase);
+
+        auto boundaries = get_row_shard_boundaries(annotation->num_objects(),
+                                                   config->num_row_shards,
+                                                   graph.get());
+        graph.reset();
+
+        logger->trace("Splitting annotation into {} row shards...", boundaries.size() - 1);
+        split_by_rows(*annotation, boundaries, config->outfbase, get_num_threads());
+        logger->trace("Splitting done in {} sec", timer.elapsed());
+
+        return 0;
+    }
+
     /********************************************************/
     /****************** convert annotation ******************/
     /********************************************************/
@@ -390,7 +483,10 @@ int transform_annotation(Config *config) {
             case Config::RowDiff: {
                 auto out_dir = std::filesystem::path(config->outfbase).remove_filename();
                 convert_to_row_diff(files, config->infbase, config->memory_available * 1e9,
-                                    config->max_path_length, out_dir, config->optimize);
+                                    config->max_path_length, out_dir, config->optimize,
+                                    config->row_diff_query_files,
+                                    config->max_query_path_length,
+                                    config->max_extra_anchors);
                 break;
             }
             case Config::RowCompressed: {
@@ -573,12 +669,13 @@ int merge_annotation(Config *config) {
     const auto &files = config->fnames;
 
     if (config->anno_type == Config::ColumnCompressed) {
-        ColumnCompressed<> annotation(0, config->num_columns_cached);
-        if (!annotation.merge_load(files)) {
-            logger->error("Cannot load annotations");
+        // merge columns in groups without loading all annotations in memory
+        if (!ColumnCompressed<>::merge_serialize(files, config->outfbase,
+                                                 config->memory_available * 1e9,
+                                                 get_num_threads())) {
+            logger->error("Cannot merge annotations");
             exit(1);
         }
-        annotation.serialize(config->outfbase);
         return 0;
     }
 
@@ -6,6 +6,8 @@
 #include "common/unix_tools.hpp"
 #include "common/threads/threading.hpp"
 #include "graph/representation/succinct/dbg_succinct.hpp"
+#include "graph/representation/succinct/interleaved_edges.hpp"
+#include "graph/graph_extensions/minimizer_index.hpp"
 #include "config/config.hpp"
 #include "load/load_graph.hpp"
 
@@ -37,6 +39,26 @@ int transform_graph(Config *config) {
 
     logger->trace("Graph loaded in {} sec", timer.elapsed());
 
+    if (config->minimizer_length) {
+        logger->trace("Index k-mers starting with their minimizer of length {}...",
+                      config->minimizer_length);
+        timer.reset();
+
+        graph::MinimizerIndex minimizer_index(*graph, config->minimizer_length,
+                                              get_num_threads());
+
+        logger->trace("Indexed {} out of {} k-mers in {} sec",
+                      minimizer_index.num_sampled_kmers(), graph->num_nodes(),
+                      timer.elapsed());
+
+        minimizer_index.serialize(
+            utils::remove_suffix(config->outfbase, graph->file_extension())
+                + graph->file_extension()
+        );
+
+        return 0;
+    }
+
     auto dbg_succ = std::dynamic_pointer_cast<graph::DBGSuccinct>(graph);
 
     if (!dbg_succ.get())
@@ -127,6 +149,16 @@ int transform_graph(Config *config) {
         return 0;
     }
 
+    if ((config->state == graph::boss::BOSS::State::OCC
+                && dbg_succ->get_boss().get_W().logsigma() > occ_table_vector::kMaxLogSigma)
+            || (config->state == graph::boss::BOSS::State::INTERLEAVED
+                && dbg_succ->get_boss().get_W().logsigma()
+                        > graph::boss::InterleavedEdges::kMaxLogSigma)) {
+        logger->error("The alphabet is too large for state {}",
+                      Config::state_to_string(config->state));
+        exit(1);
+    }
+
     logger->trace("Converting graph to state {}",
                   Config::state_to_string(config->state));
     timer.reset();
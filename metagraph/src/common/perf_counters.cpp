@@ -0,0 +1,123 @@
+#include "perf_counters.hpp"
+
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace mtg {
+namespace common {
+
+void LatencyHistogram::observe(double seconds) {
+    for (size_t i = 0; i < kBuckets.size(); ++i) {
+        if (seconds <= kBuckets[i]) {
+            bucket_counts_[i].fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(seconds * 1e9, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::cumulative_count(size_t i) const {
+    uint64_t count = 0;
+    for (size_t j = 0; j <= i && j < kBuckets.size(); ++j) {
+        count += bucket_counts_[j].load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+
+// The registered counters are never removed, so the references
+// returned remain valid until the program exits.
+class PerfCounterRegistry {
+  public:
+    template <class T>
+    T& get(std::deque<std::pair<std::string, std::unique_ptr<T>>> &entries,
+           const std::string &name, const std::string &help) {
+        std::lock_guard<std::mutex> lock(mu_);
+        for (const auto &[entry_name, entry] : entries) {
+            if (entry_name == name)
+                return *entry;
+        }
+        if (!help_.emplace(name, help).second)
+            throw std::runtime_error("Counter " + name + " registered with another type");
+
+        entries.emplace_back(name, std::make_unique<T>());
+        return *entries.back().second;
+    }
+
+    std::string render() {
+        std::lock_guard<std::mutex> lock(mu_);
+
+        std::ostringstream out;
+        out.precision(9);
+
+        for (const auto &[name, counter] : counters_) {
+            out << "# HELP " << name << " " << help_.at(name) << "\n"
+                << "# TYPE " << name << " counter\n"
+                << name << " " << counter->get() << "\n";
+        }
+
+        for (const auto &[name, histogram] : histograms_) {
+            out << "# HELP " << name << " " << help_.at(name) << "\n"
+                << "# TYPE " << name << " histogram\n";
+            for (size_t i = 0; i < LatencyHistogram::kBuckets.size(); ++i) {
+                out << name << "_bucket{le=\"" << LatencyHistogram::kBuckets[i] << "\"} "
+                    << histogram->cumulative_count(i) << "\n";
+            }
+            out << name << "_bucket{le=\"+Inf\"} " << histogram->count() << "\n"
+                << name << "_sum " << histogram->sum() << "\n"
+                << name << "_count " << histogram->count() << "\n";
+        }
+
+        return out.str();
+    }
+
+    std::deque<std::pair<std::string, std::unique_ptr<Counter>>> counters_;
+    std::deque<std::pair<std::string, std::unique_ptr<LatencyHistogram>>> histograms_;
+
+  private:
+    std::mutex mu_;
+    std::map<std::string, std::string> help_;
+};
+
+PerfCounterRegistry& get_registry() {
+    static PerfCounterRegistry registry;
+    return registry;
+}
+
+Counter& get_counter(const std::string &name, const std::string &help) {
+    auto &registry = get_registry();
+    return registry.get(registry.counters_, name, help);
+}
+
+LatencyHistogram& get_histogram(const std::string &name, const std::string &help) {
+    auto &registry = get_registry();
+    return registry.get(registry.histograms_, name, help);
+}
+
+std::string render_perf_counters() {
+    return get_registry().render();
+}
+
+bool dump_perf_counters(const std::string &filename) {
+    const std::string metrics = render_perf_counters();
+
+    if (filename == "-")
+        return std::fwrite(metrics.data(), 1, metrics.size(), stderr) == metrics.size();
+
+    std::FILE *out = std::fopen(filename.c_str(), "w");
+    if (!out)
+        return false;
+
+    bool good = std::fwrite(metrics.data(), 1, metrics.size(), out) == metrics.size();
+    return !std::fclose(out) && good;
+}
+
+} // namespace common
+} // namespace mtg
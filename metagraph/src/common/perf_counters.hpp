@@ -0,0 +1,84 @@
+#ifndef __PERF_COUNTERS_HPP__
+#define __PERF_COUNTERS_HPP__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+
+namespace mtg {
+namespace common {
+
+/**
+ * Lightweight performance counters exposed in the Prometheus text format.
+ *
+ * The counters are registered once in a global registry (typically, by
+ * initializing a function-local static reference) and are then updated
+ * lock-free from any thread.
+ *
+ *   static auto &latency = get_histogram("metagraph_stage_seconds", "Stage latency");
+ *   ScopedLatency timer(latency);
+ */
+
+class Counter {
+  public:
+    void add(uint64_t value = 1) { value_.fetch_add(value, std::memory_order_relaxed); }
+    uint64_t get() const { return value_.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<uint64_t> value_ = 0;
+};
+
+// A histogram of latencies in seconds with exponential buckets
+class LatencyHistogram {
+  public:
+    // upper bounds of the buckets, in seconds
+    static constexpr std::array<double, 8> kBuckets
+        = { 1e-4, 1e-3, 1e-2, 0.1, 1, 10, 100, 1000 };
+
+    void observe(double seconds);
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    double sum() const { return sum_ns_.load(std::memory_order_relaxed) * 1e-9; }
+    // number of observations not exceeding kBuckets[i]
+    uint64_t cumulative_count(size_t i) const;
+
+  private:
+    std::array<std::atomic<uint64_t>, kBuckets.size()> bucket_counts_ {};
+    std::atomic<uint64_t> count_ = 0;
+    std::atomic<uint64_t> sum_ns_ = 0;
+};
+
+// Register a new counter or return the existing one with the same name
+Counter& get_counter(const std::string &name, const std::string &help);
+LatencyHistogram& get_histogram(const std::string &name, const std::string &help);
+
+// Render all registered counters in the Prometheus text exposition format
+std::string render_perf_counters();
+
+// Write the rendered counters to a file ("-" for stderr). Return false on failure.
+bool dump_perf_counters(const std::string &filename);
+
+
+// Record the time elapsed between construction and destruction
+class ScopedLatency {
+  public:
+    explicit ScopedLatency(LatencyHistogram &histogram)
+          : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+    ~ScopedLatency() {
+        histogram_.observe(std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start_
+        ).count());
+    }
+
+  private:
+    LatencyHistogram &histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace common
+} // namespace mtg
+
+#endif // __PERF_COUNTERS_HPP__
@@ -0,0 +1,135 @@
+#include "numa.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+
+#include <omp.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+// see linux/mempolicy.h
+const int kMemPolicyDefault = 0;
+const int kMemPolicyInterleave = 3;
+#endif
+
+const std::string kNumaNodesDir = "/sys/devices/system/node/";
+
+
+std::vector<int> parse_cpu_list(const std::string &list) {
+    std::vector<int> result;
+
+    std::istringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        if (range.empty() || range == "\n")
+            continue;
+
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int i = first; i <= last; ++i) {
+                result.push_back(i);
+            }
+        } catch (...) {
+            return {};
+        }
+    }
+
+    return result;
+}
+
+std::string read_line(const std::string &filename) {
+    std::ifstream in(filename);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+const std::vector<int>& get_numa_nodes() {
+    static const std::vector<int> nodes = []() {
+        auto nodes = parse_cpu_list(read_line(kNumaNodesDir + "online"));
+        return nodes.size() ? nodes : std::vector<int>(1, 0);
+    }();
+    return nodes;
+}
+
+const std::vector<int>& get_numa_node_cpus(size_t i) {
+    static const std::vector<std::vector<int>> node_cpus = []() {
+        std::vector<std::vector<int>> node_cpus;
+        for (int node : get_numa_nodes()) {
+            node_cpus.push_back(parse_cpu_list(
+                read_line(kNumaNodesDir + "node" + std::to_string(node) + "/cpulist")
+            ));
+        }
+        return node_cpus;
+    }();
+    return node_cpus.at(i % node_cpus.size());
+}
+
+bool set_numa_interleave(bool interleave) {
+#if defined(__linux__)
+    if (get_num_numa_nodes() <= 1)
+        return false;
+
+    constexpr size_t kBits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(get_numa_nodes().back() / kBits + 1, 0);
+    for (int node : get_numa_nodes()) {
+        mask[node / kBits] |= 1ul << (node % kBits);
+    }
+
+    if (!interleave)
+        return !syscall(SYS_set_mempolicy, kMemPolicyDefault, NULL, 0);
+
+    return !syscall(SYS_set_mempolicy, kMemPolicyInterleave,
+                    mask.data(), mask.size() * kBits + 1);
+#else
+    std::ignore = interleave;
+    return false;
+#endif
+}
+
+bool pin_thread_to_numa_node(size_t i) {
+#if defined(__linux__)
+    const auto &cpus = get_numa_node_cpus(i);
+    if (get_num_numa_nodes() <= 1 || cpus.empty())
+        return false;
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &cpu_set);
+    }
+    // pid 0 refers to the calling thread
+    return !sched_setaffinity(0, sizeof(cpu_set), &cpu_set);
+#else
+    std::ignore = i;
+    return false;
+#endif
+}
+
+bool pin_thread_to_next_numa_node() {
+    static std::atomic<size_t> next_node = 0;
+    return pin_thread_to_numa_node(next_node++);
+}
+
+bool pin_omp_threads_to_numa_nodes(size_t num_threads) {
+    if (get_num_numa_nodes() <= 1)
+        return false;
+
+    std::atomic<bool> pinned = true;
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        size_t node = omp_get_thread_num() * get_num_numa_nodes() / omp_get_num_threads();
+        if (!pin_thread_to_numa_node(node))
+            pinned = false;
+    }
+
+    return pinned;
+}
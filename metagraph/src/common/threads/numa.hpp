@@ -0,0 +1,48 @@
+#ifndef __NUMA_HPP__
+#define __NUMA_HPP__
+
+#include <string>
+#include <vector>
+
+
+/**
+ * Helpers for NUMA-aware execution on Linux. On other systems, or if the
+ * NUMA topology can't be determined, a single node is assumed and the
+ * functions returning bool do nothing and return false.
+ */
+
+// Parse a list in the format of '/sys/devices/system/node/online',
+// e.g., "0-3,8,10-11"
+std::vector<int> parse_cpu_list(const std::string &list);
+
+// Return the list of the online NUMA nodes
+const std::vector<int>& get_numa_nodes();
+
+inline size_t get_num_numa_nodes() { return get_numa_nodes().size(); }
+
+// Return the CPUs of the |i|-th online NUMA node
+const std::vector<int>& get_numa_node_cpus(size_t i);
+
+/**
+ * If |interleave| is true, the memory pages allocated by the calling thread
+ * are interleaved across all NUMA nodes. Otherwise, the default (local)
+ * allocation policy is restored.
+ */
+bool set_numa_interleave(bool interleave);
+
+// Pin the calling thread to the CPUs of the |i|-th online NUMA node
+bool pin_thread_to_numa_node(size_t i);
+
+// Pin the calling thread to the NUMA nodes in a round-robin fashion
+bool pin_thread_to_next_numa_node();
+
+/**
+ * Pin the OpenMP threads of teams of size |num_threads| started by the calling
+ * thread, assigning consecutive thread numbers to the same NUMA node.
+ * The OpenMP runtime keeps the threads of a team for later parallel regions,
+ * so the pinning persists. The threads of teams started by other threads
+ * inherit the affinity of their master thread (e.g., a pinned pool worker).
+ */
+bool pin_omp_threads_to_numa_nodes(size_t num_threads);
+
+#endif // __NUMA_HPP__
@@ -2,17 +2,34 @@
 
 #include <cassert>
 
+#include "numa.hpp"
+
 static unsigned int NUM_THREADS_METAGRAPH_GLOBAL = 1;
+static bool NUMA_PINNING_METAGRAPH_GLOBAL = false;
 
 
 void set_num_threads(unsigned int num_threads) {
     NUM_THREADS_METAGRAPH_GLOBAL = std::max(1u, num_threads);
+
+    if (NUMA_PINNING_METAGRAPH_GLOBAL)
+        pin_omp_threads_to_numa_nodes(NUM_THREADS_METAGRAPH_GLOBAL);
 }
 
 unsigned int get_num_threads() {
     return NUM_THREADS_METAGRAPH_GLOBAL;
 }
 
+void set_numa_pinning(bool pin_threads) {
+    NUMA_PINNING_METAGRAPH_GLOBAL = pin_threads;
+
+    if (pin_threads)
+        pin_omp_threads_to_numa_nodes(NUM_THREADS_METAGRAPH_GLOBAL);
+}
+
+bool get_numa_pinning() {
+    return NUMA_PINNING_METAGRAPH_GLOBAL;
+}
+
 
 ThreadPool::ThreadPool(size_t num_workers, size_t max_num_tasks)
       : max_num_tasks_(std::max(max_num_tasks, size_t(1))), stop_(false) {
@@ -59,8 +76,13 @@ void ThreadPool::initialize(size_t num_workers) {
     if (!num_workers)
         return;
 
+    const bool pin_threads = get_numa_pinning();
+
     for (size_t i = 0; i < num_workers; ++i) {
-        workers.emplace_back([this]() {
+        workers.emplace_back([this,pin_threads]() {
+            if (pin_threads)
+                pin_thread_to_next_numa_node();
+
             while (true) {
                 std::function<void()> task;
                 {
@@ -14,6 +14,12 @@
 void set_num_threads(unsigned int num_threads);
 unsigned int get_num_threads();
 
+// If set, the workers of the thread pools created afterwards are pinned
+// to the NUMA nodes in a round-robin fashion and the OpenMP threads used
+// with get_num_threads() are pinned in blocks per NUMA node (see numa.hpp)
+void set_numa_pinning(bool pin_threads);
+bool get_numa_pinning();
+
 
 /**
  * A Thread Pool for parallel execution of tasks with arbitrary parameters
@@ -0,0 +1,111 @@
+#ifndef __SLOT_BLOCK_HPP__
+#define __SLOT_BLOCK_HPP__
+
+#include <cassert>
+#include <cstdint>
+
+#include <sdsl/bits.hpp>
+
+
+/**
+ * Operations on a block of |num_words| words storing symbols of up to 4 bits
+ * in 4-bit slots, the slot j of word w storing the symbol at position
+ * w * 16 + j. The occurrences of a symbol in a word are found with
+ * in-register parallel comparisons of all its slots.
+ */
+template <size_t num_words>
+struct slot_block {
+    static constexpr size_t kBitsPerSlot = 4;
+    static constexpr size_t kSlotsPerWord = 64 / kBitsPerSlot;
+    static constexpr size_t kSize = kSlotsPerWord * num_words;
+    static constexpr uint64_t kSlotMask = (1llu << kBitsPerSlot) - 1;
+
+    // lowest bits of every slot
+    static constexpr uint64_t kSlotLowBits = 0x1111111111111111llu;
+
+    // mark every slot of |word| storing |c| with its lowest bit
+    static uint64_t match(uint64_t word, uint64_t c) {
+        uint64_t diff = word ^ (c * kSlotLowBits);
+        diff |= diff >> 1;
+        diff |= diff >> 2;
+        return ~diff & kSlotLowBits;
+    }
+
+    static uint64_t get(const uint64_t *words, size_t i) {
+        assert(i < kSize);
+        return (words[i / kSlotsPerWord] >> (i % kSlotsPerWord * kBitsPerSlot)) & kSlotMask;
+    }
+
+    // the slot must be empty
+    static void set(uint64_t *words, size_t i, uint64_t c) {
+        assert(i < kSize);
+        assert(c <= kSlotMask);
+        assert(!get(words, i));
+        words[i / kSlotsPerWord] |= c << (i % kSlotsPerWord * kBitsPerSlot);
+    }
+
+    // get the number of occurrences of |c| among positions [0, i]
+    static uint64_t rank(const uint64_t *words, uint64_t c, size_t i) {
+        assert(i < kSize);
+
+        uint64_t rank = 0;
+        const size_t last_word = i / kSlotsPerWord;
+        for (size_t w = 0; w < last_word; ++w) {
+            rank += sdsl::bits::cnt(match(words[w], c));
+        }
+        // keep the slots [0, i] of the last word
+        const size_t shift = (kSlotsPerWord - 1 - i % kSlotsPerWord) * kBitsPerSlot;
+        return rank + sdsl::bits::cnt(match(words[last_word], c) << shift);
+    }
+
+    // get the position of the |r|-th occurrence of |c|, which must be in the block
+    static size_t select(const uint64_t *words, uint64_t c, uint64_t r) {
+        assert(r > 0);
+
+        for (size_t w = 0; w < num_words; ++w) {
+            uint64_t matches = match(words[w], c);
+            uint64_t num_matches = sdsl::bits::cnt(matches);
+            if (r <= num_matches)
+                return w * kSlotsPerWord + sdsl::bits::sel(matches, r) / kBitsPerSlot;
+
+            r -= num_matches;
+        }
+
+        assert(false && "the rank must be in the block");
+        return kSize;
+    }
+
+    // get the first position j >= i with symbol |c|, or kSize if there is none
+    static size_t next(const uint64_t *words, uint64_t c, size_t i) {
+        assert(i < kSize);
+
+        size_t w = i / kSlotsPerWord;
+        uint64_t matches = match(words[w], c)
+                            & (~0llu << (i % kSlotsPerWord * kBitsPerSlot));
+        while (!matches) {
+            if (++w == num_words)
+                return kSize;
+
+            matches = match(words[w], c);
+        }
+        return w * kSlotsPerWord + sdsl::bits::lo(matches) / kBitsPerSlot;
+    }
+
+    // get the last position j <= i with symbol |c|, or kSize if there is none
+    static size_t prev(const uint64_t *words, uint64_t c, size_t i) {
+        assert(i < kSize);
+
+        size_t w = i / kSlotsPerWord;
+        const size_t shift = (kSlotsPerWord - 1 - i % kSlotsPerWord) * kBitsPerSlot;
+        uint64_t matches = (match(words[w], c) << shift) >> shift;
+        while (!matches) {
+            if (w-- == 0)
+                return kSize;
+
+            matches = match(words[w], c);
+        }
+        return w * kSlotsPerWord + sdsl::bits::hi(matches) / kBitsPerSlot;
+    }
+};
+
+#endif // __SLOT_BLOCK_HPP__
@@ -1,6 +1,7 @@
 #include "wavelet_tree.hpp"
 
 #include <cassert>
+#include <stdexcept>
 
 #include "common/serialization.hpp"
 #include "common/utils/template_utils.hpp"
@@ -507,6 +508,184 @@ void partite_vector<t_bv>::clear() {
 }
 
 
+////////////////////////////////////////////////////////////////////
+// occ_table_vector with interleaved occurrence tables, immutable //
+////////////////////////////////////////////////////////////////////
+
+occ_table_vector::occ_table_vector(uint8_t logsigma, sdsl::int_vector<>&& vector)
+      : logsigma_(logsigma),
+        size_(vector.size()),
+        blocks_((vector.size() + kBlockSize - 1) / kBlockSize),
+        superblock_counts_(((blocks_.size() + kBlocksPerSuperblock - 1)
+                                / kBlocksPerSuperblock) * kSigma, 0),
+        count_(1 << logsigma, 0) {
+    if (logsigma > kMaxLogSigma) {
+        throw std::runtime_error("occ_table_vector supports alphabets of up to "
+                                 + std::to_string(kSigma) + " symbols");
+    }
+
+    std::vector<uint64_t> counts(kSigma, 0);
+    for (uint64_t b = 0; b < blocks_.size(); ++b) {
+        auto superblock = superblock_counts_.begin() + b / kBlocksPerSuperblock * kSigma;
+        if (b % kBlocksPerSuperblock == 0)
+            std::copy(counts.begin(), counts.end(), superblock);
+
+        Block &block = blocks_[b];
+        for (size_t c = 0; c < kSigma; ++c) {
+            assert(counts[c] - superblock[c] <= 0xFFFF);
+            block.counts[c] = counts[c] - superblock[c];
+        }
+
+        const uint64_t end = std::min((b + 1) * kBlockSize, size_);
+        for (uint64_t i = b * kBlockSize; i < end; ++i) {
+            TAlphabet c = vector[i];
+            assert(c < count_.size());
+            Symbols::set(block.words, i % kBlockSize, c);
+            counts[c]++;
+        }
+    }
+
+    std::copy(counts.begin(), counts.begin() + count_.size(), count_.begin());
+}
+
+uint64_t occ_table_vector::rank(TAlphabet c, uint64_t i) const {
+    assert(c < (1llu << logsigma()));
+
+    if (!size_)
+        return 0;
+
+    i = std::min(i, size_ - 1);
+    const Block &block = blocks_[i / kBlockSize];
+    return superblock_counts_[i / kBlockSize / kBlocksPerSuperblock * kSigma + c]
+            + block.counts[c] + Symbols::rank(block.words, c, i % kBlockSize);
+}
+
+uint64_t occ_table_vector::select(TAlphabet c, uint64_t i) const {
+    assert(i > 0 && size() > 0);
+    assert(i <= rank(c, size() - 1));
+    assert(c < (1llu << logsigma()));
+
+    // find the last superblock with fewer than |i| occurrences before it
+    const uint64_t num_superblocks = superblock_counts_.size() / kSigma;
+    uint64_t lo = 0;
+    uint64_t hi = num_superblocks;
+    while (hi - lo > 1) {
+        uint64_t mid = (lo + hi) / 2;
+        if (superblock_counts_[mid * kSigma + c] < i) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    i -= superblock_counts_[lo * kSigma + c];
+
+    // find the last block in the superblock with fewer than |i| occurrences before it
+    hi = std::min((lo + 1) * kBlocksPerSuperblock, blocks_.size());
+    lo = lo * kBlocksPerSuperblock;
+    while (hi - lo > 1) {
+        uint64_t mid = (lo + hi) / 2;
+        if (blocks_[mid].counts[c] < i) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    const Block &block = blocks_[lo];
+    return lo * kBlockSize + Symbols::select(block.words, c, i - block.counts[c]);
+}
+
+TAlphabet occ_table_vector::operator[](uint64_t i) const {
+    assert(i < size());
+    return Symbols::get(blocks_[i / kBlockSize].words, i % kBlockSize);
+}
+
+uint64_t occ_table_vector::next(uint64_t i, TAlphabet c) const {
+    assert(i < size());
+    assert(c < (1llu << logsigma()));
+
+    // check the rest of the current block first
+    size_t j = Symbols::next(blocks_[i / kBlockSize].words, c, i % kBlockSize);
+    if (j < kBlockSize) {
+        // the padding in the last block may match, so cap by size
+        return std::min(i / kBlockSize * kBlockSize + j, size_);
+    }
+
+    uint64_t rk = rank(c, i) + 1;
+    return rk <= count(c) ? select(c, rk) : size();
+}
+
+uint64_t occ_table_vector::prev(uint64_t i, TAlphabet c) const {
+    assert(i < size());
+    assert(c < (1llu << logsigma()));
+
+    // check the beginning of the current block first
+    size_t j = Symbols::prev(blocks_[i / kBlockSize].words, c, i % kBlockSize);
+    if (j < kBlockSize)
+        return i / kBlockSize * kBlockSize + j;
+
+    uint64_t rk = rank(c, i);
+    return rk ? select(c, rk) : size();
+}
+
+sdsl::int_vector<> occ_table_vector::to_vector() const {
+    sdsl::int_vector<> vector(size_, 0, logsigma_);
+    for (uint64_t i = 0; i < size_; ++i) {
+        vector[i] = (*this)[i];
+    }
+    return vector;
+}
+
+void occ_table_vector::serialize(std::ostream &out) const {
+    serialize_number(out, logsigma_);
+    serialize_number(out, size_);
+    serialize_number_vector_raw(out, superblock_counts_);
+    out.write(reinterpret_cast<const char *>(blocks_.data()),
+              blocks_.size() * sizeof(Block));
+}
+
+bool occ_table_vector::load(std::istream &in) {
+    if (!in.good())
+        return false;
+
+    try {
+        logsigma_ = load_number(in);
+        size_ = load_number(in);
+        superblock_counts_ = load_number_vector_raw<uint64_t>(in);
+
+        blocks_.resize((size_ + kBlockSize - 1) / kBlockSize);
+        if (logsigma_ > kMaxLogSigma
+                || superblock_counts_.size() != (blocks_.size() + kBlocksPerSuperblock - 1)
+                                                    / kBlocksPerSuperblock * kSigma)
+            return false;
+
+        in.read(reinterpret_cast<char *>(blocks_.data()), blocks_.size() * sizeof(Block));
+        if (!in.good())
+            return false;
+
+        count_.resize(1 << logsigma_);
+        for (TAlphabet c = 0; c < count_.size(); ++c) {
+            count_[c] = rank(c, size_);
+        }
+
+        return true;
+
+    } catch (const std::bad_alloc &exception) {
+        std::cerr << "ERROR: Not enough memory to load occ_table_vector." << std::endl;
+        return false;
+    } catch (...) {
+        return false;
+    }
+}
+
+void occ_table_vector::clear() {
+    size_ = 0;
+    blocks_.clear();
+    superblock_counts_.clear();
+    count_.assign(count_.size(), 0);
+}
+
+
 template wavelet_tree_dyn wavelet_tree::convert_to<wavelet_tree_dyn>();
 
 #define INSTANTIATE_WT(wt) \
@@ -518,3 +697,5 @@ INSTANTIATE_WT(wavelet_tree_sdsl<sdsl::wt_huff<>>);
 INSTANTIATE_WT(wavelet_tree_sdsl<sdsl::wt_huff<sdsl::rrr_vector<63>>>);
 
 INSTANTIATE_WT(partite_vector<bit_vector_stat>);
+
+template occ_table_vector wavelet_tree::convert_to<occ_table_vector>();
@@ -8,6 +8,7 @@
 #include <dynamic.hpp>
 
 #include "bit_vector_sdsl.hpp"
+#include "slot_block.hpp"
 
 
 class wavelet_tree {
@@ -218,10 +219,76 @@ class wavelet_tree_sdsl : public wavelet_tree {
 };
 
 
+/**
+ * An immutable vector over a small alphabet (at most 16 symbols) with
+ * FM-index style occurrence tables interleaved with the data.
+ * Every cache line stores 64 symbols packed in 4-bit slots next to the
+ * occurrence counts of all symbols before the block (relative to the
+ * superblock), so rank is answered with a single cache line access and
+ * in-register parallel comparisons of the packed symbols.
+ */
+class occ_table_vector : public wavelet_tree {
+  public:
+    static constexpr uint8_t kMaxLogSigma = 4;
+
+    explicit occ_table_vector(uint8_t logsigma)
+      : occ_table_vector(logsigma, sdsl::int_vector<>()) {}
+
+    template <class Vector>
+    occ_table_vector(uint8_t logsigma, const Vector &vector)
+      : occ_table_vector(logsigma, pack_vector(vector, logsigma)) {}
+
+    occ_table_vector(uint8_t logsigma, sdsl::int_vector<>&& vector);
+
+    uint64_t rank(TAlphabet c, uint64_t i) const;
+    uint64_t select(TAlphabet c, uint64_t i) const;
+    TAlphabet operator[](uint64_t i) const;
+
+    uint64_t next(uint64_t i, TAlphabet c) const;
+    uint64_t prev(uint64_t i, TAlphabet c) const;
+
+    uint64_t size() const { return size_; }
+    uint8_t logsigma() const { return logsigma_; }
+    uint64_t count(TAlphabet c) const { return count_[c]; }
+
+    bool load(std::istream &in);
+    void serialize(std::ostream &out) const;
+
+    void clear();
+
+    sdsl::int_vector<> to_vector() const;
+
+  private:
+    static constexpr size_t kSigma = 1 << kMaxLogSigma;
+    static constexpr size_t kWordsPerBlock = 4;
+    typedef slot_block<kWordsPerBlock> Symbols;
+    static constexpr size_t kBlockSize = Symbols::kSize;
+    // must be small enough for the block counts to fit in uint16_t
+    static constexpr size_t kBlocksPerSuperblock = 1024;
+
+    struct alignas(64) Block {
+        // occurrences of each symbol in the superblock before this block
+        uint16_t counts[kSigma];
+        uint64_t words[kWordsPerBlock];
+    };
+    static_assert(sizeof(Block) == 64);
+    static_assert(kMaxLogSigma == Symbols::kBitsPerSlot);
+
+    uint8_t logsigma_;
+    uint64_t size_;
+    std::vector<Block> blocks_;
+    // occurrences of each symbol before every superblock
+    std::vector<uint64_t> superblock_counts_;
+    std::vector<uint64_t> count_;
+};
+
+
 typedef wavelet_tree_sdsl<> wavelet_tree_stat;
 
 typedef wavelet_tree_sdsl<sdsl::wt_huff<sdsl::rrr_vector<63>>> wavelet_tree_small;
 
 typedef partite_vector<> wavelet_tree_fast;
 
+typedef occ_table_vector wavelet_tree_occ;
+
 #endif // __WAVELET_TREE_HPP__
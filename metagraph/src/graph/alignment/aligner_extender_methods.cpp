@@ -4,6 +4,8 @@
 #include <immintrin.h>
 #endif
 
+#include <tsl/hopscotch_set.h>
+
 #include "common/logger.hpp"
 #include "common/utils/simd_utils.hpp"
 #include "common/aligned_vector.hpp"
@@ -874,6 +876,253 @@ void DefaultColumnExtender<NodeType>
 
 template class DefaultColumnExtender<>;
 
+
+template <typename NodeType>
+WavefrontExtender<NodeType>::WavefrontExtender(const DeBruijnGraph &graph,
+                                               const DBGAlignerConfig &config,
+                                               std::string_view query)
+      : graph_(graph), config_(config), query_(query),
+        partial_sums_(query.size() + 1, 0) {
+    assert(config_.check_config_scores());
+    std::transform(query_.begin(), query_.end(), partial_sums_.begin() + 1,
+                   [&](char c) { return config_.get_row(c)[c]; });
+
+    std::partial_sum(partial_sums_.begin(), partial_sums_.end(), partial_sums_.begin());
+    assert(config_.match_score(query_) == partial_sums_.back());
+}
+
+template <typename NodeType>
+void WavefrontExtender<NodeType>::initialize(const DBGAlignment &seed) {
+    // this extender only works if at least one character has been matched
+    assert(seed.get_query_end() > query_.data());
+    assert(query_.data() + query_.size() > seed.get_query_end());
+
+    size_t begin = seed.get_query_end() - query_.data();
+    extension_query_ = query_.substr(begin);
+    match_score_begin_ = partial_sums_.data() + begin;
+    seed_ = &seed;
+}
+
+template <typename NodeType>
+void WavefrontExtender<NodeType>::reset() {
+    states_.clear();
+    state_index_.clear();
+    wavefronts_.clear();
+}
+
+template <class State>
+inline std::pair<decltype(State::node), size_t> get_state_key(const State &state) {
+    // matches and mismatches are not distinguished
+    size_t op_class = state.op == Cigar::INSERTION ? 1 : (state.op == Cigar::DELETION ? 2 : 0);
+    return std::make_pair(state.node, state.pos * 3 + op_class);
+}
+
+template <typename NodeType>
+void WavefrontExtender<NodeType>::push_state(State&& state) {
+    score_t max_score = match_score_begin_[state.pos] - match_score_begin_[0];
+
+    // the penalty never decreases along a path
+    state.penalty = std::max(state.penalty,
+                             static_cast<size_t>(std::max(max_score - state.score, 0)));
+
+    auto key = get_state_key(state);
+    auto find = state_index_.find(key);
+    if (find != state_index_.end() && states_[find->second].score >= state.score)
+        return;
+
+    size_t index = states_.size();
+    if (find != state_index_.end()) {
+        find.value() = index;
+    } else {
+        state_index_.emplace(key, index);
+    }
+
+    if (state.penalty >= wavefronts_.size())
+        wavefronts_.resize(state.penalty + 1);
+
+    wavefronts_[state.penalty].push_back(index);
+    states_.emplace_back(std::move(state));
+}
+
+template <typename NodeType>
+void WavefrontExtender<NodeType>::operator()(ExtensionCallback callback,
+                                             score_t min_path_score) {
+    const auto &seed = get_seed();
+
+    if (!graph_.outdegree(seed.back())) {
+        callback(DBGAlignment(), NodeType());
+        return;
+    }
+
+    score_t max_extension_score = match_score_begin_[extension_query_.size()]
+                                    - match_score_begin_[0];
+
+    // stop path early if it can't be better than the min_path_score
+    if (seed.get_score() + max_extension_score < min_path_score)
+        return;
+
+    reset();
+
+    size_t max_num_states = std::numeric_limits<size_t>::max();
+    if (config_.max_nodes_per_seq_char < std::numeric_limits<double>::max()) {
+        max_num_states = std::ceil(config_.max_nodes_per_seq_char
+                                    * static_cast<double>(extension_query_.size() + 1));
+    }
+
+    // the seed end is the root of all partial alignments
+    push_state(State { seed.back(), 0, Cigar::MATCH, '\0', 0, 0, 0 });
+
+    size_t best_state = 0;
+    score_t best_score = 0;
+    std::vector<std::pair<NodeType, char>> outgoing;
+
+    for (size_t penalty = 0; penalty < wavefronts_.size()
+                                && states_.size() < max_num_states; ++penalty) {
+        // no state in this or any later wavefront can improve the best score
+        if (max_extension_score - static_cast<score_t>(penalty) <= best_score)
+            break;
+
+        // matches don't increase the penalty, so the wavefront can grow while
+        // it is being processed
+        for (size_t i = 0; i < wavefronts_[penalty].size()
+                                && states_.size() < max_num_states; ++i) {
+            size_t index = wavefronts_[penalty][i];
+            State state = states_[index];
+
+            // skip states which have been replaced by better ones
+            if (state_index_.find(get_state_key(state))->second != index)
+                continue;
+
+            if (state.score < best_score - config_.xdrop)
+                continue;
+
+            if (state.op == Cigar::MATCH && state.score > best_score) {
+                best_state = index;
+                best_score = state.score;
+            }
+
+            if (state.pos == extension_query_.size())
+                continue;
+
+            char q = extension_query_[state.pos];
+
+            outgoing.clear();
+            graph_.call_outgoing_kmers(state.node, [&](NodeType next, char c) {
+                if (c != boss::BOSS::kSentinel)
+                    outgoing.emplace_back(next, c);
+            });
+
+            for (const auto &[next, c] : outgoing) {
+                push_state(State { next, state.pos + 1, Cigar::get_op_row(c)[q], c,
+                                   state.score + config_.get_row(c)[q],
+                                   state.penalty, index });
+            }
+
+            // if the path doesn't branch and its next character matches,
+            // then follow the match without considering edits
+            if (outgoing.size() == 1 && outgoing[0].second == q)
+                continue;
+
+            if (state.op != Cigar::DELETION) {
+                push_state(State { state.node, state.pos + 1, Cigar::INSERTION, '\0',
+                                   state.score + (state.op == Cigar::INSERTION
+                                                    ? config_.gap_extension_penalty
+                                                    : config_.gap_opening_penalty),
+                                   state.penalty, index });
+            }
+
+            if (state.op != Cigar::INSERTION) {
+                for (const auto &[next, c] : outgoing) {
+                    push_state(State { next, state.pos, Cigar::DELETION, c,
+                                       state.score + (state.op == Cigar::DELETION
+                                                        ? config_.gap_extension_penalty
+                                                        : config_.gap_opening_penalty),
+                                       state.penalty, index });
+                }
+            }
+        }
+    }
+
+#ifndef NDEBUG
+    logger->trace("Extension completed:\tquery size:\t{}\tseed size:\t{}\texplored states:\t{}",
+                  query_.size(), seed.size(), states_.size());
+#endif
+
+    // no good path found
+    if (!best_state || seed.get_score() + best_score < min_path_score) {
+        reset();
+        callback(DBGAlignment(), NodeType());
+        return;
+    }
+
+    if (config_.num_alternative_paths == 1) {
+        callback(get_extension(best_state), seed.back());
+        return;
+    }
+
+    std::vector<size_t> ends;
+    for (size_t i = 1; i < states_.size(); ++i) {
+        if (states_[i].op == Cigar::MATCH && states_[i].score > 0
+                && seed.get_score() + states_[i].score >= min_path_score
+                && state_index_.find(get_state_key(states_[i]))->second == i)
+            ends.push_back(i);
+    }
+
+    std::stable_sort(ends.begin(), ends.end(), [&](size_t a, size_t b) {
+        return states_[a].score > states_[b].score;
+    });
+
+    // store visited nodes in paths to avoid returning subalignments
+    tsl::hopscotch_set<NodeType> visited_nodes;
+
+    size_t num_paths = 0;
+    for (size_t end : ends) {
+        if (num_paths >= config_.num_alternative_paths)
+            break;
+
+        if (visited_nodes.count(states_[end].node))
+            continue;
+
+        for (size_t i = end; i; i = states_[i].prev) {
+            visited_nodes.insert(states_[i].node);
+        }
+
+        callback(get_extension(end), seed.back());
+        ++num_paths;
+    }
+}
+
+template <typename NodeType>
+auto WavefrontExtender<NodeType>::get_extension(size_t state_index) const -> DBGAlignment {
+    assert(state_index && state_index < states_.size());
+
+    std::vector<size_t> path;
+    for (size_t i = state_index; i; i = states_[i].prev) {
+        path.push_back(i);
+    }
+
+    Cigar cigar;
+    std::vector<NodeType> nodes;
+    std::string sequence;
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        const State &state = states_[*it];
+        cigar.append(state.op);
+        if (state.op != Cigar::INSERTION) {
+            nodes.push_back(state.node);
+            sequence.push_back(state.c);
+        }
+    }
+
+    const State &end = states_[state_index];
+    return DBGAlignment(extension_query_.substr(0, end.pos),
+                        std::move(nodes), std::move(sequence), end.score,
+                        std::move(cigar), 0, get_seed().get_orientation(),
+                        graph_.get_k() - 1);
+}
+
+
+template class WavefrontExtender<>;
+
 } // namespace align
 } // namespace graph
 } // namespace mtg
@@ -165,6 +165,8 @@ class DBGAlignerConfig {
     size_t min_seed_length = 1;
     size_t max_seed_length = std::numeric_limits<size_t>::max();
     size_t max_num_seeds_per_locus = std::numeric_limits<size_t>::max();
+    // if non-zero, chain colinear seeds and extend only the top chains
+    size_t max_num_seed_chains = 0;
     // thresholds for scores
     score_t min_cell_score = 0;
     score_t min_path_score = 0;
@@ -178,6 +180,8 @@ class DBGAlignerConfig {
     int8_t gap_extension_penalty;
 
     bool forward_and_reverse_complement = false;
+    // extend seeds with WavefrontExtender instead of DefaultColumnExtender
+    bool wavefront_extension = false;
 
     bool alignment_edit_distance;
     int8_t alignment_match_score;
@@ -245,6 +249,24 @@ class Alignment {
               bool orientation = false,
               size_t offset = 0);
 
+    // Used for constructing alignments with a known CIGAR (excluding clipping)
+    Alignment(std::string_view query,
+              std::vector<NodeType>&& nodes,
+              std::string&& sequence,
+              score_t score,
+              Cigar&& cigar,
+              size_t clipping = 0,
+              bool orientation = false,
+              size_t offset = 0)
+          : query_begin_(query.data()),
+            query_end_(query.data() + query.size()),
+            nodes_(std::move(nodes)),
+            sequence_(std::move(sequence)),
+            score_(score),
+            cigar_(Cigar::CLIPPED, clipping),
+            orientation_(orientation),
+            offset_(offset) { cigar_.append(std::move(cigar)); }
+
     // TODO: construct multiple alignments from the same starting point
     Alignment(const DPTable<NodeType> &dp_table,
               const DBGAlignerConfig &config,
@@ -361,23 +383,6 @@ class Alignment {
     bool is_valid(const DeBruijnGraph &graph, const DBGAlignerConfig *config = nullptr) const;
 
   private:
-    Alignment(std::string_view query,
-              std::vector<NodeType>&& nodes = {},
-              std::string&& sequence = "",
-              score_t score = 0,
-              Cigar&& cigar = Cigar(),
-              size_t clipping = 0,
-              bool orientation = false,
-              size_t offset = 0)
-          : query_begin_(query.data()),
-            query_end_(query.data() + query.size()),
-            nodes_(std::move(nodes)),
-            sequence_(std::move(sequence)),
-            score_(score),
-            cigar_(Cigar::CLIPPED, clipping),
-            orientation_(orientation),
-            offset_(offset) { cigar_.append(std::move(cigar)); }
-
     Json::Value path_json(size_t node_size, std::string_view label = {}) const;
 
     const char* query_begin_;
@@ -8,6 +8,7 @@
 #include "aligner_helper.hpp"
 #include "common/utils/template_utils.hpp"
 #include "common/aligned_vector.hpp"
+#include "common/hashers/hash.hpp"
 #include "common/vectors/bitmap.hpp"
 
 
@@ -74,6 +75,32 @@ class ExactSeeder : public ISeeder<NodeType> {
     size_t num_matching_;
 };
 
+// Only the query k-mers sampled by the MinimizerIndex extension of the graph
+// are looked up, the other k-mers are mapped by traversing the graph from them.
+template <typename NodeType = typename DeBruijnGraph::node_index>
+class MinimizerSeeder : public ExactSeeder<NodeType> {
+  public:
+    typedef typename ISeeder<NodeType>::Seed Seed;
+
+    // |nodes| is ignored, the query k-mers are mapped using the minimizer index
+    MinimizerSeeder(const DeBruijnGraph &graph,
+                    std::string_view query,
+                    bool orientation,
+                    std::vector<NodeType>&& nodes,
+                    const DBGAlignerConfig &config)
+          : ExactSeeder<NodeType>(graph, query, orientation,
+                                  map_sampled_kmers(graph, query), config) {
+        std::ignore = nodes;
+    }
+
+    virtual ~MinimizerSeeder() {}
+
+    // Map the sampled query k-mers to the graph with the minimizer index and
+    // the k-mers around them by traversing the graph forwards and backwards.
+    static std::vector<NodeType> map_sampled_kmers(const DeBruijnGraph &graph,
+                                                   std::string_view query);
+};
+
 template <typename NodeType = typename DeBruijnGraph::node_index>
 class MEMSeeder : public ExactSeeder<NodeType> {
   public:
@@ -257,6 +284,83 @@ class DefaultColumnExtender : public IExtender<NodeType> {
     size_t max_num_nodes;
 };
 
+
+// Extends seeds by exploring partial alignments in order of increasing penalty,
+// where the penalty of a partial alignment is the score lost relative to an
+// exact match of the aligned query prefix. Exact matches do not increase the
+// penalty, so they are followed greedily within the same wavefront, and edits
+// are only considered at branching nodes and where a match fails. Thus, the
+// work scales with the penalty of the best extension rather than with the
+// product of the query length and the number of explored nodes. Restricting
+// the positions of edits may rarely miss the optimal extension.
+template <typename NodeType = typename DeBruijnGraph::node_index>
+class WavefrontExtender : public IExtender<NodeType> {
+  public:
+    typedef typename IExtender<NodeType>::DBGAlignment DBGAlignment;
+    typedef typename IExtender<NodeType>::node_index node_index;
+    typedef typename IExtender<NodeType>::score_t score_t;
+    typedef typename IExtender<NodeType>::ExtensionCallback ExtensionCallback;
+
+    WavefrontExtender(const DeBruijnGraph &graph,
+                      const DBGAlignerConfig &config,
+                      std::string_view query);
+
+    virtual ~WavefrontExtender() {}
+
+    virtual void
+    operator()(ExtensionCallback callback,
+               score_t min_path_score = std::numeric_limits<score_t>::min()) override;
+
+    virtual void initialize(const DBGAlignment &seed) override;
+
+  protected:
+    // a partial alignment ending in |node| after aligning |pos| characters
+    // of the query following the seed
+    struct State {
+        NodeType node;
+        size_t pos;
+        Cigar::Operator op;
+        char c;
+        score_t score;
+        size_t penalty;
+        size_t prev;
+    };
+
+    const DeBruijnGraph &graph_;
+    const DBGAlignerConfig &config_;
+    std::string_view query_;
+
+    virtual void reset() override;
+
+    virtual const DBGAlignment& get_seed() const override { return *seed_; }
+
+    // add a state unless a state with the same node, position, and operation
+    // class with at least the same score has already been added
+    void push_state(State&& state);
+
+    // reconstruct the extension ending in the given state
+    DBGAlignment get_extension(size_t state_index) const;
+
+  private:
+    // perfect match scores of all query prefixes
+    std::vector<score_t> partial_sums_;
+
+    // the initial seed
+    const DBGAlignment *seed_;
+
+    // the query suffix following the seed
+    std::string_view extension_query_;
+
+    // perfect match scores of the prefixes of |extension_query_|
+    const score_t *match_score_begin_;
+
+    std::vector<State> states_;
+    tsl::hopscotch_map<std::pair<NodeType, size_t>, size_t,
+                       utils::Hash<std::pair<NodeType, size_t>>> state_index_;
+    // wavefronts_[d] stores the indexes of the states with penalty d
+    std::vector<std::vector<size_t>> wavefronts_;
+};
+
 } // namespace align
 } // namespace graph
 } // namespace mtg
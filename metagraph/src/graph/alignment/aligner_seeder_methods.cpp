@@ -1,6 +1,7 @@
 #include "aligner_methods.hpp"
 
 #include "graph/representation/succinct/dbg_succinct.hpp"
+#include "graph/graph_extensions/minimizer_index.hpp"
 
 
 namespace mtg {
@@ -118,6 +119,50 @@ void SuffixSeeder<BaseSeeder>::call_seeds(std::function<void(Seed&&)> callback)
     }
 }
 
+template <typename NodeType>
+std::vector<NodeType> MinimizerSeeder<NodeType>
+::map_sampled_kmers(const DeBruijnGraph &graph, std::string_view query) {
+    auto minimizer_index = graph.get_extension<MinimizerIndex>();
+    if (!minimizer_index)
+        throw std::runtime_error("The graph has no minimizer index");
+
+    assert(minimizer_index->get_k() == graph.get_k());
+
+    size_t k = graph.get_k();
+    std::vector<NodeType> nodes(query.size() >= k ? query.size() - k + 1 : 0,
+                                DeBruijnGraph::npos);
+
+    minimizer_index->call_nodes(query, [&](size_t i, NodeType node) {
+        // different k-mers may have the same hash
+        if (!nodes[i] && graph.get_node_sequence(node) == query.substr(i, k))
+            nodes[i] = node;
+    });
+
+    // only about 1 / w of the k-mers are sampled, so map the k-mers around
+    // the sampled ones by traversing the graph from them. Otherwise, the
+    // unmapped k-mers would count as mismatches against min_exact_match.
+    std::vector<size_t> sampled;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i])
+            sampled.push_back(i);
+    }
+
+    for (size_t s : sampled) {
+        for (size_t i = s + 1; i < nodes.size() && !nodes[i]; ++i) {
+            nodes[i] = graph.traverse(nodes[i - 1], query[i + k - 1]);
+            if (nodes[i] == DeBruijnGraph::npos)
+                break;
+        }
+        for (size_t i = s; i > 0 && !nodes[i - 1]; --i) {
+            nodes[i - 1] = graph.traverse_back(nodes[i], query[i - 1]);
+            if (nodes[i - 1] == DeBruijnGraph::npos)
+                break;
+        }
+    }
+
+    return nodes;
+}
+
 template <typename NodeType>
 void MEMSeeder<NodeType>::call_seeds(std::function<void(Seed&&)> callback) const {
     size_t k = this->graph_.get_k();
@@ -184,6 +229,7 @@ void MEMSeeder<NodeType>::call_seeds(std::function<void(Seed&&)> callback) const
 
 
 template class ExactSeeder<>;
+template class MinimizerSeeder<>;
 template class MEMSeeder<>;
 template class UniMEMSeeder<>;
 template class SuffixSeeder<ExactSeeder<>>;
@@ -1,11 +1,62 @@
 #include "dbg_aligner.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 #include "aligner_aggregator.hpp"
 
 namespace mtg {
 namespace graph {
 namespace align {
 
+// the number of preceding seeds considered as chain predecessors of a seed
+constexpr size_t kMaxChainLookback = 32;
+// the maximum number of query characters between the ends of chained seeds
+constexpr size_t kMaxChainGap = 64;
+// the maximum difference between the query and the graph distance of chained seeds
+constexpr size_t kMaxChainIndel = 8;
+// the maximum number of graph nodes visited when looking for a chain link
+constexpr size_t kMaxChainSearchNodes = 256;
+
+// Return the number of forward traversal steps in [min_dist, max_dist]
+// connecting |source| to |target|, or max() if none was found
+template <typename NodeType>
+size_t get_chain_distance(const DeBruijnGraph &graph,
+                          NodeType source,
+                          NodeType target,
+                          size_t min_dist,
+                          size_t max_dist) {
+    std::vector<NodeType> level { source };
+    std::vector<NodeType> next_level;
+    size_t num_visited = 0;
+
+    for (size_t dist = 1; dist <= max_dist && level.size(); ++dist) {
+        next_level.clear();
+        for (NodeType node : level) {
+            graph.adjacent_outgoing_nodes(node, [&](NodeType next) {
+                next_level.push_back(next);
+            });
+        }
+
+        if (dist >= min_dist
+                && std::find(next_level.begin(), next_level.end(), target)
+                    != next_level.end())
+            return dist;
+
+        std::sort(next_level.begin(), next_level.end());
+        next_level.erase(std::unique(next_level.begin(), next_level.end()),
+                         next_level.end());
+
+        num_visited += next_level.size();
+        if (num_visited > kMaxChainSearchNodes)
+            break;
+
+        std::swap(level, next_level);
+    }
+
+    return std::numeric_limits<size_t>::max();
+}
+
 IDBGAligner::DBGQueryAlignment IDBGAligner::align(std::string_view query,
                                                   bool is_reverse_complement) const {
     DBGQueryAlignment result(query);
@@ -38,13 +89,26 @@ void SeedAndExtendAlignerCore<AlignmentCompare>
              const ISeeder<node_index> &seeder,
              IExtender<node_index>&& extender,
              const LocalAlignmentCallback &callback,
-             const MinScoreComputer &get_min_path_score) const {
+             const MinScoreComputer &get_min_path_score,
+             bool chain) const {
+    static auto &num_seeds = common::get_counter("metagraph_alignment_seeds_total",
+                                                 "Number of generated alignment seeds");
+    static auto &num_extended = common::get_counter("metagraph_alignment_seeds_extended_total",
+                                                    "Number of alignment seeds extended");
+
     std::vector<DBGAlignment> seeds;
     seeder.call_seeds([&](DBGAlignment&& seed) {
         assert(seed.is_valid(graph_, &config_));
         seeds.emplace_back(std::move(seed));
     });
 
+    num_seeds.add(seeds.size());
+
+    if (chain && config_.max_num_seed_chains && seeds.size() > 1)
+        seeds = chain_seeds(query, std::move(seeds));
+
+    num_extended.add(seeds.size());
+
     for (auto &seed : seeds) {
 #ifndef NDEBUG
         mtg::common::logger->trace("Seed: {}", seed);
@@ -115,6 +179,126 @@ void SeedAndExtendAlignerCore<AlignmentCompare>
     }
 }
 
+template <class AlignmentCompare>
+auto SeedAndExtendAlignerCore<AlignmentCompare>
+::chain_seeds(std::string_view query,
+              std::vector<DBGAlignment>&& seeds) const -> std::vector<DBGAlignment> {
+    // The last character of the i-th node of a seed is aligned to the query
+    // position end - size + i, so chained seeds lie on consistent diagonals
+    // if the graph distance between their nodes matches these positions.
+    auto get_end = [&](const DBGAlignment &seed) -> size_t {
+        return seed.get_query_end() - query.data();
+    };
+    auto get_front_end = [&](const DBGAlignment &seed) -> size_t {
+        return get_end(seed) - seed.size();
+    };
+
+    std::vector<size_t> order(seeds.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return std::make_pair(get_front_end(seeds[a]), get_end(seeds[a]))
+                < std::make_pair(get_front_end(seeds[b]), get_end(seeds[b]));
+    });
+
+    constexpr size_t npos = std::numeric_limits<size_t>::max();
+    std::vector<score_t> chain_scores(seeds.size());
+    std::vector<size_t> prev(seeds.size(), npos);
+    // set if there is a mismatch or an indel between the seed and its predecessor
+    std::vector<bool> after_gap(seeds.size(), false);
+
+    for (size_t j = 0; j < order.size(); ++j) {
+        const DBGAlignment &seed = seeds[order[j]];
+        size_t front_end = get_front_end(seed);
+        chain_scores[order[j]] = seed.get_score();
+
+        for (size_t i = j; i-- > 0 && j - i <= kMaxChainLookback; ) {
+            const DBGAlignment &pred = seeds[order[i]];
+            size_t pred_front_end = get_front_end(pred);
+            if (pred_front_end >= front_end || get_end(pred) >= get_end(seed))
+                continue;
+
+            // the number of traversal steps from the last node of pred
+            // to the first node of seed implied by the query positions
+            int64_t query_dist = int64_t(front_end) - (get_end(pred) - 1);
+            if (query_dist > static_cast<int64_t>(kMaxChainGap))
+                continue;
+
+            score_t gap_score = 0;
+            if (query_dist <= 0) {
+                // the seeds overlap on the query, so they must share a diagonal
+                if (pred[front_end - pred_front_end] != seed.front())
+                    continue;
+
+            } else {
+                size_t dist = get_chain_distance(
+                    graph_, pred.back(), seed.front(),
+                    std::max(int64_t(1), query_dist - int64_t(kMaxChainIndel)),
+                    query_dist + kMaxChainIndel
+                );
+                if (dist == npos)
+                    continue;
+
+                size_t indel = std::abs(int64_t(dist) - query_dist);
+                if (indel) {
+                    gap_score = config_.gap_opening_penalty
+                        + score_t(indel - 1) * config_.gap_extension_penalty;
+                }
+            }
+
+            size_t overlap_end = std::max(get_end(pred),
+                                          size_t(seed.get_query().data() - query.data()));
+            score_t score = chain_scores[order[i]] + gap_score + config_.match_score(
+                std::string_view(query.data() + overlap_end, get_end(seed) - overlap_end)
+            );
+
+            if (score > chain_scores[order[j]]) {
+                chain_scores[order[j]] = score;
+                prev[order[j]] = order[i];
+                after_gap[order[j]] = query_dist > 1 || gap_score;
+            }
+
+            // the closest perfectly consistent predecessor dominates the rest
+            if (query_dist <= 1 && !gap_score)
+                break;
+        }
+    }
+
+    // pick the top scoring chains greedily, skipping chains which end in
+    // seeds which have already been picked
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return chain_scores[a] > chain_scores[b];
+    });
+
+    std::vector<bool> used(seeds.size(), false);
+    std::vector<bool> extend(seeds.size(), false);
+    size_t num_chains = 0;
+    for (size_t i = 0; i < order.size() && num_chains < config_.max_num_seed_chains; ++i) {
+        if (used[order[i]])
+            continue;
+
+        for (size_t j = order[i]; j != npos && !used[j]; j = prev[j]) {
+            used[j] = true;
+            // extend the first seed of the chain and the seeds after gaps
+            extend[j] = prev[j] == npos || used[prev[j]] || after_gap[j];
+        }
+
+        ++num_chains;
+    }
+
+    std::vector<DBGAlignment> chained_seeds;
+    for (size_t i = 0; i < seeds.size(); ++i) {
+        if (extend[i])
+            chained_seeds.emplace_back(std::move(seeds[i]));
+    }
+
+#ifndef NDEBUG
+    mtg::common::logger->trace("Extending {} out of {} seeds in {} chains",
+                               chained_seeds.size(), seeds.size(), num_chains);
+#endif
+
+    return chained_seeds;
+}
+
 template <class AlignmentCompare>
 void SeedAndExtendAlignerCore<AlignmentCompare>
 ::align_one_direction(DBGQueryAlignment &paths,
@@ -241,7 +425,8 @@ void SeedAndExtendAlignerCore<AlignmentCompare>
                     assert(path.is_valid(graph_, &config_));
                     alignment_callback(std::move(path));
                 },
-                get_min_path_score
+                get_min_path_score,
+                false /* the seeds are already extended alignments */
             );
         });
     });
@@ -7,6 +7,7 @@
 #include "aligner_helper.hpp"
 #include "aligner_methods.hpp"
 #include "graph/representation/base/sequence_graph.hpp"
+#include "common/perf_counters.hpp"
 
 
 namespace mtg {
@@ -75,6 +76,16 @@ class DBGAligner : public ISeedAndExtendAligner {
     const DeBruijnGraph &graph_;
     DBGAlignerConfig config_;
     SeedAndExtendAlignerCore<AlignmentCompare> aligner_core_;
+
+    // Map the query k-mers to the graph, unless the seeder looks them up itself
+    std::vector<node_index> map_query(std::string_view query) const {
+        if constexpr(std::is_base_of_v<MinimizerSeeder<node_index>, Seeder>) {
+            std::ignore = query;
+            return {};
+        } else {
+            return map_sequence_to_nodes(graph_, query);
+        }
+    }
 };
 
 template <class AlignmentCompare>
@@ -131,12 +142,23 @@ class SeedAndExtendAlignerCore {
                                const AlignCoreGenerator &rev_comp_core_generator) const;
 
   protected:
-    // Generate seeds, then extend them
+    // Generate seeds, then extend them. If |chain| is set and
+    // config_.max_num_seed_chains is non-zero, only the seeds returned by
+    // chain_seeds are extended.
     void align_core(std::string_view query,
                     const ISeeder<node_index> &seeder,
                     IExtender<node_index>&& extender,
                     const LocalAlignmentCallback &callback,
-                    const MinScoreComputer &get_min_path_score) const;
+                    const MinScoreComputer &get_min_path_score,
+                    bool chain = true) const;
+
+    // Chain colinear seeds (increasing query positions consistent with
+    // paths in the graph) and return the seeds starting the top
+    // config_.max_num_seed_chains chains, as well as the seeds following
+    // gaps in those chains. The extensions of the dropped seeds are covered
+    // by the extensions of the returned ones.
+    std::vector<DBGAlignment> chain_seeds(std::string_view query,
+                                          std::vector<DBGAlignment>&& seeds) const;
 
     // Given alignments generated by a generator, add them to a priority queue
     // and add the top ones to paths.
@@ -153,16 +175,20 @@ template <class Seeder, class Extender, class AlignmentCompare>
 inline void DBGAligner<Seeder, Extender, AlignmentCompare>
 ::align_batch(const QueryGenerator &generate_query,
               const AlignmentCallback &callback) const {
+    static auto &latency = common::get_histogram("metagraph_alignment_seconds",
+                                                 "Time spent aligning a query sequence");
+
     generate_query([&](std::string_view header,
                        std::string_view query,
                        bool is_reverse_complement) {
+        common::ScopedLatency alignment_timer(latency);
+
         DBGQueryAlignment paths(query, is_reverse_complement);
         std::string_view this_query = paths.get_query(is_reverse_complement);
         assert(this_query == query);
 
         Seeder seeder(graph_, this_query, // use this_query since paths stores a copy
-                      is_reverse_complement, map_sequence_to_nodes(graph_, query),
-                      config_);
+                      is_reverse_complement, map_query(query), config_);
 
         Extender extender(graph_, config_, this_query);
 
@@ -187,7 +213,7 @@ inline void DBGAligner<Seeder, Extender, AlignmentCompare>
             std::string_view reverse = paths.get_query(true);
 
             Seeder seeder_rc(graph_, reverse, !is_reverse_complement,
-                             map_sequence_to_nodes(graph_, reverse), config_);
+                             map_query(reverse), config_);
 
             aligner_core_.align_best_direction(paths, seeder, seeder_rc,
                                                std::move(extender),
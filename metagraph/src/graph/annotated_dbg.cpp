@@ -38,6 +38,42 @@ AnnotatedDBG::AnnotatedDBG(std::shared_ptr<DeBruijnGraph> dbg,
                            bool force_fast)
       : AnnotatedSequenceGraph(dbg, std::move(annotation), force_fast), dbg_(*dbg) {}
 
+void AnnotatedDBG::set_row_cache(size_t num_rows) {
+    if (num_rows) {
+        row_cache_ = std::make_unique<annot::binmat::RowCache>(annotator_->get_matrix(),
+                                                               num_rows);
+    } else {
+        row_cache_.reset();
+    }
+}
+
+std::vector<Label> AnnotatedDBG::get_labels(node_index index) const {
+    if (!row_cache_)
+        return AnnotatedSequenceGraph::get_labels(index);
+
+    assert(check_compatibility());
+    assert(index != SequenceGraph::npos);
+
+    const auto &label_encoder = annotator_->get_label_encoder();
+
+    std::vector<Label> labels;
+    for (uint64_t code : row_cache_->get_row(graph_to_anno_index(index))) {
+        labels.push_back(label_encoder.decode(code));
+    }
+    return labels;
+}
+
+std::vector<std::pair<uint64_t, size_t>>
+AnnotatedDBG::count_labels(const std::vector<std::pair<row_index, size_t>> &index_counts,
+                           size_t min_count,
+                           size_t count_cap) const {
+    if (!row_cache_)
+        return annotator_->count_labels(index_counts, min_count, count_cap);
+
+    return annotator_->count_labels(index_counts, min_count, count_cap,
+                                    [&](row_index i) { return row_cache_->get_row(i); });
+}
+
 void AnnotatedSequenceGraph
 ::annotate_sequence(std::string_view sequence,
                     const std::vector<Label> &labels) {
@@ -134,7 +170,7 @@ AnnotatedDBG::get_labels(const std::vector<std::pair<row_index, size_t>> &index_
                          size_t min_count) const {
     assert(check_compatibility());
 
-    auto code_counts = annotator_->count_labels(
+    auto code_counts = count_labels(
         index_counts,
         min_count,
         std::max(min_count, size_t(1))
@@ -254,7 +290,8 @@ AnnotatedDBG::get_top_label_signatures(std::string_view sequence,
     // map each label code to a k-mer presence mask and its popcount
     VectorMap<LabelCode, SignatureCount> label_codes_to_presence;
 
-    auto label_codes = annotator_->get_matrix().get_rows(row_indices);
+    auto label_codes = row_cache_ ? row_cache_->get_rows(row_indices)
+                                  : annotator_->get_matrix().get_rows(row_indices);
 
     assert(label_codes.size() == row_indices.size());
 
@@ -326,7 +363,7 @@ AnnotatedDBG::get_top_labels(const std::vector<std::pair<row_index, size_t>> &in
                              size_t min_count) const {
     assert(check_compatibility());
 
-    auto code_counts = annotator_->count_labels(index_counts, min_count);
+    auto code_counts = count_labels(index_counts, min_count);
 
     assert(std::all_of(
         code_counts.begin(), code_counts.end(),
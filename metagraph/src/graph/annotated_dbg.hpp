@@ -9,6 +9,7 @@
 
 #include "representation/base/sequence_graph.hpp"
 #include "annotation/representation/base/annotation.hpp"
+#include "annotation/binary_matrix/base/row_cache.hpp"
 
 
 namespace mtg {
@@ -74,6 +75,15 @@ class AnnotatedDBG : public AnnotatedSequenceGraph {
 
     const DeBruijnGraph& get_graph() const { return dbg_; }
 
+    // Cache up to |num_rows| decoded annotation rows for the queries below
+    // (0 disables the cache). Must not be called concurrently with queries.
+    // The annotation must not be modified while the cache is enabled.
+    void set_row_cache(size_t num_rows);
+    // return nullptr if the cache is disabled
+    const annot::binmat::RowCache* get_row_cache() const { return row_cache_.get(); }
+
+    virtual std::vector<Label> get_labels(node_index index) const override;
+
     // add k-mer counts to the annotation
     void add_kmer_counts(std::string_view sequence,
                          const std::vector<Label> &labels,
@@ -109,7 +119,14 @@ class AnnotatedDBG : public AnnotatedSequenceGraph {
                                      int32_t mismatch_score = 2) const;
 
   private:
+    // same as Annotator::count_labels, but query the rows through the cache
+    std::vector<std::pair<uint64_t /* label_code */, size_t /* count */>>
+    count_labels(const std::vector<std::pair<row_index, size_t>> &index_counts,
+                 size_t min_count = 1,
+                 size_t count_cap = std::numeric_limits<size_t>::max()) const;
+
     DeBruijnGraph &dbg_;
+    std::unique_ptr<annot::binmat::RowCache> row_cache_;
 };
 
 } // namespace graph
@@ -250,5 +250,35 @@ mask_nodes_by_node_label(const AnnotatedDBG &anno_graph,
     }, anno_graph.get_graph().max_index() + 1);
 }
 
+std::unique_ptr<bitmap>
+mask_nodes_by_labels_cached(const AnnotatedDBG &anno_graph,
+                            const std::vector<Label> &labels) {
+    size_t size = anno_graph.get_graph().max_index() + 1;
+
+    // whether a node has already been checked and whether it is in the mask
+    auto checked = std::make_shared<sdsl::bit_vector>(size, false);
+    auto in_mask = std::make_shared<sdsl::bit_vector>(size, false);
+
+    return std::make_unique<bitmap_lazy>([&anno_graph,labels,checked,in_mask](uint64_t i) {
+        if (i == DeBruijnGraph::npos)
+            return false;
+
+        if (fetch_bit(checked->data(), i, true, __ATOMIC_ACQUIRE))
+            return fetch_bit(in_mask->data(), i, true, __ATOMIC_RELAXED);
+
+        bool has_label = std::any_of(labels.begin(), labels.end(),
+            [&](const auto &label) { return anno_graph.has_label(i, label); }
+        );
+
+        if (has_label)
+            set_bit(in_mask->data(), i, true, __ATOMIC_RELAXED);
+
+        // publish the result only after the mask bit has been set
+        set_bit(checked->data(), i, true, __ATOMIC_RELEASE);
+
+        return has_label;
+    }, size);
+}
+
 } // namespace graph
 } // namespace mtg
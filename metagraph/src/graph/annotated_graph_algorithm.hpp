@@ -68,6 +68,16 @@ mask_nodes_by_node_label(const AnnotatedDBG &anno_graph,
                          size_t num_threads = 1,
                          double min_frequency_for_frequent_label = 0.05);
 
+// Given an AnnotatedDBG and a set of labels, return a lazily evaluated bitmap
+// of length anno_graph.get_graph().max_index() + 1. An index i is set to 1 if
+// node i is annotated with at least one of the labels. The annotation is
+// queried only on the first access to each index and the result is cached,
+// so the mask is cheap if only a small part of the graph is ever accessed
+// (e.g., when aligning to it). The bitmap can be accessed concurrently.
+std::unique_ptr<bitmap>
+mask_nodes_by_labels_cached(const AnnotatedDBG &anno_graph,
+                            const std::vector<AnnotatedDBG::Annotator::Label> &labels);
+
 } // namespace graph
 } // namespace mtg
 
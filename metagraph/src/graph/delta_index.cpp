@@ -0,0 +1,143 @@
+#include "delta_index.hpp"
+
+#include <mutex>
+
+#include <tsl/hopscotch_map.h>
+
+#include "annotation/representation/column_compressed/annotate_column_compressed.hpp"
+#include "graph/representation/succinct/boss_construct.hpp"
+#include "graph/representation/succinct/dbg_succinct.hpp"
+#include "common/logger.hpp"
+#include "common/unix_tools.hpp"
+
+
+namespace mtg {
+namespace graph {
+
+using mtg::common::logger;
+
+
+DeltaIndex::DeltaIndex(std::shared_ptr<const DeBruijnGraph> base_graph,
+                       std::shared_ptr<const Annotator> base_annotation)
+      : base_annotation_(base_annotation),
+        graph_(std::make_shared<DeltaDBG>(base_graph)) {
+    assert(base_annotation_->num_objects() == base_graph->max_index());
+
+    auto annotation = std::make_unique<annot::DeltaAnnotation>(base_annotation_,
+                                                               graph_->max_index());
+    annotation_ = annotation.get();
+    anno_graph_ = std::make_unique<AnnotatedDBG>(graph_, std::move(annotation));
+}
+
+void DeltaIndex::add_sequence(std::string_view sequence,
+                              const std::vector<std::string> &labels) {
+    uint64_t old_max_index = graph_->max_index();
+
+    graph_->add_sequence(sequence);
+
+    // nodes of the delta graph are appended, hence the new rows are too
+    std::vector<uint64_t> new_rows;
+    new_rows.reserve(graph_->max_index() - old_max_index);
+    for (uint64_t i = old_max_index; i < graph_->max_index(); ++i) {
+        new_rows.push_back(i);
+    }
+    annotation_->insert_rows(new_rows);
+
+    anno_graph_->annotate_sequence(sequence, labels);
+}
+
+bool DeltaIndex::load_delta(const std::string &filename_base) {
+    if (!graph_->load(filename_base)) {
+        logger->error("Can't load delta graph from {}", filename_base);
+        return false;
+    }
+
+    if (!annotation_->load(filename_base)) {
+        logger->error("Can't load delta annotation from {}", filename_base);
+        return false;
+    }
+
+    if (annotation_->num_objects() != graph_->max_index()) {
+        logger->error("The delta annotation is incompatible with the delta graph");
+        return false;
+    }
+
+    return true;
+}
+
+void DeltaIndex::serialize_delta(const std::string &filename_base) const {
+    graph_->serialize(filename_base);
+    annotation_->serialize(filename_base);
+}
+
+std::unique_ptr<AnnotatedDBG> DeltaIndex::compact(size_t num_threads) const {
+    Timer timer;
+    logger->trace("Compacting {} base and {} delta k-mers...",
+                  graph_->get_base_graph().num_nodes(),
+                  graph_->get_delta_graph().num_nodes());
+
+    const bool canonical = graph_->is_canonical_mode();
+    std::mutex mu;
+
+    BOSSConstructor constructor(graph_->get_k() - 1, canonical, 0, "", num_threads);
+    graph_->call_sequences([&](const std::string &contig, const auto &) {
+                               std::lock_guard<std::mutex> lock(mu);
+                               constructor.add_sequence(contig);
+                           },
+                           num_threads, canonical);
+
+    auto dbg = std::make_shared<DBGSuccinct>(new BOSS(&constructor), canonical);
+    dbg->mask_dummy_kmers(num_threads, false);
+
+    logger->trace("Compacted graph with {} k-mers constructed in {} sec",
+                  dbg->num_nodes(), timer.elapsed());
+    timer.reset();
+
+    // transfer the labels from the overlay rows to the rows of the new graph
+    const auto &matrix = annotation_->get_matrix();
+    const auto &label_encoder = annotation_->get_label_encoder();
+    std::vector<std::vector<uint64_t>> new_rows(label_encoder.size());
+
+    graph_->call_sequences([&](const std::string &contig, const auto &path) {
+        std::vector<uint64_t> rows;
+        rows.reserve(path.size());
+        graph_->map_to_nodes(contig, [&](node_index node) {
+            rows.push_back(AnnotatedDBG::graph_to_anno_index(node));
+        });
+
+        std::vector<node_index> nodes;
+        nodes.reserve(path.size());
+        dbg->map_to_nodes(contig, [&](node_index node) { nodes.push_back(node); });
+        assert(nodes.size() == rows.size());
+
+        auto row_codes = matrix.get_rows(rows);
+
+        std::lock_guard<std::mutex> lock(mu);
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            assert(nodes[i]);
+            for (uint64_t code : row_codes[i]) {
+                new_rows[code].push_back(AnnotatedDBG::graph_to_anno_index(nodes[i]));
+            }
+        }
+    }, num_threads, canonical);
+
+    auto annotation = std::make_unique<annot::ColumnCompressed<>>(dbg->max_index());
+    for (size_t j = 0; j < new_rows.size(); ++j) {
+        annotation->add_labels(new_rows[j], { label_encoder.decode(j) });
+        new_rows[j] = std::vector<uint64_t>();
+    }
+
+    logger->trace("Compacted annotation with {} labels constructed in {} sec",
+                  annotation->num_labels(), timer.elapsed());
+
+    return std::make_unique<AnnotatedDBG>(dbg, std::move(annotation));
+}
+
+std::future<std::unique_ptr<AnnotatedDBG>>
+DeltaIndex::compact_async(size_t num_threads) const {
+    return std::async(std::launch::async,
+                      [this, num_threads]() { return compact(num_threads); });
+}
+
+} // namespace graph
+} // namespace mtg
@@ -0,0 +1,62 @@
+#ifndef __DELTA_INDEX_HPP__
+#define __DELTA_INDEX_HPP__
+
+#include <future>
+#include <memory>
+
+#include "annotated_dbg.hpp"
+#include "graph/representation/delta_dbg.hpp"
+#include "annotation/representation/delta/annotate_delta.hpp"
+
+
+namespace mtg {
+namespace graph {
+
+/**
+ * Incremental updates of a static annotated graph (e.g., DBGSuccinct with
+ * any static annotation). The new k-mers and labels are added to a delta
+ * overlay (DeltaDBG + DeltaAnnotation), the combined index is queried as a
+ * regular AnnotatedDBG, and the delta can be compacted into a new static
+ * index when it grows large.
+ *
+ * Multithreading:
+ *  add_sequence must be called sequentially. Then, the queries and the
+ *  compaction can run concurrently.
+ */
+class DeltaIndex {
+  public:
+    typedef AnnotatedDBG::Annotator Annotator;
+
+    DeltaIndex(std::shared_ptr<const DeBruijnGraph> base_graph,
+               std::shared_ptr<const Annotator> base_annotation);
+
+    // Add the k-mers of |sequence| missing in the index to the delta graph
+    // and annotate all k-mers of |sequence| with |labels|.
+    void add_sequence(std::string_view sequence, const std::vector<std::string> &labels);
+
+    const AnnotatedDBG& get_anno_graph() const { return *anno_graph_; }
+    const DeltaDBG& get_graph() const { return *graph_; }
+    const annot::DeltaAnnotation& get_annotation() const { return *annotation_; }
+
+    bool load_delta(const std::string &filename_base);
+    void serialize_delta(const std::string &filename_base) const;
+
+    // Merge the base index and the delta into a new static index
+    // (DBGSuccinct + ColumnCompressed annotation).
+    std::unique_ptr<AnnotatedDBG> compact(size_t num_threads = 1) const;
+
+    // Run #compact in a background thread. The delta must not be updated
+    // until the compaction completes.
+    std::future<std::unique_ptr<AnnotatedDBG>> compact_async(size_t num_threads = 1) const;
+
+  private:
+    std::shared_ptr<const Annotator> base_annotation_;
+    std::shared_ptr<DeltaDBG> graph_;
+    annot::DeltaAnnotation *annotation_;
+    std::unique_ptr<AnnotatedDBG> anno_graph_;
+};
+
+} // namespace graph
+} // namespace mtg
+
+#endif // __DELTA_INDEX_HPP__
@@ -0,0 +1,158 @@
+#include "minimizer_index.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+
+#include <ips4o.hpp>
+
+#include "common/serialization.hpp"
+
+
+namespace mtg {
+namespace graph {
+
+MinimizerIndex::MinimizerIndex(const DeBruijnGraph &graph,
+                               size_t minimizer_length,
+                               size_t num_threads)
+      : k_(graph.get_k()),
+        m_(minimizer_length),
+        max_index_(graph.max_index()),
+        kmer_hasher_(k_),
+        minimizer_hasher_(m_) {
+    if (!m_ || m_ > k_)
+        throw std::runtime_error("Minimizer length must be between 1 and k");
+
+    std::vector<std::pair<uint64_t, node_index>> index;
+    std::mutex index_mutex;
+
+    graph.call_sequences([&](const std::string &contig, const auto &path) {
+        std::vector<std::pair<uint64_t, node_index>> sampled;
+        call_sampled_kmers(contig, [&](size_t i, uint64_t hash) {
+            assert(i < path.size());
+            sampled.emplace_back(hash, path[i]);
+        });
+
+        std::lock_guard<std::mutex> lock(index_mutex);
+        index.insert(index.end(), sampled.begin(), sampled.end());
+    }, num_threads);
+
+    ips4o::parallel::sort(index.begin(), index.end(), std::less<>(), num_threads);
+
+    hashes_.resize(index.size());
+    nodes_ = sdsl::int_vector<>(index.size(), 0, sdsl::bits::hi(max_index_) + 1);
+    for (size_t i = 0; i < index.size(); ++i) {
+        hashes_[i] = index[i].first;
+        nodes_[i] = index[i].second;
+    }
+}
+
+void MinimizerIndex
+::call_sampled_kmers(std::string_view sequence,
+                     const std::function<void(size_t, uint64_t)> &callback) const {
+    if (sequence.size() < k_)
+        return;
+
+    std::vector<uint64_t> minimizer_hashes(sequence.size() - m_ + 1);
+    auto minimizer_hasher = minimizer_hasher_;
+    minimizer_hasher.reset(sequence.data());
+    minimizer_hashes[0] = minimizer_hasher;
+    for (size_t i = m_; i < sequence.size(); ++i) {
+        minimizer_hasher.next(sequence[i]);
+        minimizer_hashes[i - m_ + 1] = minimizer_hasher;
+    }
+
+    // positions of the m-mers in the current window with increasing hashes,
+    // so the front is the leftmost m-mer with the lowest hash
+    std::deque<size_t> window;
+    auto push = [&](size_t j) {
+        while (window.size() && minimizer_hashes[window.back()] > minimizer_hashes[j]) {
+            window.pop_back();
+        }
+        window.push_back(j);
+    };
+
+    size_t w = get_window_size();
+    for (size_t j = 0; j + 1 < w; ++j) {
+        push(j);
+    }
+
+    auto kmer_hasher = kmer_hasher_;
+    kmer_hasher.reset(sequence.data());
+    for (size_t i = 0; i + k_ <= sequence.size(); ++i) {
+        if (i)
+            kmer_hasher.next(sequence[i + k_ - 1]);
+
+        push(i + w - 1);
+        while (window.front() < i) {
+            window.pop_front();
+        }
+
+        if (window.front() == i)
+            callback(i, kmer_hasher);
+    }
+}
+
+void MinimizerIndex
+::call_nodes(std::string_view sequence,
+             const std::function<void(size_t, node_index)> &callback) const {
+    call_sampled_kmers(sequence, [&](size_t i, uint64_t hash) {
+        auto [begin, end] = std::equal_range(hashes_.begin(), hashes_.end(), hash);
+        for (auto it = begin; it != end; ++it) {
+            callback(i, nodes_[it - hashes_.begin()]);
+        }
+    });
+}
+
+bool MinimizerIndex::load(const std::string &filename_base) {
+    const auto minimizers_filename
+        = utils::remove_suffix(filename_base, kMinimizersExtension)
+                                        + kMinimizersExtension;
+    try {
+        std::ifstream instream(minimizers_filename, std::ios::binary);
+        if (!instream.good())
+            return false;
+
+        k_ = load_number(instream);
+        m_ = load_number(instream);
+        max_index_ = load_number(instream);
+        hashes_ = load_number_vector_raw<uint64_t>(instream);
+        nodes_.load(instream);
+
+        kmer_hasher_ = RollingHash<>(k_);
+        minimizer_hasher_ = RollingHash<>(m_);
+
+        return hashes_.size() == nodes_.size();
+
+    } catch (...) {
+        std::cerr << "ERROR: Cannot load minimizer index from file "
+                  << minimizers_filename << std::endl;
+        return false;
+    }
+}
+
+void MinimizerIndex::serialize(const std::string &filename_base) const {
+    const auto minimizers_filename
+        = utils::remove_suffix(filename_base, kMinimizersExtension)
+                                        + kMinimizersExtension;
+
+    std::ofstream outstream(minimizers_filename, std::ios::binary);
+    serialize_number(outstream, k_);
+    serialize_number(outstream, m_);
+    serialize_number(outstream, max_index_);
+    serialize_number_vector_raw(outstream, hashes_);
+    nodes_.serialize(outstream);
+}
+
+bool MinimizerIndex::is_compatible(const SequenceGraph &graph, bool verbose) const {
+    const auto *dbg = dynamic_cast<const DeBruijnGraph*>(&graph);
+    if (dbg && dbg->get_k() == k_ && graph.max_index() == max_index_)
+        return true;
+
+    if (verbose)
+        std::cerr << "ERROR: minimizer index does not match the graph" << std::endl;
+    return false;
+}
+
+} // namespace graph
+} // namespace mtg
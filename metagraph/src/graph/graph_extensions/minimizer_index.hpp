@@ -0,0 +1,74 @@
+#ifndef __MINIMIZER_INDEX_HPP__
+#define __MINIMIZER_INDEX_HPP__
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <sdsl/int_vector.hpp>
+
+#include "graph/representation/base/sequence_graph.hpp"
+#include "common/hashers/rolling_hasher.hpp"
+
+
+namespace mtg {
+namespace graph {
+
+/**
+ * An index of the graph k-mers starting with their minimizer, i.e., with
+ * the m-mer with the lowest hash among the w = k - m + 1 m-mers of the k-mer.
+ * Since the sampling depends only on the k-mer itself, a query k-mer can only
+ * be found in the index if it is sampled as well, so only a fraction of about
+ * 1 / w of the query k-mers has to be looked up. Unlike for window minimizers,
+ * the gaps between consecutive sampled k-mers can be longer than k.
+ * The index is not updated when the graph changes.
+ */
+class MinimizerIndex : public SequenceGraph::GraphExtension {
+  public:
+    using node_index = typename SequenceGraph::node_index;
+
+    MinimizerIndex() {}
+    MinimizerIndex(const DeBruijnGraph &graph,
+                   size_t minimizer_length,
+                   size_t num_threads = 1);
+
+    // Call the positions and hashes of the sampled k-mers of the sequence
+    void call_sampled_kmers(std::string_view sequence,
+                            const std::function<void(size_t /* position */,
+                                                     uint64_t /* hash */)> &callback) const;
+
+    // Call the indexed nodes whose k-mers have the same hashes as the sampled
+    // k-mers of the sequence. The k-mers of the nodes must still be checked
+    // against the sequence, since different k-mers may share the same hash.
+    void call_nodes(std::string_view sequence,
+                    const std::function<void(size_t /* position */,
+                                             node_index)> &callback) const;
+
+    size_t get_k() const { return k_; }
+    size_t get_minimizer_length() const { return m_; }
+    size_t get_window_size() const { return k_ - m_ + 1; }
+    size_t num_sampled_kmers() const { return hashes_.size(); }
+
+    bool load(const std::string &filename_base);
+    void serialize(const std::string &filename_base) const;
+
+    bool is_compatible(const SequenceGraph &graph, bool verbose = true) const;
+
+  private:
+    size_t k_ = 1;
+    size_t m_ = 1;
+    uint64_t max_index_ = 0;
+    // sorted hashes of the sampled k-mers and their nodes in the same order
+    std::vector<uint64_t> hashes_;
+    sdsl::int_vector<> nodes_;
+
+    RollingHash<> kmer_hasher_ = RollingHash<>(1);
+    RollingHash<> minimizer_hasher_ = RollingHash<>(1);
+
+    static constexpr auto kMinimizersExtension = ".minimizers";
+};
+
+} // namespace graph
+} // namespace mtg
+
+#endif // __MINIMIZER_INDEX_HPP__
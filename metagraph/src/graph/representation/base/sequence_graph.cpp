@@ -1,5 +1,6 @@
 #include "sequence_graph.hpp"
 
+#include <atomic>
 #include <cassert>
 #include <progress_bar.hpp>
 #include <sdsl/int_vector.hpp>
@@ -105,6 +106,15 @@ void DeBruijnGraph::traverse(node_index start,
     }
 }
 
+/**
+ * Traverse the graph from |start| and call the paths reachable from it.
+ * If |async| is true, the traversal can be run concurrently with other
+ * traversals sharing the same |visited| and |discovered| vectors. Each node
+ * is then claimed by exactly one traversal with an atomic fetch-and-set.
+ * In this mode, if |kmers_in_single_form| is true, a k-mer is called only
+ * by the traversal that first sets the bit of its canonical form (the
+ * smaller of the node and its reverse-complement) in |called|.
+ */
 void call_sequences_from(const DeBruijnGraph &graph,
                          node_index start,
                          const DeBruijnGraph::CallPath &callback,
@@ -113,16 +123,19 @@ void call_sequences_from(const DeBruijnGraph &graph,
                          ProgressBar &progress_bar,
                          bool call_unitigs,
                          uint64_t min_tip_size,
-                         bool kmers_in_single_form) {
+                         bool kmers_in_single_form,
+                         bool async = false,
+                         sdsl::bit_vector *called = nullptr) {
     assert(start >= 1 && start <= graph.max_index());
     assert((min_tip_size <= 1 || call_unitigs)
                 && "tip pruning works only for unitig extraction");
     assert(visited);
     assert(discovered);
-    assert(!(*visited)[start]);
+    assert(async || !fetch_bit(visited->data(), start));
+    assert(!async || !kmers_in_single_form || called);
 
     std::vector<node_index> queue = { start };
-    (*discovered)[start] = true;
+    set_bit(discovered->data(), start, async);
 
     std::vector<node_index> path;
     std::string sequence;
@@ -132,22 +145,30 @@ void call_sequences_from(const DeBruijnGraph &graph,
     // keep traversing until we have worked off all branches from the queue
     while (queue.size()) {
         node_index node = queue.back();
+        queue.pop_back();
+        assert(async || !call_unitigs || !fetch_bit(visited->data(), node));
+        if (fetch_bit(visited->data(), node, async))
+            continue;
+
         path.resize(0);
         path.push_back(node);
         sequence = graph.get_node_sequence(node);
-        queue.pop_back();
         start = node;
-        assert(!call_unitigs || !(*visited)[node]);
-        if ((*visited)[node])
-            continue;
 
         // traverse simple path until we reach its tail or
         // the first edge that has been already visited
-        while (!(*visited)[node]) {
+        while (true) {
             assert(node);
-            assert((*discovered)[node]);
+            assert(fetch_bit(discovered->data(), node, async));
             assert(sequence.length() >= graph.get_k());
-            (*visited)[node] = true;
+
+            if (fetch_and_set_bit(visited->data(), node, async)) {
+                // the node has just been visited in a concurrent traversal
+                assert(async);
+                path.pop_back();
+                sequence.pop_back();
+                break;
+            }
             ++progress_bar;
 
             targets.clear();
@@ -161,16 +182,17 @@ void call_sequences_from(const DeBruijnGraph &graph,
             // in call_unitigs mode, all nodes with multiple incoming
             // edges are marked as discovered
             assert(!call_unitigs || graph.has_single_incoming(targets.front().first)
-                                 || (*discovered)[targets.front().first]);
+                        || fetch_bit(discovered->data(), targets.front().first, async));
             if (targets.size() == 1) {
-                if ((*visited)[targets.front().first])
+                if (fetch_bit(visited->data(), targets.front().first, async))
                     break;
 
-                if (!call_unitigs || !(*discovered)[targets.front().first]) {
+                if (!call_unitigs
+                        || !fetch_bit(discovered->data(), targets.front().first, async)) {
                     sequence.push_back('\0');
                     std::tie(node, sequence.back()) = targets[0];
                     path.push_back(node);
-                    (*discovered)[node] = true;
+                    set_bit(discovered->data(), node, async);
                     continue;
                 }
             }
@@ -181,13 +203,12 @@ void call_sequences_from(const DeBruijnGraph &graph,
             for (const auto& [next, c] : targets) {
                 if (next_node == DeBruijnGraph::npos
                         && !call_unitigs
-                        && !(*visited)[next]) {
-                    (*discovered)[next] = true;
+                        && !fetch_bit(visited->data(), next, async)) {
+                    set_bit(discovered->data(), next, async);
                     next_node = next;
                     sequence.push_back(c);
                     path.push_back(next);
-                } else if (!(*discovered)[next]) {
-                    (*discovered)[next] = true;
+                } else if (!fetch_and_set_bit(discovered->data(), next, async)) {
                     queue.push_back(next);
                 }
             }
@@ -198,8 +219,12 @@ void call_sequences_from(const DeBruijnGraph &graph,
             node = next_node;
         }
 
+        if (path.empty())
+            continue;
+
+        node = path.back();
+
         assert(sequence.size() >= graph.get_k());
-        assert(path.size());
 
         if (!call_unitigs
                   // check if long
@@ -219,30 +244,49 @@ void call_sequences_from(const DeBruijnGraph &graph,
                 size_t begin = 0;
 
                 assert(std::all_of(path.begin(), path.end(),
-                                   [&](auto i) { return (*visited)[i]; }));
+                                   [&](auto i) { return fetch_bit(visited->data(), i, async); }));
 
                 progress_bar += std::count_if(dual_path.begin(), dual_path.end(),
-                                              [&](auto node) { return node && !(*visited)[node]; });
+                    [&](auto node) { return node && !fetch_bit(visited->data(), node, async); }
+                );
 
                 // Mark all nodes in path as unvisited and re-visit them while
                 // traversing the path (iterating through all nodes).
-                std::for_each(path.begin(), path.end(),
-                              [&](auto i) { (*visited)[i] = false; });
+                if (!async) {
+                    std::for_each(path.begin(), path.end(),
+                                  [&](auto i) { (*visited)[i] = false; });
+                }
 
                 // traverse the path with its dual and visit the nodes
                 for (size_t i = 0; i < path.size(); ++i) {
                     assert(path[i]);
-                    (*visited)[path[i]] = true;
 
-                    if (!dual_path[i])
-                        continue;
+                    bool skip;
+                    if (async) {
+                        // the k-mer is called by the traversal claiming its canonical form
+                        skip = fetch_and_set_bit(called->data(),
+                                                 dual_path[i] ? std::min(path[i], dual_path[i])
+                                                              : path[i],
+                                                 async);
+                        if (dual_path[i]) {
+                            set_bit(visited->data(), dual_path[i], async);
+                            set_bit(discovered->data(), dual_path[i], async);
+                        }
+                    } else {
+                        (*visited)[path[i]] = true;
 
-                    // check if reverse-complement k-mer has been traversed
-                    if (!(*visited)[dual_path[i]] || dual_path[i] == path[i]) {
-                        (*visited)[dual_path[i]] = (*discovered)[dual_path[i]] = true;
-                        continue;
+                        if (!dual_path[i])
+                            continue;
+
+                        // check if reverse-complement k-mer has been traversed
+                        skip = (*visited)[dual_path[i]] && dual_path[i] != path[i];
+                        if (!skip)
+                            (*visited)[dual_path[i]] = (*discovered)[dual_path[i]] = true;
                     }
 
+                    if (!skip)
+                        continue;
+
                     // The reverse-complement k-mer has been visited
                     // -> Skip this k-mer and call the traversed path segment.
                     if (begin < i)
@@ -268,15 +312,131 @@ void call_sequences_from(const DeBruijnGraph &graph,
     }
 }
 
+/**
+ * Parallel version of the traversal in call_sequences.
+ *
+ * The start nodes are found in blocks of nodes processed in parallel and
+ * the traversals run concurrently, with each node claimed by exactly one
+ * traversal through atomic updates of |visited| and |discovered|. The
+ * traversals are started in the same three stages as in the sequential
+ * version: from the sources (merges, for unitigs), from the successors of
+ * forks, and, finally, from the remaining simple cycles, each of which is
+ * started from its smallest node to call it as a single sequence.
+ */
+void call_sequences_parallel(const DeBruijnGraph &graph,
+                             const DeBruijnGraph::CallPath &callback,
+                             size_t num_threads,
+                             bool call_unitigs,
+                             uint64_t min_tip_size,
+                             bool kmers_in_single_form,
+                             sdsl::bit_vector *visited,
+                             sdsl::bit_vector *discovered,
+                             ProgressBar &progress_bar) {
+    constexpr bool async = true;
+
+    // marks the canonical forms of the k-mers already called
+    sdsl::bit_vector called;
+    if (kmers_in_single_form)
+        called = sdsl::bit_vector(visited->size(), false);
+
+    auto call_paths_from = [&](node_index node) {
+        call_sequences_from(graph,
+                            node,
+                            callback,
+                            visited,
+                            discovered,
+                            progress_bar,
+                            call_unitigs,
+                            min_tip_size,
+                            kmers_in_single_form,
+                            async,
+                            &called);
+    };
+
+    // small blocks to balance the load for small graphs, e.g., query graphs
+    const uint64_t block_size = std::min(
+        kBlockSize,
+        std::max(uint64_t(1) << 10, (visited->size() / (num_threads * 64)) & ~uint64_t(0x3F))
+    );
+
+    auto for_each_unvisited = [&](const std::function<void(node_index)> &callback) {
+        #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+        for (uint64_t begin = 0; begin < visited->size(); begin += block_size) {
+            call_zeros(*visited,
+                       begin,
+                       std::min(begin + block_size, visited->size()),
+                       callback,
+                       async);
+        }
+    };
+
+    if (call_unitigs) {
+        // traverse graph starting at source and merge nodes
+        for_each_unvisited([&](auto node) {
+            if (!graph.has_single_incoming(node))
+                call_paths_from(node);
+        });
+
+    } else {
+        // start at the source nodes (those with indegree == 0)
+        for_each_unvisited([&](auto node) {
+            if (graph.has_no_incoming(node))
+                call_paths_from(node);
+        });
+    }
+
+    // then forks
+    for_each_unvisited([&](auto node) {
+        if (graph.has_multiple_outgoing(node)) {
+            graph.adjacent_outgoing_nodes(node, [&](auto next) {
+                if (!fetch_bit(visited->data(), next, async))
+                    call_paths_from(next);
+            });
+        }
+    });
+
+    // then the rest (loops)
+    std::atomic<bool> leftovers = false;
+    for_each_unvisited([&](auto node) {
+        // find the smallest node in the cycle.
+        // The walk follows nodes with single incoming edges, so it
+        // either returns to |node| or stops.
+        node_index rep = node;
+        node_index next = node;
+        while (true) {
+            if (!graph.has_single_outgoing(next)) {
+                leftovers = true;
+                return;
+            }
+
+            graph.adjacent_outgoing_nodes(next, [&](auto n) { next = n; });
+            if (next == node)
+                break;
+
+            if (!graph.has_single_incoming(next)
+                    || fetch_bit(visited->data(), next, async)) {
+                // not a simple cycle, or it's being traversed concurrently
+                leftovers = true;
+                return;
+            }
+
+            rep = std::min(rep, next);
+        }
+
+        call_paths_from(rep);
+    });
+
+    // finish the nodes left, e.g., after calling the k-mers in single form
+    if (leftovers)
+        call_zeros(*visited, call_paths_from, async);
+}
+
 void call_sequences(const DeBruijnGraph &graph,
                     const DeBruijnGraph::CallPath &callback,
                     size_t num_threads,
                     bool call_unitigs,
                     uint64_t min_tip_size,
                     bool kmers_in_single_form) {
-    // TODO: port over the implementation from BOSS once it's finalized
-    std::ignore = num_threads;
-
     sdsl::bit_vector discovered(graph.max_index() + 1, true);
     graph.call_nodes([&](auto node) { discovered[node] = false; });
     sdsl::bit_vector visited = discovered;
@@ -285,18 +445,6 @@ void call_sequences(const DeBruijnGraph &graph,
                              "Traverse graph",
                              std::cerr, !common::get_verbose());
 
-    auto call_paths_from = [&](node_index node) {
-        call_sequences_from(graph,
-                            node,
-                            callback,
-                            &visited,
-                            &discovered,
-                            progress_bar,
-                            call_unitigs,
-                            min_tip_size,
-                            kmers_in_single_form);
-    };
-
     if (call_unitigs) {
         // mark all source and merge nodes (those with indegree 0 or >1)
         //  .____  or  .____  or  ____.___
@@ -310,8 +458,29 @@ void call_sequences(const DeBruijnGraph &graph,
                 [&](auto i) { discovered[i] = !graph.has_single_incoming(i); }
             );
         }
+    }
+
+    if (num_threads > 1) {
+        call_sequences_parallel(graph, callback, num_threads, call_unitigs,
+                                min_tip_size, kmers_in_single_form,
+                                &visited, &discovered, progress_bar);
+        return;
+    }
+
+    auto call_paths_from = [&](node_index node) {
+        call_sequences_from(graph,
+                            node,
+                            callback,
+                            &visited,
+                            &discovered,
+                            progress_bar,
+                            call_unitigs,
+                            min_tip_size,
+                            kmers_in_single_form);
+    };
 
-        // now traverse graph starting at these nodes
+    if (call_unitigs) {
+        // now traverse graph starting at source and merge nodes
         call_zeros(visited, [&](auto node) {
             assert(discovered[node] == !graph.has_single_incoming(node));
             if (discovered[node])
@@ -175,6 +175,7 @@ class DeBruijnGraph : public SequenceGraph {
      * @param kmers_in_single_form if true, output each k-mer only in one of its forms
      * (canonical/non-canonical). That is, skip a k-mer if its reverse-complement has been
      * extracted.
+     * If |num_threads| > 1, the callback may be called concurrently from multiple threads.
      */
     virtual void call_sequences(const CallPath &callback,
                                 size_t num_threads = 1,
@@ -185,6 +186,7 @@ class DeBruijnGraph : public SequenceGraph {
      * If |kmers_in_single_form| is true, output each k-mer only in one of its
      * forms (canonical/non-canonical). That is, skip a k-mer if its
      * reverse-complement has been extracted.
+     * If |num_threads| > 1, the callback may be called concurrently from multiple threads.
      */
     virtual void call_unitigs(const CallPath &callback,
                               size_t num_threads = 1,
@@ -30,7 +30,9 @@ class BitmapChunkConstructor : public IBitmapChunkConstructor {
                            bool canonical_mode = false,
                            const std::string &filter_suffix = "",
                            size_t num_threads = 1,
-                           double memory_preallocated = 0);
+                           double memory_preallocated = 0,
+                           const std::filesystem::path &swap_dir = "/tmp/",
+                           size_t num_superkmer_bins = 0);
 
     void add_sequence(std::string_view sequence, uint64_t count) {
         kmer_collector_.add_sequence(sequence, count);
@@ -73,26 +75,36 @@ BitmapChunkConstructor<KmerCollector>
                          bool canonical_mode,
                          const std::string &filter_suffix,
                          size_t num_threads,
-                         double memory_preallocated)
+                         double memory_preallocated,
+                         const std::filesystem::path &swap_dir,
+                         size_t num_superkmer_bins)
       : kmer_collector_(k,
                         canonical_mode,
                         encode_filter_suffix<KmerExtractor2Bit>(filter_suffix),
                         num_threads,
-                        memory_preallocated) {}
+                        memory_preallocated,
+                        swap_dir,
+                        1e9,
+                        false,
+                        num_superkmer_bins) {}
 
 DBGBitmapConstructor::DBGBitmapConstructor(size_t k,
                                            bool canonical_mode,
                                            uint8_t bits_per_count,
                                            const std::string &filter_suffix,
                                            size_t num_threads,
-                                           double memory_preallocated) {
+                                           double memory_preallocated,
+                                           const std::filesystem::path &swap_dir,
+                                           size_t num_superkmer_bins) {
     constructor_.reset(
         IBitmapChunkConstructor::initialize(k,
                                             canonical_mode,
                                             bits_per_count,
                                             filter_suffix,
                                             num_threads,
-                                            memory_preallocated)
+                                            memory_preallocated,
+                                            swap_dir,
+                                            num_superkmer_bins)
     );
     bits_per_count_ = bits_per_count;
 }
@@ -278,8 +290,11 @@ IBitmapChunkConstructor::initialize(size_t k,
                                     uint8_t bits_per_count,
                                     const std::string &filter_suffix,
                                     size_t num_threads,
-                                    double memory_preallocated) {
-#define OTHER_ARGS k, canonical_mode, filter_suffix, num_threads, memory_preallocated
+                                    double memory_preallocated,
+                                    const std::filesystem::path &swap_dir,
+                                    size_t num_superkmer_bins) {
+#define OTHER_ARGS k, canonical_mode, filter_suffix, num_threads, memory_preallocated, \
+                   swap_dir, num_superkmer_bins
 
     if (!bits_per_count) {
         return initialize_bitmap_chunk_constructor<KmerSet>(OTHER_ARGS);
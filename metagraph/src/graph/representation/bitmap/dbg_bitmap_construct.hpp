@@ -1,6 +1,8 @@
 #ifndef __DBG_BITMAP_CONSTRUCT_HPP__
 #define __DBG_BITMAP_CONSTRUCT_HPP__
 
+#include <filesystem>
+
 #include "dbg_bitmap.hpp"
 #include "graph/representation/base/dbg_construct.hpp"
 
@@ -17,7 +19,9 @@ class IBitmapChunkConstructor : public IGraphChunkConstructor<DBGBitmap::Chunk>
                                                uint8_t bits_per_count = 0,
                                                const std::string &filter_suffix = "",
                                                size_t num_threads = 1,
-                                               double memory_preallocated = 0);
+                                               double memory_preallocated = 0,
+                                               const std::filesystem::path &swap_dir = "/tmp/",
+                                               size_t num_superkmer_bins = 0);
 
     virtual size_t get_k() const = 0;
     virtual bool is_canonical_mode() const = 0;
@@ -29,12 +33,16 @@ class IBitmapChunkConstructor : public IGraphChunkConstructor<DBGBitmap::Chunk>
 class DBGBitmapConstructor : public IGraphConstructor<DBGBitmap> {
   public:
     // Don't count k-mers if |bits_per_count| is zero.
+    // If |num_superkmer_bins| is positive, the k-mers are collected through
+    // super-k-mer bins created in |swap_dir| (see kmer::SuperkmerBins).
     DBGBitmapConstructor(size_t k,
                          bool canonical_mode = false,
                          uint8_t bits_per_count = 0,
                          const std::string &filter_suffix = "",
                          size_t num_threads = 1,
-                         double memory_preallocated = 0);
+                         double memory_preallocated = 0,
+                         const std::filesystem::path &swap_dir = "/tmp/",
+                         size_t num_superkmer_bins = 0);
 
     void add_sequence(std::string_view sequence, uint64_t count = 1) {
         constructor_->add_sequence(sequence, count);
@@ -1,5 +1,7 @@
 #include "canonical_dbg.hpp"
 
+#include <tuple>
+
 #include "graph/representation/succinct/dbg_succinct.hpp"
 #include "common/seq_tools/reverse_complement.hpp"
 #include "kmer/kmer_extractor.hpp"
@@ -62,6 +64,16 @@ void CanonicalDBG
 ::map_to_nodes_sequentially(std::string_view sequence,
                             const std::function<void(node_index)> &callback,
                             const std::function<bool()> &terminate) const {
+    if (!graph_.is_canonical_mode()) {
+        if (const auto *dbg_succ = dynamic_cast<const DBGSuccinct*>(&graph_)) {
+            // look up both orientations in a single pass
+            dbg_succ->map_to_nodes_with_rc(sequence, [&](node_index node, bool is_rc) {
+                callback(is_rc ? node + offset_ : node);
+            }, terminate);
+            return;
+        }
+    }
+
     std::vector<node_index> path = map_sequence_to_nodes(graph_, sequence);
     auto first_not_found = graph_.is_canonical_mode()
         ? path.end()
@@ -354,7 +366,9 @@ void CanonicalDBG::call_sequences(const CallPath &callback,
         graph_.call_sequences(callback, num_threads, false);
     } else {
         // TODO: port over implementation from DBGSuccinct to DeBruijnGraph
-        DeBruijnGraph::call_sequences(callback, num_threads, false);
+        // the caches are not thread-safe, so the traversal is sequential
+        std::ignore = num_threads;
+        DeBruijnGraph::call_sequences(callback, 1, false);
     }
 }
 
@@ -363,7 +377,9 @@ void CanonicalDBG::call_unitigs(const CallPath &callback,
                                 size_t min_tip_size,
                                 bool kmers_in_single_form) const {
     // TODO: port over implementation from DBGSuccinct to DeBruijnGraph
-    DeBruijnGraph::call_unitigs(callback, num_threads, min_tip_size, kmers_in_single_form);
+    // the caches are not thread-safe, so the traversal is sequential
+    std::ignore = num_threads;
+    DeBruijnGraph::call_unitigs(callback, 1, min_tip_size, kmers_in_single_form);
 }
 
 std::string CanonicalDBG::get_node_sequence(node_index index) const {
@@ -0,0 +1,291 @@
+#include "delta_dbg.hpp"
+
+#include <algorithm>
+
+#include "common/logger.hpp"
+
+
+namespace mtg {
+namespace graph {
+
+using mtg::common::logger;
+
+
+DeltaDBG::DeltaDBG(std::shared_ptr<const DeBruijnGraph> base)
+      : base_(base),
+        delta_(std::make_unique<DBGHashOrdered>(base_->get_k(), base_->is_canonical_mode())),
+        offset_(base_->max_index()) {}
+
+void DeltaDBG::add_sequence(std::string_view sequence,
+                            const std::function<void(node_index)> &on_insertion) {
+    if (sequence.size() < get_k())
+        return;
+
+    std::vector<node_index> nodes;
+    nodes.reserve(sequence.size() - get_k() + 1);
+    base_->map_to_nodes_sequentially(sequence,
+                                     [&](node_index node) { nodes.push_back(node); });
+
+    // insert the runs of consecutive k-mers missing in the base graph
+    std::vector<node_index> new_nodes;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i])
+            continue;
+
+        size_t j = i + 1;
+        while (j < nodes.size() && !nodes[j]) {
+            ++j;
+        }
+
+        delta_->add_sequence(sequence.substr(i, j - i + get_k() - 1),
+                             [&](node_index node) { new_nodes.push_back(node); });
+        i = j;
+    }
+
+    for (node_index node : new_nodes) {
+        update_boundary(node);
+        on_insertion(offset_ + node);
+    }
+}
+
+void DeltaDBG::update_boundary(node_index delta_node) {
+    std::string kmer = delta_->get_node_sequence(delta_node);
+
+    std::string prev_kmer = '#' + kmer.substr(0, get_k() - 1);
+    std::string next_kmer = kmer.substr(1) + '#';
+
+    for (char c : delta_->alphabet()) {
+        prev_kmer.front() = c;
+        if (node_index prev = base_->kmer_to_node(prev_kmer))
+            boundary_.insert(prev);
+
+        next_kmer.back() = c;
+        if (node_index next = base_->kmer_to_node(next_kmer))
+            boundary_.insert(next);
+    }
+}
+
+void DeltaDBG
+::call_mapped_nodes(const std::function<void(const DeBruijnGraph &,
+                                             const std::function<void(node_index)> &)> &map_to_nodes,
+                    const std::function<void(node_index)> &callback,
+                    const std::function<bool()> &terminate) const {
+    std::vector<node_index> nodes;
+    map_to_nodes(*base_, [&](node_index node) { nodes.push_back(node); });
+
+    if (delta_->num_nodes() && std::find(nodes.begin(), nodes.end(), npos) != nodes.end()) {
+        auto it = nodes.begin();
+        map_to_nodes(*delta_, [&](node_index node) {
+            assert(it != nodes.end());
+            assert(!*it || !node);
+            if (!*it)
+                *it = delta_to_node(node);
+            ++it;
+        });
+        assert(it == nodes.end());
+    }
+
+    for (node_index node : nodes) {
+        if (terminate())
+            return;
+
+        callback(node);
+    }
+}
+
+void DeltaDBG::map_to_nodes(std::string_view sequence,
+                            const std::function<void(node_index)> &callback,
+                            const std::function<bool()> &terminate) const {
+    call_mapped_nodes([&](const DeBruijnGraph &graph, const auto &callback) {
+                          graph.map_to_nodes(sequence, callback);
+                      },
+                      callback, terminate);
+}
+
+void DeltaDBG::map_to_nodes_sequentially(std::string_view sequence,
+                                         const std::function<void(node_index)> &callback,
+                                         const std::function<bool()> &terminate) const {
+    call_mapped_nodes([&](const DeBruijnGraph &graph, const auto &callback) {
+                          graph.map_to_nodes_sequentially(sequence, callback);
+                      },
+                      callback, terminate);
+}
+
+void DeltaDBG::call_outgoing_kmers(node_index node,
+                                   const OutgoingEdgeCallback &callback) const {
+    assert(node > 0 && node <= max_index());
+
+    if (!in_delta(node)) {
+        base_->call_outgoing_kmers(node, callback);
+
+        if (!boundary_.count(node))
+            return;
+
+        std::string next_kmer = base_->get_node_sequence(node).substr(1) + '#';
+        for (char c : delta_->alphabet()) {
+            next_kmer.back() = c;
+            if (node_index next = delta_->kmer_to_node(next_kmer))
+                callback(offset_ + next, c);
+        }
+
+    } else {
+        delta_->call_outgoing_kmers(node - offset_, [&](node_index next, char c) {
+            callback(offset_ + next, c);
+        });
+
+        std::string next_kmer = delta_->get_node_sequence(node - offset_).substr(1) + '#';
+        for (char c : delta_->alphabet()) {
+            next_kmer.back() = c;
+            if (node_index next = base_->kmer_to_node(next_kmer))
+                callback(next, c);
+        }
+    }
+}
+
+void DeltaDBG::call_incoming_kmers(node_index node,
+                                   const IncomingEdgeCallback &callback) const {
+    assert(node > 0 && node <= max_index());
+
+    if (!in_delta(node)) {
+        base_->call_incoming_kmers(node, callback);
+
+        if (!boundary_.count(node))
+            return;
+
+        std::string prev_kmer = '#' + base_->get_node_sequence(node).substr(0, get_k() - 1);
+        for (char c : delta_->alphabet()) {
+            prev_kmer.front() = c;
+            if (node_index prev = delta_->kmer_to_node(prev_kmer))
+                callback(offset_ + prev, c);
+        }
+
+    } else {
+        delta_->call_incoming_kmers(node - offset_, [&](node_index prev, char c) {
+            callback(offset_ + prev, c);
+        });
+
+        std::string prev_kmer = '#' + delta_->get_node_sequence(node - offset_).substr(0, get_k() - 1);
+        for (char c : delta_->alphabet()) {
+            prev_kmer.front() = c;
+            if (node_index prev = base_->kmer_to_node(prev_kmer))
+                callback(prev, c);
+        }
+    }
+}
+
+void DeltaDBG::adjacent_outgoing_nodes(node_index node,
+                                       const std::function<void(node_index)> &callback) const {
+    call_outgoing_kmers(node, [&](node_index next, char) { callback(next); });
+}
+
+void DeltaDBG::adjacent_incoming_nodes(node_index node,
+                                       const std::function<void(node_index)> &callback) const {
+    call_incoming_kmers(node, [&](node_index prev, char) { callback(prev); });
+}
+
+DeBruijnGraph::node_index DeltaDBG::traverse(node_index node, char next_char) const {
+    assert(node > 0 && node <= max_index());
+
+    if (!in_delta(node)) {
+        node_index next = base_->traverse(node, next_char);
+        if (next || !boundary_.count(node)
+                || delta_->alphabet().find(next_char) == std::string::npos)
+            return next;
+
+        return delta_to_node(
+            delta_->kmer_to_node(base_->get_node_sequence(node).substr(1) + next_char)
+        );
+    }
+
+    if (delta_->alphabet().find(next_char) == std::string::npos)
+        return npos;
+
+    if (node_index next = delta_->traverse(node - offset_, next_char))
+        return offset_ + next;
+
+    return base_->kmer_to_node(delta_->get_node_sequence(node - offset_).substr(1) + next_char);
+}
+
+DeBruijnGraph::node_index DeltaDBG::traverse_back(node_index node, char prev_char) const {
+    assert(node > 0 && node <= max_index());
+
+    if (!in_delta(node)) {
+        node_index prev = base_->traverse_back(node, prev_char);
+        if (prev || !boundary_.count(node)
+                || delta_->alphabet().find(prev_char) == std::string::npos)
+            return prev;
+
+        return delta_to_node(delta_->kmer_to_node(
+            prev_char + base_->get_node_sequence(node).substr(0, get_k() - 1)
+        ));
+    }
+
+    if (delta_->alphabet().find(prev_char) == std::string::npos)
+        return npos;
+
+    if (node_index prev = delta_->traverse_back(node - offset_, prev_char))
+        return offset_ + prev;
+
+    return base_->kmer_to_node(
+        prev_char + delta_->get_node_sequence(node - offset_).substr(0, get_k() - 1)
+    );
+}
+
+size_t DeltaDBG::outdegree(node_index node) const {
+    if (!in_delta(node) && !boundary_.count(node))
+        return base_->outdegree(node);
+
+    size_t outdegree = 0;
+    call_outgoing_kmers(node, [&](node_index, char) { outdegree++; });
+    return outdegree;
+}
+
+size_t DeltaDBG::indegree(node_index node) const {
+    if (!in_delta(node) && !boundary_.count(node))
+        return base_->indegree(node);
+
+    size_t indegree = 0;
+    call_incoming_kmers(node, [&](node_index, char) { indegree++; });
+    return indegree;
+}
+
+void DeltaDBG::call_nodes(const std::function<void(node_index)> &callback,
+                          const std::function<bool()> &stop_early) const {
+    base_->call_nodes(callback, stop_early);
+
+    for (node_index node = 1; node <= delta_->num_nodes() && !stop_early(); ++node) {
+        callback(offset_ + node);
+    }
+}
+
+std::string DeltaDBG::get_node_sequence(node_index node) const {
+    assert(node > 0 && node <= max_index());
+
+    return in_delta(node) ? delta_->get_node_sequence(node - offset_)
+                          : base_->get_node_sequence(node);
+}
+
+bool DeltaDBG::load(const std::string &filename_base) {
+    if (!delta_->load(utils::remove_suffix(filename_base, kExtension) + kExtension))
+        return false;
+
+    if (delta_->get_k() != get_k()
+            || delta_->is_canonical_mode() != is_canonical_mode()) {
+        logger->error("The delta graph is incompatible with the base graph");
+        return false;
+    }
+
+    boundary_.clear();
+    for (node_index node = 1; node <= delta_->num_nodes(); ++node) {
+        update_boundary(node);
+    }
+
+    return true;
+}
+
+void DeltaDBG::serialize(const std::string &filename_base) const {
+    delta_->serialize(utils::remove_suffix(filename_base, kExtension) + kExtension);
+}
+
+} // namespace graph
+} // namespace mtg
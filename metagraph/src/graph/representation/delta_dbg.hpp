@@ -0,0 +1,138 @@
+#ifndef __DELTA_DBG_HPP__
+#define __DELTA_DBG_HPP__
+
+#include <cassert>
+#include <memory>
+
+#include <tsl/hopscotch_set.h>
+
+#include "graph/representation/base/sequence_graph.hpp"
+#include "graph/representation/hash/dbg_hash_ordered.hpp"
+
+
+namespace mtg {
+namespace graph {
+
+/**
+ * DeltaDBG is an overlay of a static DeBruijnGraph (e.g., DBGSuccinct) and
+ * a small hash-based delta graph storing the k-mers added afterwards. This
+ * allows for fast incremental updates of a static graph, while the combined
+ * graph can be queried as a regular DeBruijnGraph.
+ *
+ * The nodes of the base graph keep their indexes [1, ..., base.max_index()],
+ * the nodes of the delta graph are indexed after them. Every k-mer is stored
+ * either in the base graph or in the delta, never in both.
+ *
+ * Multithreading:
+ *  add_sequence must be called sequentially. Then, the const methods can be
+ *  called concurrently.
+ */
+class DeltaDBG : public DeBruijnGraph {
+  public:
+    explicit DeltaDBG(std::shared_ptr<const DeBruijnGraph> base);
+
+    virtual ~DeltaDBG() {}
+
+    // Insert the k-mers of |sequence| missing in the base graph into the delta
+    // and invoke callback |on_insertion| for each new node created in the graph.
+    virtual void add_sequence(std::string_view sequence,
+                              const std::function<void(node_index)> &on_insertion = [](node_index) {}) override;
+
+    // Traverse graph mapping sequence to the graph nodes
+    // and run callback for each node until the termination condition is satisfied
+    virtual void map_to_nodes(std::string_view sequence,
+                              const std::function<void(node_index)> &callback,
+                              const std::function<bool()> &terminate = [](){ return false; }) const override;
+
+    // Traverse graph mapping sequence to the graph nodes
+    // and run callback for each node until the termination condition is satisfied.
+    // Guarantees that nodes are called in the same order as the input sequence
+    virtual void map_to_nodes_sequentially(std::string_view sequence,
+                                           const std::function<void(node_index)> &callback,
+                                           const std::function<bool()> &terminate = [](){ return false; }) const override;
+
+    // Given a node index, call the target nodes of all edges outgoing from it.
+    virtual void adjacent_outgoing_nodes(node_index node,
+                                         const std::function<void(node_index)> &callback) const override;
+
+    // Given a node index, call the source nodes of all edges incoming to it.
+    virtual void adjacent_incoming_nodes(node_index node,
+                                         const std::function<void(node_index)> &callback) const override;
+
+    virtual void call_outgoing_kmers(node_index kmer,
+                                     const OutgoingEdgeCallback &callback) const override;
+
+    virtual void call_incoming_kmers(node_index kmer,
+                                     const IncomingEdgeCallback &callback) const override;
+
+    // Traverse the outgoing edge
+    virtual node_index traverse(node_index node, char next_char) const override;
+    // Traverse the incoming edge
+    virtual node_index traverse_back(node_index node, char prev_char) const override;
+
+    virtual size_t outdegree(node_index node) const override;
+    virtual size_t indegree(node_index node) const override;
+
+    virtual void call_nodes(const std::function<void(node_index)> &callback,
+                            const std::function<bool()> &stop_early = [](){ return false; }) const override;
+
+    virtual uint64_t num_nodes() const override {
+        return base_->num_nodes() + delta_->num_nodes();
+    }
+    virtual uint64_t max_index() const override { return offset_ + delta_->num_nodes(); }
+
+    // Load the delta graph. The base graph must be the one it was built for.
+    virtual bool load(const std::string &filename_base) override;
+    // Serialize the delta graph only
+    virtual void serialize(const std::string &filename_base) const override;
+
+    virtual std::string file_extension() const override { return kExtension; }
+
+    virtual const std::string& alphabet() const override { return base_->alphabet(); }
+
+    // Get string corresponding to |node_index|.
+    // Note: Not efficient if sequences in nodes overlap. Use sparingly.
+    virtual std::string get_node_sequence(node_index node) const override;
+
+    virtual size_t get_k() const override { return base_->get_k(); }
+
+    virtual bool is_canonical_mode() const override { return base_->is_canonical_mode(); }
+
+    const DeBruijnGraph& get_base_graph() const { return *base_; }
+    std::shared_ptr<const DeBruijnGraph> get_base_graph_ptr() const { return base_; }
+
+    const DBGHashOrdered& get_delta_graph() const { return *delta_; }
+
+    inline bool in_delta(node_index node) const {
+        assert(node > 0 && node <= max_index());
+        return node > offset_;
+    }
+
+    static constexpr auto kExtension = ".delta.orhashdbg";
+
+  private:
+    inline node_index delta_to_node(node_index delta_node) const {
+        return delta_node ? offset_ + delta_node : npos;
+    }
+
+    // call the nodes of both graphs with |map_to_nodes| for every k-mer
+    void call_mapped_nodes(const std::function<void(const DeBruijnGraph &,
+                                                    const std::function<void(node_index)> &)> &map_to_nodes,
+                           const std::function<void(node_index)> &callback,
+                           const std::function<bool()> &terminate) const;
+
+    // mark the nodes of the base graph adjacent to the new node of the delta graph
+    void update_boundary(node_index delta_node);
+
+    std::shared_ptr<const DeBruijnGraph> base_;
+    std::unique_ptr<DBGHashOrdered> delta_;
+    uint64_t offset_;
+
+    // nodes of the base graph adjacent to at least one node of the delta graph
+    tsl::hopscotch_set<node_index> boundary_;
+};
+
+} // namespace graph
+} // namespace mtg
+
+#endif // __DELTA_DBG_HPP__
@@ -23,6 +23,7 @@
 #include "common/vectors/bit_vector_dyn.hpp"
 #include "common/vectors/bit_vector_adaptive.hpp"
 #include "boss_construct.hpp"
+#include "interleaved_edges.hpp"
 
 
 namespace mtg {
@@ -47,6 +48,8 @@ const size_t MAX_ITER_WAVELET_TREE_FAST = 1000;
 const size_t MAX_ITER_WAVELET_TREE_DYN = 6;
 const size_t MAX_ITER_WAVELET_TREE_STAT = 20;
 const size_t MAX_ITER_WAVELET_TREE_SMALL = 1;
+const size_t MAX_ITER_WAVELET_TREE_OCC = 10;
+const size_t MAX_ITER_WAVELET_TREE_INTERLEAVED = 10;
 
 static const uint64_t kBlockSize = 9'999'872;
 static_assert(!(kBlockSize & 0xFF));
@@ -305,6 +308,16 @@ bool BOSS::load(std::ifstream &instream) {
                 W_ = new wavelet_tree_small(bits_per_char_W_);
                 last_ = new bit_vector_small();
                 break;
+            case State::OCC:
+                W_ = new wavelet_tree_occ(bits_per_char_W_);
+                last_ = new bit_vector_stat();
+                break;
+            case State::INTERLEAVED: {
+                auto edges = std::make_shared<InterleavedEdges>(bits_per_char_W_);
+                W_ = new InterleavedEdges::SymbolView(edges);
+                last_ = new InterleavedEdges::BitView(edges, InterleavedEdges::LAST);
+                break;
+            }
         }
         if (!W_->load(instream)) {
             std::cerr << "ERROR: failed to load W vector" << std::endl;
@@ -419,6 +432,12 @@ edge_index BOSS::pred_W(edge_index i, TAlphabet c_first, TAlphabet c_second) con
         case FAST:
             max_iter = MAX_ITER_WAVELET_TREE_FAST;
             break;
+        case OCC:
+            max_iter = MAX_ITER_WAVELET_TREE_OCC;
+            break;
+        case INTERLEAVED:
+            max_iter = MAX_ITER_WAVELET_TREE_INTERLEAVED;
+            break;
     }
 
     edge_index end = i - std::min(i, max_iter);
@@ -477,6 +496,12 @@ BOSS::succ_W(edge_index i, TAlphabet c_first, TAlphabet c_second) const {
         case FAST:
             max_iter = MAX_ITER_WAVELET_TREE_FAST;
             break;
+        case OCC:
+            max_iter = MAX_ITER_WAVELET_TREE_OCC;
+            break;
+        case INTERLEAVED:
+            max_iter = MAX_ITER_WAVELET_TREE_INTERLEAVED;
+            break;
     }
 
     edge_index end = i + std::min(W_->size() - i, max_iter);
@@ -1084,10 +1109,33 @@ void BOSS::switch_state(State new_state) {
             convert<wavelet_tree_dyn, bit_vector_dyn>(&W_, &last_);
             break;
         }
+        case State::OCC: {
+            convert<wavelet_tree_occ, bit_vector_stat>(&W_, &last_);
+            break;
+        }
+        case State::INTERLEAVED: {
+            auto edges = std::make_shared<InterleavedEdges>(bits_per_char_W_);
+            edges->set_symbols(W_->to_vector());
+            delete W_;
+            W_ = new InterleavedEdges::SymbolView(edges);
+
+            edges->set_bits(InterleavedEdges::LAST, last_->to_vector());
+            delete last_;
+            last_ = new InterleavedEdges::BitView(edges, InterleavedEdges::LAST);
+            break;
+        }
     }
     state = new_state;
 }
 
+std::unique_ptr<bit_vector> BOSS::interleave_mask(const sdsl::bit_vector &mask) {
+    assert(state == State::INTERLEAVED);
+
+    const auto &edges = dynamic_cast<const InterleavedEdges::SymbolView&>(*W_).get_storage();
+    edges->set_bits(InterleavedEdges::MASK, mask);
+    return std::make_unique<InterleavedEdges::BitView>(edges, InterleavedEdges::MASK);
+}
+
 void BOSS::print_internal_representation(std::ostream &os) const {
     os << "F:";
     for (auto i : F_) {
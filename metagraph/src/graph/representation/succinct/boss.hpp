@@ -100,6 +100,13 @@ class BOSS {
     std::vector<edge_index>
     map_to_edges(const std::vector<TAlphabet> &seq_encoded) const;
 
+    /**
+     * Given a (k+1)-mer, this function returns the index
+     * of the corresponding edge, if such exists and 0 otherwise.
+     */
+    template <typename RandomAccessIt>
+    inline edge_index map_to_edge(RandomAccessIt begin, RandomAccessIt end) const;
+
     template <class... T>
     using Call = typename std::function<void(T...)>;
 
@@ -306,12 +313,28 @@ class BOSS {
      *      Representation:
      *          last -- bit_vector_dyn
      *             W -- wavelet_tree_dyn
+     *
+     * OCC: has the fastest rank on W, only for small alphabets (e.g., DNA)
+     *      Representation:
+     *          last -- bit_vector_stat
+     *             W -- wavelet_tree_occ
+     *
+     * INTERLEAVED: stores W and last of each edge in the same cache line,
+     *              only for small alphabets (e.g., DNA)
+     *      Representation:
+     *          last, W -- InterleavedEdges
      */
-    enum State { SMALL = 1, DYN, STAT, FAST };
+    enum State { SMALL = 1, DYN, STAT, FAST, OCC, INTERLEAVED };
 
     State get_state() const { return state; }
     void switch_state(State state);
 
+    /**
+     * Store the edge mask |mask| next to W and last in the INTERLEAVED state
+     * and return a view on it.
+     */
+    std::unique_ptr<bit_vector> interleave_mask(const sdsl::bit_vector &mask);
+
     /**
      * Write the adjacency list to file |filename| or
      * print it to stdout of the filename is not provided.
@@ -542,13 +565,6 @@ class BOSS {
      */
     bool compare_node_suffix(edge_index first, const TAlphabet *second) const;
 
-    /**
-     * Given a (k+1)-mer, this function returns the index
-     * of the corresponding edge, if such exists and 0 otherwise.
-     */
-    template <typename RandomAccessIt>
-    inline edge_index map_to_edge(RandomAccessIt begin, RandomAccessIt end) const;
-
     /**
      * Maps a prefix of the query to a range of nodes in the BOSS table
      * with the same suffixes.
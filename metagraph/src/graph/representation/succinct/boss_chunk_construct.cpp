@@ -4,6 +4,7 @@
 
 #include "common/elias_fano_file_merger.hpp"
 #include "common/logger.hpp"
+#include "common/seq_tools/reverse_complement.hpp"
 #include "common/sorted_sets/sorted_multiset.hpp"
 #include "common/sorted_sets/sorted_multiset_disk.hpp"
 #include "common/sorted_sets/sorted_set.hpp"
@@ -955,7 +956,8 @@ class BOSSChunkConstructor : public IBOSSChunkConstructor {
                          size_t num_threads,
                          double memory_preallocated,
                          const std::filesystem::path &swap_dir,
-                         size_t disk_cap_bytes)
+                         size_t disk_cap_bytes,
+                         size_t num_superkmer_bins)
         : swap_dir_(swap_dir),
           kmer_collector_(k + 1,
                           both_strands_mode,
@@ -964,7 +966,8 @@ class BOSSChunkConstructor : public IBOSSChunkConstructor {
                           memory_preallocated,
                           swap_dir,
                           disk_cap_bytes,
-                          both_strands_mode && filter_suffix.empty() /* keep only canonical k-mers */),
+                          both_strands_mode && filter_suffix.empty() /* keep only canonical k-mers */,
+                          num_superkmer_bins),
           bits_per_count_(bits_per_count) {
         if (filter_suffix.size()
                 && filter_suffix == std::string(filter_suffix.size(), BOSS::kSentinel)) {
@@ -1132,9 +1135,11 @@ IBOSSChunkConstructor::initialize(size_t k,
                                   double memory_preallocated,
                                   kmer::ContainerType container_type,
                                   const std::filesystem::path &swap_dir,
-                                  size_t disk_cap_bytes) {
+                                  size_t disk_cap_bytes,
+                                  size_t num_superkmer_bins) {
 #define OTHER_ARGS k, canonical_mode, bits_per_count, filter_suffix, \
-                   num_threads, memory_preallocated, swap_dir, disk_cap_bytes
+                   num_threads, memory_preallocated, swap_dir, disk_cap_bytes, \
+                   num_superkmer_bins
 
     switch (container_type) {
         case kmer::ContainerType::VECTOR:
@@ -1169,6 +1174,318 @@ IBOSSChunkConstructor::initialize(size_t k,
     }
 }
 
+
+/**
+ * Collects the k-mers with all the given suffixes in a single container.
+ * The k-mers are extracted from each sequence only once and the ones with
+ * suffixes not in the list are skipped. The suffixes are formed by the most
+ * significant characters of the k-mers, hence, the k-mers with the same suffix
+ * form a contiguous range in the sorted container and are dispatched to the
+ * chunk of that suffix in a single pass.
+ */
+template <typename KMER, class Container>
+class BOSSMultiChunkConstructor : public IBOSSMultiChunkConstructor {
+  public:
+    BOSSMultiChunkConstructor(size_t k,
+                              bool both_strands_mode,
+                              uint8_t bits_per_count,
+                              const std::vector<std::string> &suffixes,
+                              size_t num_threads,
+                              double memory_preallocated,
+                              const std::filesystem::path &swap_dir,
+                              size_t disk_cap_bytes)
+          : k_(k),
+            both_strands_mode_(both_strands_mode),
+            bits_per_count_(bits_per_count),
+            num_suffixes_(suffixes.size()),
+            suffix_length_(suffixes.at(0).size()),
+            swap_dir_(swap_dir),
+            thread_pool_(std::max(static_cast<size_t>(1), num_threads), 1) {
+        if (!suffix_length_ || suffix_length_ > k_)
+            throw std::runtime_error("Invalid length of k-mer suffixes");
+
+        // index the suffixes by their codes
+        size_t num_codes = 1;
+        for (size_t i = 0; i < suffix_length_; ++i) {
+            num_codes *= KmerExtractorBOSS::alphabet.size();
+        }
+        suffix_index_.assign(num_codes, num_suffixes_);
+        for (size_t i = 0; i < suffixes.size(); ++i) {
+            if (suffixes[i].size() != suffix_length_)
+                throw std::runtime_error("All k-mer suffixes must have the same length");
+
+            suffix_index_[get_suffix_code(encode_filter_suffix_boss(suffixes[i]), 0)] = i;
+        }
+
+        size_t buffer_size = memory_preallocated / sizeof(typename Container::value_type);
+
+        if constexpr(utils::is_instance_v<typename Container::result_type,
+                                          common::ChunkedWaitQueue>) {
+            tmp_dir_ = utils::create_temp_dir(swap_dir, "kmers");
+            kmers_ = std::make_unique<Container>(num_threads, buffer_size,
+                                                 tmp_dir_, disk_cap_bytes);
+        } else {
+            kmers_ = std::make_unique<Container>(num_threads, buffer_size);
+        }
+
+        // the chunk with suffix $...$ contains the k-mer $...$
+        const KMER sentinel(std::vector<TAlphabet>(k_ + 1, BOSS::kSentinelCode));
+        if (get_suffix_index(sentinel) < num_suffixes_)
+            kmers_->insert(&sentinel.data(), &sentinel.data() + 1);
+    }
+
+    ~BOSSMultiChunkConstructor() {
+        thread_pool_.join();
+        kmers_.reset();
+        if (!tmp_dir_.empty())
+            utils::remove_temp_dir(tmp_dir_);
+    }
+
+    void add_sequences(std::vector<std::pair<std::string, uint64_t>>&& sequences) {
+        // share the batch with the task to avoid copying it
+        auto batch = std::make_shared<std::vector<std::pair<std::string, uint64_t>>>(
+            std::move(sequences)
+        );
+        thread_pool_.enqueue([this,batch]() { extract_kmers(*batch); });
+    }
+
+    void call_chunks(const std::function<void(size_t, BOSS::Chunk&&)> &callback) {
+        thread_pool_.join();
+
+        using T_INT = typename Container::result_type::value_type;
+        using T = get_kmer_t<KMER, T_INT>;
+
+        std::vector<bool> called(num_suffixes_, false);
+        Vector<T> chunk_kmers;
+        size_t suffix = num_suffixes_;
+
+        auto call_chunk = [&]() {
+            callback(suffix, BOSS::Chunk(KmerExtractorBOSS::alphabet.size(), k_,
+                                         both_strands_mode_, chunk_kmers,
+                                         bits_per_count_, swap_dir_));
+            called[suffix] = true;
+            chunk_kmers.resize(0);
+        };
+
+        auto dispatch = [&](const T &value) {
+            size_t next_suffix = get_suffix_index(get_first(value));
+            assert(next_suffix < num_suffixes_);
+            if (next_suffix != suffix) {
+                if (suffix < num_suffixes_)
+                    call_chunk();
+
+                assert(!called[next_suffix] && "k-mers must be sorted");
+                suffix = next_suffix;
+            }
+            chunk_kmers.push_back(value);
+        };
+
+        auto &data = reinterpret_container<T>(kmers_->data());
+        if constexpr(utils::is_instance_v<std::decay_t<decltype(data)>,
+                                          common::ChunkedWaitQueue>) {
+            for (auto &it = data.begin(); it != data.end(); ++it) {
+                dispatch(*it);
+            }
+        } else {
+            for (const T &value : data) {
+                dispatch(value);
+            }
+        }
+
+        if (suffix < num_suffixes_)
+            call_chunk();
+
+        kmers_->clear();
+
+        // the suffixes without k-mers get empty chunks
+        for (suffix = 0; suffix < num_suffixes_; ++suffix) {
+            if (!called[suffix])
+                call_chunk();
+        }
+    }
+
+    uint64_t get_k() const { return k_; }
+
+  private:
+    // encode the |suffix_length_| characters starting at position |begin|
+    template <class Array>
+    size_t get_suffix_code(const Array &kmer, size_t begin) const {
+        size_t code = 0;
+        for (size_t i = begin; i < begin + suffix_length_; ++i) {
+            code = code * KmerExtractorBOSS::alphabet.size() + kmer[i];
+        }
+        return code;
+    }
+
+    // BOSS::k_ + 1 characters, the suffix ends at the last character of the node
+    size_t get_suffix_index(const KMER &kmer) const {
+        return suffix_index_[get_suffix_code(kmer, k_ + 1 - suffix_length_)];
+    }
+
+    void extract_kmers(const std::vector<std::pair<std::string, uint64_t>> &sequences) {
+        using Key = typename KMER::WordType;
+        using Value = typename Container::value_type;
+
+        Vector<KMER> buffer;
+        Vector<Value> buffer_values;
+        buffer.reserve(kBufferSize);
+        buffer_values.reserve(kBufferSize);
+
+        for (const auto &[sequence, count] : sequences) {
+            KmerExtractorBOSS::sequence_to_kmers(sequence, k_ + 1, {}, &buffer,
+                                                 false, true);
+            if (both_strands_mode_) {
+                std::string rev_read = sequence;
+                reverse_complement(rev_read.begin(), rev_read.end());
+                KmerExtractorBOSS::sequence_to_kmers(rev_read, k_ + 1, {}, &buffer,
+                                                     false, true);
+            }
+
+            for (const KMER &kmer : buffer) {
+                if (get_suffix_index(kmer) == num_suffixes_)
+                    continue;
+
+                if constexpr(std::is_same_v<Key, Value>) {
+                    buffer_values.push_back(kmer.data());
+                } else {
+                    buffer_values.emplace_back(kmer.data(),
+                                               std::min(count, kmers_->max_count()));
+                }
+            }
+
+            if (buffer.capacity() > 2 * kBufferSize)
+                buffer = Vector<KMER>(kBufferSize);
+
+            buffer.resize(0);
+
+            if (buffer_values.size() > 0.9 * kBufferSize) {
+                kmers_->insert(buffer_values.begin(), buffer_values.end());
+
+                if (buffer_values.capacity() > 2 * kBufferSize)
+                    buffer_values = Vector<Value>(kBufferSize);
+
+                buffer_values.resize(0);
+            }
+        }
+
+        if (buffer_values.size())
+            kmers_->insert(buffer_values.begin(), buffer_values.end());
+    }
+
+    static constexpr size_t kBufferSize = 100'000;
+
+    size_t k_;
+    bool both_strands_mode_;
+    uint8_t bits_per_count_;
+    size_t num_suffixes_;
+    size_t suffix_length_;
+    // maps the codes of the suffixes to their indexes, |num_suffixes_| if skipped
+    std::vector<size_t> suffix_index_;
+    std::filesystem::path swap_dir_;
+    std::filesystem::path tmp_dir_;
+    std::unique_ptr<Container> kmers_;
+    ThreadPool thread_pool_;
+};
+
+template <template <typename> class Container>
+static std::unique_ptr<IBOSSMultiChunkConstructor>
+initialize_boss_multi_chunk_constructor(size_t k,
+                                        bool canonical_mode,
+                                        uint8_t bits_per_count,
+                                        const std::vector<std::string> &suffixes,
+                                        size_t num_threads,
+                                        double memory_preallocated,
+                                        const std::filesystem::path &swap_dir,
+                                        size_t disk_cap_bytes) {
+    if (k < 1 || k > 256 / KmerExtractorBOSS::bits_per_char - 1) {
+        // DBGSuccinct::k = BOSS::k + 1
+        logger->error("For succinct graph, k must be between 2 and {}",
+                      256 / KmerExtractorBOSS::bits_per_char);
+        exit(1);
+    }
+
+#define ARGS k, canonical_mode, bits_per_count, suffixes, num_threads, \
+             memory_preallocated, swap_dir, disk_cap_bytes
+
+    if ((k + 1) * KmerExtractorBOSS::bits_per_char <= 64) {
+        using KMER = KmerExtractorBOSS::Kmer64;
+        return std::make_unique<BOSSMultiChunkConstructor<
+                KMER, Container<typename KMER::WordType>>>(ARGS);
+
+    } else if ((k + 1) * KmerExtractorBOSS::bits_per_char <= 128) {
+        using KMER = KmerExtractorBOSS::Kmer128;
+        return std::make_unique<BOSSMultiChunkConstructor<
+                KMER, Container<typename KMER::WordType>>>(ARGS);
+
+    } else {
+        using KMER = KmerExtractorBOSS::Kmer256;
+        return std::make_unique<BOSSMultiChunkConstructor<
+                KMER, Container<typename KMER::WordType>>>(ARGS);
+    }
+#undef ARGS
+}
+
+template <typename T>
+using SortedSetVector = common::SortedSet<T>;
+template <typename T>
+using SortedMultiset8 = common::SortedMultiset<T, uint8_t>;
+template <typename T>
+using SortedMultiset16 = common::SortedMultiset<T, uint16_t>;
+template <typename T>
+using SortedMultiset32 = common::SortedMultiset<T, uint32_t>;
+template <typename T>
+using SortedSetDisk = common::SortedSetDisk<T>;
+template <typename T>
+using SortedMultisetDisk8 = common::SortedMultisetDisk<T, uint8_t>;
+template <typename T>
+using SortedMultisetDisk16 = common::SortedMultisetDisk<T, uint16_t>;
+template <typename T>
+using SortedMultisetDisk32 = common::SortedMultisetDisk<T, uint32_t>;
+
+std::unique_ptr<IBOSSMultiChunkConstructor>
+IBOSSMultiChunkConstructor::initialize(size_t k,
+                                       bool canonical_mode,
+                                       uint8_t bits_per_count,
+                                       const std::vector<std::string> &suffixes,
+                                       size_t num_threads,
+                                       double memory_preallocated,
+                                       kmer::ContainerType container_type,
+                                       const std::filesystem::path &swap_dir,
+                                       size_t disk_cap_bytes) {
+#define MULTI_ARGS k, canonical_mode, bits_per_count, suffixes, num_threads, \
+                   memory_preallocated, swap_dir, disk_cap_bytes
+
+    if (bits_per_count > 32)
+        throw std::runtime_error("Error: trying to allocate too many bits per k-mer count");
+
+    switch (container_type) {
+        case kmer::ContainerType::VECTOR:
+            if (!bits_per_count) {
+                return initialize_boss_multi_chunk_constructor<SortedSetVector>(MULTI_ARGS);
+            } else if (bits_per_count <= 8) {
+                return initialize_boss_multi_chunk_constructor<SortedMultiset8>(MULTI_ARGS);
+            } else if (bits_per_count <= 16) {
+                return initialize_boss_multi_chunk_constructor<SortedMultiset16>(MULTI_ARGS);
+            } else {
+                return initialize_boss_multi_chunk_constructor<SortedMultiset32>(MULTI_ARGS);
+            }
+        case kmer::ContainerType::VECTOR_DISK:
+            if (!bits_per_count) {
+                return initialize_boss_multi_chunk_constructor<SortedSetDisk>(MULTI_ARGS);
+            } else if (bits_per_count <= 8) {
+                return initialize_boss_multi_chunk_constructor<SortedMultisetDisk8>(MULTI_ARGS);
+            } else if (bits_per_count <= 16) {
+                return initialize_boss_multi_chunk_constructor<SortedMultisetDisk16>(MULTI_ARGS);
+            } else {
+                return initialize_boss_multi_chunk_constructor<SortedMultisetDisk32>(MULTI_ARGS);
+            }
+        default:
+            logger->error("Invalid container type {}", (int)container_type);
+            std::exit(1);
+    }
+#undef MULTI_ARGS
+}
+
 } // namespace boss
 } // namespace graph
 } // namespace mtg
@@ -5,6 +5,8 @@
 #include <cstdint>
 #include <filesystem>
 #include <functional>
+#include <memory>
+#include <vector>
 
 #include "kmer/kmer_collector_config.hpp"
 #include "graph/representation/base/dbg_construct.hpp"
@@ -28,8 +30,44 @@ class IBOSSChunkConstructor : public IGraphChunkConstructor<BOSS::Chunk> {
                double memory_preallocated = 0,
                mtg::kmer::ContainerType container_type = mtg::kmer::ContainerType::VECTOR,
                const std::filesystem::path &swap_dir = "/tmp/",
+               size_t disk_cap_bytes = 1e9,
+               size_t num_superkmer_bins = 0);
+
+    virtual uint64_t get_k() const = 0;
+};
+
+/**
+ * Collects the k-mers for the chunks of several k-mer suffixes in a single
+ * pass over the input. The k-mers of each sequence are extracted only once by
+ * a single thread pool and each of them is dispatched to the chunk of its
+ * suffix. The chunks are the same as constructed by IBOSSChunkConstructor
+ * for each of the suffixes separately.
+ */
+class IBOSSMultiChunkConstructor {
+  public:
+    virtual ~IBOSSMultiChunkConstructor() {}
+
+    // All |suffixes| must be of the same length
+    static std::unique_ptr<IBOSSMultiChunkConstructor>
+    initialize(size_t k,
+               bool canonical_mode,
+               uint8_t bits_per_count,
+               const std::vector<std::string> &suffixes,
+               size_t num_threads = 1,
+               double memory_preallocated = 0,
+               mtg::kmer::ContainerType container_type = mtg::kmer::ContainerType::VECTOR,
+               const std::filesystem::path &swap_dir = "/tmp/",
                size_t disk_cap_bytes = 1e9);
 
+    virtual void add_sequences(std::vector<std::pair<std::string, uint64_t>>&& sequences) = 0;
+
+    /**
+     * Build the chunks and call them with the indexes of their suffixes.
+     * Only one chunk is kept in memory at a time. Can be called only once.
+     */
+    virtual void call_chunks(const std::function<void(size_t /* suffix index */,
+                                                      BOSS::Chunk&&)> &callback) = 0;
+
     virtual uint64_t get_k() const = 0;
 };
 
@@ -6,6 +6,7 @@
 #include <string>
 #include <filesystem>
 
+#include "common/algorithms.hpp"
 #include "common/seq_tools/reverse_complement.hpp"
 #include "common/serialization.hpp"
 #include "common/logger.hpp"
@@ -14,6 +15,7 @@
 #include "common/vectors/bit_vector_sdsl.hpp"
 #include "common/vectors/bit_vector_dyn.hpp"
 #include "common/vectors/bit_vector_adaptive.hpp"
+#include "interleaved_edges.hpp"
 
 
 namespace mtg {
@@ -270,6 +272,74 @@ void DBGSuccinct::map_to_nodes_sequentially(std::string_view sequence,
     );
 }
 
+void DBGSuccinct
+::map_to_nodes_with_rc(std::string_view sequence,
+                       const std::function<void(node_index, bool)> &callback,
+                       const std::function<bool()> &terminate) const {
+    const size_t k = get_k();
+
+    if (sequence.size() < k)
+        return;
+
+    std::string sequence_rev_compl(sequence.begin(), sequence.end());
+    reverse_complement(sequence_rev_compl.begin(), sequence_rev_compl.end());
+
+    const auto encoded = boss_graph_->encode(sequence);
+    const auto encoded_rc = boss_graph_->encode(sequence_rev_compl);
+
+    // mark where k-mers with invalid characters end
+    auto invalid = utils::drag_and_mark_segments(encoded, boss_graph_->alph_size, k);
+
+    auto is_missing = get_missing_kmer_skipper(bloom_filter_.get(), sequence);
+
+    // the nodes of the previous k-mer and of its reverse complement
+    node_index node = npos;
+    node_index rc_node = npos;
+
+    for (size_t i = 0; i + k <= sequence.size() && !terminate(); ++i) {
+        // the Bloom filter only stores the k-mers in the forward orientation
+        bool skip_forward = is_missing();
+
+        if (invalid[i + k - 1]) {
+            node = npos;
+            rc_node = npos;
+            callback(npos, false);
+            continue;
+        }
+
+        if (skip_forward) {
+            node = npos;
+        } else if (node) {
+            node = traverse(node, sequence[i + k - 1]);
+        } else {
+            node = boss_to_kmer_index(
+                boss_graph_->map_to_edge(encoded.data() + i, encoded.data() + i + k)
+            );
+        }
+
+        if (node) {
+            // the reverse complement is only looked up for missing k-mers
+            rc_node = npos;
+            callback(node, false);
+            continue;
+        }
+
+        // the reverse complement of this k-mer is the reverse complement of
+        // the previous one, prepended with the complement of the last character
+        size_t rc_begin = sequence.size() - i - k;
+        if (rc_node) {
+            rc_node = traverse_back(rc_node, sequence_rev_compl[rc_begin]);
+        } else {
+            rc_node = boss_to_kmer_index(
+                boss_graph_->map_to_edge(encoded_rc.data() + rc_begin,
+                                         encoded_rc.data() + rc_begin + k)
+            );
+        }
+
+        callback(rc_node, rc_node != npos);
+    }
+}
+
 void DBGSuccinct
 ::call_nodes_with_suffix_matching_longest_prefix(
             std::string_view str,
@@ -712,6 +782,16 @@ bool DBGSuccinct::load(const std::string &filename) {
             valid_edges_.reset(new bit_vector_small());
             break;
         }
+        case BOSS::State::OCC: {
+            valid_edges_.reset(new bit_vector_stat());
+            break;
+        }
+        case BOSS::State::INTERLEAVED: {
+            valid_edges_ = boss_graph_->interleave_mask(
+                sdsl::bit_vector(boss_graph_->get_last().size(), false)
+            );
+            break;
+        }
     }
 
     // load the mask of valid edges (all non-dummy including npos 0)
@@ -786,7 +866,11 @@ void DBGSuccinct::serialize(const std::string &filename) const {
         || (boss_graph_->get_state() == BOSS::State::DYN
                 && dynamic_cast<const bit_vector_dyn*>(valid_edges_.get()))
         || (boss_graph_->get_state() == BOSS::State::SMALL
-                && dynamic_cast<const bit_vector_small*>(valid_edges_.get())));
+                && dynamic_cast<const bit_vector_small*>(valid_edges_.get()))
+        || (boss_graph_->get_state() == BOSS::State::OCC
+                && dynamic_cast<const bit_vector_stat*>(valid_edges_.get()))
+        || (boss_graph_->get_state() == BOSS::State::INTERLEAVED
+                && dynamic_cast<const InterleavedEdges::BitView*>(valid_edges_.get())));
 
     const auto out_filename = prefix + kDummyMaskExtension;
     std::ofstream outstream(out_filename, std::ios::binary);
@@ -808,6 +892,15 @@ void DBGSuccinct::switch_state(BOSS::State new_state) {
     if (get_state() == new_state)
         return;
 
+    if (new_state == BOSS::State::INTERLEAVED) {
+        // the mask is stored together with the BOSS table
+        boss_graph_->switch_state(new_state);
+        if (valid_edges_.get())
+            valid_edges_ = boss_graph_->interleave_mask(valid_edges_->to_vector());
+
+        return;
+    }
+
     if (valid_edges_.get()) {
         switch (new_state) {
             case BOSS::State::STAT: {
@@ -834,6 +927,16 @@ void DBGSuccinct::switch_state(BOSS::State new_state) {
                 );
                 break;
             }
+            case BOSS::State::OCC: {
+                valid_edges_ = std::make_unique<bit_vector_stat>(
+                    valid_edges_->convert_to<bit_vector_stat>()
+                );
+                break;
+            }
+            case BOSS::State::INTERLEAVED: {
+                assert(false && "handled above");
+                break;
+            }
         }
     }
 
@@ -853,6 +956,12 @@ BOSS::State DBGSuccinct::get_state() const {
     assert(!valid_edges_.get()
                 || boss_graph_->get_state() != BOSS::State::SMALL
                 || dynamic_cast<const bit_vector_small*>(valid_edges_.get()));
+    assert(!valid_edges_.get()
+                || boss_graph_->get_state() != BOSS::State::OCC
+                || dynamic_cast<const bit_vector_stat*>(valid_edges_.get()));
+    assert(!valid_edges_.get()
+                || boss_graph_->get_state() != BOSS::State::INTERLEAVED
+                || dynamic_cast<const InterleavedEdges::BitView*>(valid_edges_.get()));
 
     return boss_graph_->get_state();
 }
@@ -883,6 +992,14 @@ void DBGSuccinct::mask_dummy_kmers(size_t num_threads, bool with_pruning) {
             valid_edges_ = std::make_unique<bit_vector_small>(std::move(vector_mask));
             break;
         }
+        case BOSS::State::OCC: {
+            valid_edges_ = std::make_unique<bit_vector_stat>(std::move(vector_mask));
+            break;
+        }
+        case BOSS::State::INTERLEAVED: {
+            valid_edges_ = boss_graph_->interleave_mask(vector_mask);
+            break;
+        }
     }
 
     assert(valid_edges_.get());
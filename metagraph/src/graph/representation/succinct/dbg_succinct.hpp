@@ -61,6 +61,15 @@ class DBGSuccinct : public DeBruijnGraph {
                                            const std::function<void(node_index)> &callback,
                                            const std::function<bool()> &terminate = [](){ return false; }) const override final;
 
+    // Map each k-mer of the sequence to its node, or to the node of its reverse
+    // complement if the k-mer itself is missing, in a single pass. Both
+    // orientations are extended by forward and backward traversal from the
+    // previous k-mer where possible. Calls npos for k-mers missing in both
+    // orientations. Guarantees that nodes are called in the order of the input.
+    void map_to_nodes_with_rc(std::string_view sequence,
+                              const std::function<void(node_index, bool /* is_rc */)> &callback,
+                              const std::function<bool()> &terminate = [](){ return false; }) const;
+
     virtual void call_sequences(const CallPath &callback,
                                 size_t num_threads = 1,
                                 bool kmers_in_single_form = false) const override final;
@@ -0,0 +1,347 @@
+#include "interleaved_edges.hpp"
+
+#include <stdexcept>
+
+
+namespace mtg {
+namespace graph {
+namespace boss {
+
+typedef InterleavedEdges::TAlphabet TAlphabet;
+
+// find the last index in [lo, hi) for which |less(index)| holds
+template <class Less>
+inline uint64_t last_less(uint64_t lo, uint64_t hi, const Less &less) {
+    while (hi - lo > 1) {
+        uint64_t mid = (lo + hi) / 2;
+        if (less(mid)) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+
+InterleavedEdges::InterleavedEdges(uint8_t logsigma)
+      : logsigma_(logsigma), count_(1 << logsigma, 0) {
+    if (logsigma > kMaxLogSigma) {
+        throw std::runtime_error("InterleavedEdges supports alphabets of up to "
+                                 + std::to_string(kSigma) + " symbols");
+    }
+}
+
+void InterleavedEdges::set_symbols(const sdsl::int_vector<> &symbols) {
+    if (symbols.size() != size_ || blocks_.empty()) {
+        size_ = symbols.size();
+        blocks_.assign((size_ + kBlockSize - 1) / kBlockSize, Block {});
+        uint64_t num_superblocks = (blocks_.size() + kBlocksPerSuperblock - 1)
+                                        / kBlocksPerSuperblock;
+        superblock_counts_.assign(num_superblocks * kSigma, 0);
+        superblock_ranks_.assign(num_superblocks * NUM_TRACKS, 0);
+        std::fill(std::begin(num_set_bits_), std::end(num_set_bits_), 0);
+    }
+
+    std::vector<uint64_t> counts(kSigma, 0);
+    for (uint64_t b = 0; b < blocks_.size(); ++b) {
+        auto superblock = superblock_counts_.begin() + b / kBlocksPerSuperblock * kSigma;
+        if (b % kBlocksPerSuperblock == 0)
+            std::copy(counts.begin(), counts.end(), superblock);
+
+        Block &block = blocks_[b];
+        for (size_t c = 0; c < kSigma; ++c) {
+            assert(counts[c] - superblock[c] <= 0xFFFF);
+            block.counts[c] = counts[c] - superblock[c];
+        }
+        std::fill(std::begin(block.words), std::end(block.words), 0);
+
+        const uint64_t end = std::min((b + 1) * kBlockSize, size_);
+        for (uint64_t i = b * kBlockSize; i < end; ++i) {
+            TAlphabet c = symbols[i];
+            assert(c < count_.size());
+            Symbols::set(block.words, i % kBlockSize, c);
+            counts[c]++;
+        }
+    }
+
+    std::copy(counts.begin(), counts.begin() + count_.size(), count_.begin());
+}
+
+void InterleavedEdges::set_bits(BitTrack track, const sdsl::bit_vector &bits) {
+    if (bits.size() != size_)
+        throw std::runtime_error("Incompatible size of the interleaved bit vector");
+
+    uint64_t rank = 0;
+    for (uint64_t b = 0; b < blocks_.size(); ++b) {
+        if (b % kBlocksPerSuperblock == 0)
+            superblock_ranks_[b / kBlocksPerSuperblock * NUM_TRACKS + track] = rank;
+
+        Block &block = blocks_[b];
+        block.ranks[track]
+            = rank - superblock_ranks_[b / kBlocksPerSuperblock * NUM_TRACKS + track];
+        block.bits[track] = bits.get_int(b * kBlockSize,
+                                         std::min(kBlockSize, size_ - b * kBlockSize));
+        rank += sdsl::bits::cnt(block.bits[track]);
+    }
+    num_set_bits_[track] = rank;
+}
+
+TAlphabet InterleavedEdges::get_symbol(uint64_t i) const {
+    assert(i < size());
+    return Symbols::get(blocks_[i / kBlockSize].words, i % kBlockSize);
+}
+
+uint64_t InterleavedEdges::rank(TAlphabet c, uint64_t i) const {
+    assert(c < (1llu << logsigma()));
+
+    if (!size_)
+        return 0;
+
+    i = std::min(i, size_ - 1);
+    const Block &block = blocks_[i / kBlockSize];
+    return superblock_counts_[i / kSuperblockSize * kSigma + c]
+            + block.counts[c] + Symbols::rank(block.words, c, i % kBlockSize);
+}
+
+uint64_t InterleavedEdges::select(TAlphabet c, uint64_t i) const {
+    assert(i > 0 && size() > 0);
+    assert(i <= rank(c, size() - 1));
+    assert(c < (1llu << logsigma()));
+
+    uint64_t sb = last_less(0, superblock_counts_.size() / kSigma,
+        [&](uint64_t s) { return superblock_counts_[s * kSigma + c] < i; }
+    );
+    i -= superblock_counts_[sb * kSigma + c];
+
+    uint64_t b = last_less(sb * kBlocksPerSuperblock,
+                           std::min((sb + 1) * kBlocksPerSuperblock, blocks_.size()),
+        [&](uint64_t j) { return blocks_[j].counts[c] < i; }
+    );
+
+    const Block &block = blocks_[b];
+    return b * kBlockSize + Symbols::select(block.words, c, i - block.counts[c]);
+}
+
+uint64_t InterleavedEdges::next(uint64_t i, TAlphabet c) const {
+    assert(i < size());
+    assert(c < (1llu << logsigma()));
+
+    // check the rest of the current block first
+    size_t j = Symbols::next(blocks_[i / kBlockSize].words, c, i % kBlockSize);
+    if (j < kBlockSize) {
+        // the padding in the last block may match, so cap by size
+        return std::min(i / kBlockSize * kBlockSize + j, size_);
+    }
+
+    uint64_t rk = rank(c, i) + 1;
+    return rk <= count(c) ? select(c, rk) : size();
+}
+
+uint64_t InterleavedEdges::prev(uint64_t i, TAlphabet c) const {
+    assert(i < size());
+    assert(c < (1llu << logsigma()));
+
+    // check the beginning of the current block first
+    size_t j = Symbols::prev(blocks_[i / kBlockSize].words, c, i % kBlockSize);
+    if (j < kBlockSize)
+        return i / kBlockSize * kBlockSize + j;
+
+    uint64_t rk = rank(c, i);
+    return rk ? select(c, rk) : size();
+}
+
+bool InterleavedEdges::get_bit(BitTrack track, uint64_t i) const {
+    assert(i < size());
+    return (blocks_[i / kBlockSize].bits[track] >> (i % kBlockSize)) & 1;
+}
+
+uint64_t InterleavedEdges::get_int(BitTrack track, uint64_t i, uint32_t width) const {
+    assert(width <= 64);
+    assert(i + width <= size());
+
+    uint64_t result = 0;
+    for (uint32_t shift = 0; shift < width; ) {
+        uint64_t offset = i % kBlockSize;
+        uint32_t length = std::min(kBlockSize - offset, uint64_t(width - shift));
+        uint64_t chunk = blocks_[i / kBlockSize].bits[track] >> offset;
+        result |= (chunk & sdsl::bits::lo_set[length]) << shift;
+        shift += length;
+        i += length;
+    }
+    return result;
+}
+
+uint64_t InterleavedEdges::rank1(BitTrack track, uint64_t i) const {
+    if (!size_)
+        return 0;
+
+    i = std::min(i, size_ - 1);
+    const Block &block = blocks_[i / kBlockSize];
+    // keep the bits [0, i] of the block
+    return superblock_ranks_[i / kSuperblockSize * NUM_TRACKS + track]
+            + block.ranks[track]
+            + sdsl::bits::cnt(uint64_t(block.bits[track]) << (63 - i % kBlockSize));
+}
+
+uint64_t InterleavedEdges::select1(BitTrack track, uint64_t i) const {
+    assert(i > 0 && size() > 0 && i <= num_set_bits(track));
+
+    uint64_t sb = last_less(0, superblock_ranks_.size() / NUM_TRACKS,
+        [&](uint64_t s) { return superblock_ranks_[s * NUM_TRACKS + track] < i; }
+    );
+    i -= superblock_ranks_[sb * NUM_TRACKS + track];
+
+    uint64_t b = last_less(sb * kBlocksPerSuperblock,
+                           std::min((sb + 1) * kBlocksPerSuperblock, blocks_.size()),
+        [&](uint64_t j) { return blocks_[j].ranks[track] < i; }
+    );
+    i -= blocks_[b].ranks[track];
+
+    assert(i <= sdsl::bits::cnt(blocks_[b].bits[track]));
+    return b * kBlockSize + sdsl::bits::sel(blocks_[b].bits[track], i);
+}
+
+uint64_t InterleavedEdges::select0(BitTrack track, uint64_t i) const {
+    assert(i > 0 && size() > 0 && i <= size() - num_set_bits(track));
+
+    auto zeros_before_superblock = [&](uint64_t s) {
+        return s * kSuperblockSize - superblock_ranks_[s * NUM_TRACKS + track];
+    };
+    uint64_t sb = last_less(0, superblock_ranks_.size() / NUM_TRACKS,
+        [&](uint64_t s) { return zeros_before_superblock(s) < i; }
+    );
+    i -= zeros_before_superblock(sb);
+
+    auto zeros_before_block = [&](uint64_t b) {
+        return (b % kBlocksPerSuperblock) * kBlockSize - blocks_[b].ranks[track];
+    };
+    uint64_t b = last_less(sb * kBlocksPerSuperblock,
+                           std::min((sb + 1) * kBlocksPerSuperblock, blocks_.size()),
+        [&](uint64_t j) { return zeros_before_block(j) < i; }
+    );
+    i -= zeros_before_block(b);
+
+    // the padding in the last block is beyond the last unset bit
+    uint64_t zeros = ~uint64_t(blocks_[b].bits[track]) & sdsl::bits::lo_set[kBlockSize];
+    assert(i <= sdsl::bits::cnt(zeros));
+    return b * kBlockSize + sdsl::bits::sel(zeros, i);
+}
+
+uint64_t InterleavedEdges::next1(BitTrack track, uint64_t i) const {
+    assert(i < size());
+
+    // check the rest of the current block first
+    uint64_t bits = blocks_[i / kBlockSize].bits[track] >> (i % kBlockSize);
+    if (bits)
+        return i + sdsl::bits::lo(bits);
+
+    uint64_t rk = rank1(track, i) + 1;
+    return rk <= num_set_bits(track) ? select1(track, rk) : size();
+}
+
+uint64_t InterleavedEdges::prev1(BitTrack track, uint64_t i) const {
+    assert(i < size());
+
+    // check the beginning of the current block first
+    uint64_t bits = uint64_t(blocks_[i / kBlockSize].bits[track])
+                        << (63 - i % kBlockSize);
+    if (bits)
+        return i - (63 - sdsl::bits::hi(bits));
+
+    uint64_t rk = rank1(track, i);
+    return rk ? select1(track, rk) : size();
+}
+
+void InterleavedEdges::call_ones_in_range(BitTrack track, uint64_t begin, uint64_t end,
+                                          const VoidCall<uint64_t> &callback) const {
+    assert(begin <= end);
+    assert(end <= size());
+
+    for (uint64_t b = begin / kBlockSize; b * kBlockSize < end; ++b) {
+        uint64_t bits = blocks_[b].bits[track];
+        if (b * kBlockSize < begin)
+            bits &= ~sdsl::bits::lo_set[begin - b * kBlockSize];
+        if ((b + 1) * kBlockSize > end)
+            bits &= sdsl::bits::lo_set[end - b * kBlockSize];
+
+        while (bits) {
+            callback(b * kBlockSize + sdsl::bits::lo(bits));
+            bits &= bits - 1;
+        }
+    }
+}
+
+
+////////////////////////////////////
+// Views on the interleaved edges //
+////////////////////////////////////
+
+bool InterleavedEdges::SymbolView::load(std::istream &in) {
+    if (!in.good())
+        return false;
+
+    try {
+        sdsl::int_vector<> symbols;
+        symbols.load(in);
+        edges_->set_symbols(symbols);
+        return true;
+
+    } catch (const std::bad_alloc &exception) {
+        std::cerr << "ERROR: Not enough memory to load InterleavedEdges." << std::endl;
+        return false;
+    } catch (...) {
+        return false;
+    }
+}
+
+void InterleavedEdges::SymbolView::serialize(std::ostream &out) const {
+    to_vector().serialize(out);
+}
+
+sdsl::int_vector<> InterleavedEdges::SymbolView::to_vector() const {
+    sdsl::int_vector<> vector(size(), 0, logsigma());
+    for (uint64_t i = 0; i < vector.size(); ++i) {
+        vector[i] = edges_->get_symbol(i);
+    }
+    return vector;
+}
+
+bool InterleavedEdges::BitView::load(std::istream &in) {
+    if (!in.good())
+        return false;
+
+    try {
+        sdsl::bit_vector bits;
+        bits.load(in);
+        edges_->set_bits(track_, bits);
+        return true;
+
+    } catch (const std::bad_alloc &exception) {
+        std::cerr << "ERROR: Not enough memory to load InterleavedEdges." << std::endl;
+        return false;
+    } catch (...) {
+        return false;
+    }
+}
+
+void InterleavedEdges::BitView::serialize(std::ostream &out) const {
+    to_vector().serialize(out);
+}
+
+void InterleavedEdges::BitView::add_to(sdsl::bit_vector *other) const {
+    assert(other);
+    assert(other->size() == size());
+
+    call_ones([&](uint64_t i) { (*other)[i] = true; });
+}
+
+sdsl::bit_vector InterleavedEdges::BitView::to_vector() const {
+    sdsl::bit_vector vector(size(), false);
+    call_ones([&](uint64_t i) { vector[i] = true; });
+    return vector;
+}
+
+} // namespace boss
+} // namespace graph
+} // namespace mtg
@@ -0,0 +1,176 @@
+#ifndef __INTERLEAVED_EDGES_HPP__
+#define __INTERLEAVED_EDGES_HPP__
+
+#include <memory>
+#include <vector>
+
+#include "common/vectors/bit_vector.hpp"
+#include "common/vectors/slot_block.hpp"
+#include "common/vectors/wavelet_tree.hpp"
+
+
+namespace mtg {
+namespace graph {
+namespace boss {
+
+/**
+ * Per-edge data of the BOSS table (W and last) and the mask of valid edges
+ * stored together in cache line-sized blocks. Every block holds the W symbols,
+ * the last bits and the mask bits of 32 consecutive edges along with the rank
+ * samples of all three, so that a traversal step querying W, last, and the
+ * mask for the same edge loads a single cache line.
+ *
+ * The components are accessed through views implementing the wavelet_tree
+ * and bit_vector interfaces, which share the same storage. Each view
+ * serializes its own component only.
+ */
+class InterleavedEdges {
+  public:
+    typedef wavelet_tree::TAlphabet TAlphabet;
+
+    enum BitTrack { LAST = 0, MASK, NUM_TRACKS };
+
+    static constexpr uint8_t kMaxLogSigma = 4;
+
+    class SymbolView;
+    class BitView;
+
+    explicit InterleavedEdges(uint8_t logsigma);
+
+    // reinitialize with new symbols, the bits are reset if the size changes
+    void set_symbols(const sdsl::int_vector<> &symbols);
+    // throw an exception if the size of |bits| is incompatible
+    void set_bits(BitTrack track, const sdsl::bit_vector &bits);
+
+    uint64_t size() const { return size_; }
+    uint8_t logsigma() const { return logsigma_; }
+
+    TAlphabet get_symbol(uint64_t i) const;
+    uint64_t rank(TAlphabet c, uint64_t i) const;
+    uint64_t select(TAlphabet c, uint64_t i) const;
+    uint64_t next(uint64_t i, TAlphabet c) const;
+    uint64_t prev(uint64_t i, TAlphabet c) const;
+    uint64_t count(TAlphabet c) const { return count_[c]; }
+
+    bool get_bit(BitTrack track, uint64_t i) const;
+    uint64_t get_int(BitTrack track, uint64_t i, uint32_t width) const;
+    uint64_t rank1(BitTrack track, uint64_t i) const;
+    uint64_t select1(BitTrack track, uint64_t i) const;
+    uint64_t select0(BitTrack track, uint64_t i) const;
+    uint64_t next1(BitTrack track, uint64_t i) const;
+    uint64_t prev1(BitTrack track, uint64_t i) const;
+    uint64_t num_set_bits(BitTrack track) const { return num_set_bits_[track]; }
+    void call_ones_in_range(BitTrack track, uint64_t begin, uint64_t end,
+                            const VoidCall<uint64_t> &callback) const;
+
+  private:
+    static constexpr size_t kSigma = 1 << kMaxLogSigma;
+    static constexpr size_t kWordsPerBlock = 2;
+    typedef slot_block<kWordsPerBlock> Symbols;
+    static constexpr size_t kBlockSize = Symbols::kSize;
+    // must be small enough for the block counts to fit in uint16_t
+    static constexpr size_t kBlocksPerSuperblock = 2048;
+    static constexpr size_t kSuperblockSize = kBlockSize * kBlocksPerSuperblock;
+
+    struct alignas(64) Block {
+        // occurrences of each symbol in the superblock before this block
+        uint16_t counts[kSigma];
+        // set bits in the superblock before this block
+        uint32_t ranks[NUM_TRACKS];
+        uint32_t bits[NUM_TRACKS];
+        uint64_t words[kWordsPerBlock];
+    };
+    static_assert(sizeof(Block) == 64);
+    static_assert(kMaxLogSigma == Symbols::kBitsPerSlot);
+
+    uint8_t logsigma_;
+    uint64_t size_ = 0;
+    std::vector<Block> blocks_;
+    // occurrences of each symbol before every superblock
+    std::vector<uint64_t> superblock_counts_;
+    // set bits of each track before every superblock
+    std::vector<uint64_t> superblock_ranks_;
+    std::vector<uint64_t> count_;
+    uint64_t num_set_bits_[NUM_TRACKS] = {};
+};
+
+
+class InterleavedEdges::SymbolView : public wavelet_tree {
+  public:
+    explicit SymbolView(std::shared_ptr<InterleavedEdges> edges)
+      : edges_(std::move(edges)) { assert(edges_); }
+
+    uint64_t rank(TAlphabet c, uint64_t i) const { return edges_->rank(c, i); }
+    uint64_t select(TAlphabet c, uint64_t i) const { return edges_->select(c, i); }
+    TAlphabet operator[](uint64_t i) const { return edges_->get_symbol(i); }
+
+    uint64_t next(uint64_t i, TAlphabet c) const { return edges_->next(i, c); }
+    uint64_t prev(uint64_t i, TAlphabet c) const { return edges_->prev(i, c); }
+
+    uint64_t size() const { return edges_->size(); }
+    uint8_t logsigma() const { return edges_->logsigma(); }
+    uint64_t count(TAlphabet c) const { return edges_->count(c); }
+
+    bool load(std::istream &in);
+    void serialize(std::ostream &out) const;
+
+    // detach from the shared storage
+    void clear() { edges_ = std::make_shared<InterleavedEdges>(logsigma()); }
+
+    sdsl::int_vector<> to_vector() const;
+
+    const std::shared_ptr<InterleavedEdges>& get_storage() const { return edges_; }
+
+  private:
+    std::shared_ptr<InterleavedEdges> edges_;
+};
+
+
+class InterleavedEdges::BitView : public bit_vector {
+  public:
+    BitView(std::shared_ptr<InterleavedEdges> edges, BitTrack track)
+      : edges_(std::move(edges)), track_(track) { assert(edges_); }
+
+    std::unique_ptr<bit_vector> copy() const override {
+        return std::make_unique<BitView>(*this);
+    }
+
+    uint64_t rank1(uint64_t id) const override { return edges_->rank1(track_, id); }
+    uint64_t select0(uint64_t id) const override { return edges_->select0(track_, id); }
+    uint64_t select1(uint64_t id) const override { return edges_->select1(track_, id); }
+
+    uint64_t next1(uint64_t id) const override { return edges_->next1(track_, id); }
+    uint64_t prev1(uint64_t id) const override { return edges_->prev1(track_, id); }
+
+    bool operator[](uint64_t id) const override { return edges_->get_bit(track_, id); }
+    uint64_t get_int(uint64_t id, uint32_t width) const override {
+        return edges_->get_int(track_, id, width);
+    }
+
+    bool load(std::istream &in) override;
+    void serialize(std::ostream &out) const override;
+
+    uint64_t size() const override { return edges_->size(); }
+    uint64_t num_set_bits() const override { return edges_->num_set_bits(track_); }
+
+    void call_ones_in_range(uint64_t begin, uint64_t end,
+                            const VoidCall<uint64_t> &callback) const override {
+        edges_->call_ones_in_range(track_, begin, end, callback);
+    }
+
+    void add_to(sdsl::bit_vector *other) const override;
+
+    sdsl::bit_vector to_vector() const override;
+
+    const std::shared_ptr<InterleavedEdges>& get_storage() const { return edges_; }
+
+  private:
+    std::shared_ptr<InterleavedEdges> edges_;
+    BitTrack track_;
+};
+
+} // namespace boss
+} // namespace graph
+} // namespace mtg
+
+#endif // __INTERLEAVED_EDGES_HPP__
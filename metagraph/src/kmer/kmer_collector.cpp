@@ -124,6 +124,89 @@ void count_kmers(std::function<void(CallStringCount)> generate_reads,
     }
 }
 
+/**
+ * Expand the super-k-mers stored in bin |bin| into k-mers, deduplicate (or
+ * count) them, and add them to |kmers|. Every distinct k-mer is stored in a
+ * single bin, so the bins can be processed independently.
+ */
+template <typename KMER, class KmerExtractor, class Container>
+void expand_superkmers(SuperkmerBins *bins,
+                       size_t bin,
+                       bool both_strands_mode,
+                       Container *kmers,
+                       bool canonical_only) {
+    static_assert(KMER::kBitsPerChar == KmerExtractor::bits_per_char);
+    static_assert(std::is_same_v<typename KMER::WordType, typename Container::key_type>);
+
+    using Key = typename KMER::WordType;
+
+    const size_t k = bins->get_k();
+    const std::vector<typename KmerExtractor::TAlphabet> no_suffix;
+
+    Vector<KMER> buffer;
+
+    KmerExtractor kmer_extractor;
+
+    auto extract = [&](std::string_view superkmer) {
+        kmer_extractor.sequence_to_kmers(superkmer, k, no_suffix, &buffer, canonical_only);
+        if (both_strands_mode && !canonical_only) {
+            std::string rev_comp(superkmer);
+            reverse_complement(rev_comp.begin(), rev_comp.end());
+            kmer_extractor.sequence_to_kmers(rev_comp, k, no_suffix, &buffer);
+        }
+    };
+
+    if constexpr(std::is_same_v<Key, typename Container::value_type>) {
+        bins->call_superkmers(bin, [&](std::string_view superkmer, uint64_t) {
+            extract(superkmer);
+        });
+
+        Key *begin = reinterpret_cast<Key *>(buffer.data());
+        Key *end = begin + buffer.size();
+        std::sort(begin, end);
+        end = std::unique(begin, end);
+
+        kmers->insert(begin, end);
+
+    } else {
+        using KmerCount = typename Container::count_type;
+
+        Vector<std::pair<Key, KmerCount>> buffer_with_counts;
+
+        bins->call_superkmers(bin, [&](std::string_view superkmer, uint64_t count) {
+            count = std::min(count, kmers->max_count());
+
+            extract(superkmer);
+
+            for (const KMER &kmer : buffer) {
+                buffer_with_counts.emplace_back(kmer.data(), count);
+            }
+            buffer.resize(0);
+        });
+
+        std::sort(buffer_with_counts.begin(), buffer_with_counts.end(),
+                  utils::LessFirst());
+
+        // merge the counts of equal k-mers
+        size_t last = 0;
+        for (size_t i = 1; i < buffer_with_counts.size(); ++i) {
+            if (buffer_with_counts[i].first == buffer_with_counts[last].first) {
+                buffer_with_counts[last].second = std::min(
+                    static_cast<uint64_t>(buffer_with_counts[last].second)
+                        + buffer_with_counts[i].second,
+                    static_cast<uint64_t>(kmers->max_count())
+                );
+            } else {
+                buffer_with_counts[++last] = buffer_with_counts[i];
+            }
+        }
+        if (buffer_with_counts.size())
+            buffer_with_counts.resize(last + 1);
+
+        kmers->insert(buffer_with_counts.begin(), buffer_with_counts.end());
+    }
+}
+
 template <typename KMER, class KmerExtractor, class Container>
 KmerCollector<KMER, KmerExtractor, Container>
 ::KmerCollector(size_t k,
@@ -133,7 +216,8 @@ KmerCollector<KMER, KmerExtractor, Container>
                 double memory_preallocated,
                 const std::filesystem::path &swap_dir,
                 size_t __attribute__((unused)) disk_cap_bytes,
-                bool canonical_only)
+                bool canonical_only,
+                size_t num_superkmer_bins)
       : k_(k),
         num_threads_(num_threads),
         thread_pool_(std::max(static_cast<size_t>(1), num_threads_), 1),
@@ -158,6 +242,19 @@ KmerCollector<KMER, KmerExtractor, Container>
             "Preallocated {} MiB for the k-mer storage, capacity: {} k-mers",
             kmers_->buffer_size() * sizeof(typename Container::value_type) >> 20,
             kmers_->buffer_size());
+
+    if (num_superkmer_bins && filter_suffix_encoded_.size()) {
+        common::logger->warn("Super-k-mer bins are not supported with k-mer suffix"
+                             " filters, the k-mers will be collected directly");
+
+    } else if (num_superkmer_bins) {
+        superkmer_bins_ = std::make_unique<SuperkmerBins>(
+            k_, num_superkmer_bins, swap_dir, both_strands_mode_,
+            [this](char c) { return kmer_extractor_.encode(c) < kmer_extractor_.alphabet.size(); }
+        );
+        common::logger->trace("Splitting sequences into super-k-mers in {} bins",
+                              num_superkmer_bins);
+    }
 }
 
 template <typename KMER, class KmerExtractor, class Container>
@@ -170,6 +267,15 @@ KmerCollector<KMER, KmerExtractor, Container>
 template <typename KMER, class KmerExtractor, class Container>
 void KmerCollector<KMER, KmerExtractor, Container>
 ::add_sequences(const std::function<void(CallString)> &generate_sequences) {
+    if (superkmer_bins_) {
+        thread_pool_.enqueue([this,generate_sequences]() {
+            superkmer_bins_->add_sequences([&](const SuperkmerBins::CallSequence &callback) {
+                generate_sequences([&](const std::string &seq) { callback(seq, 1); });
+            });
+        });
+        return;
+    }
+
     if constexpr(std::is_same_v<typename KMER::WordType, typename Container::value_type>) {
         thread_pool_.enqueue(extract_kmers<KMER, Extractor, Container>,
                              generate_sequences,
@@ -188,6 +294,17 @@ void KmerCollector<KMER, KmerExtractor, Container>
 template <typename KMER, class KmerExtractor, class Container>
 void KmerCollector<KMER, KmerExtractor, Container>
 ::add_sequences(const std::function<void(CallStringCount)> &generate_sequences) {
+    if (superkmer_bins_) {
+        thread_pool_.enqueue([this,generate_sequences]() {
+            superkmer_bins_->add_sequences([&](const SuperkmerBins::CallSequence &callback) {
+                generate_sequences([&](const std::string &seq, uint64_t count) {
+                    callback(seq, count);
+                });
+            });
+        });
+        return;
+    }
+
     if constexpr(std::is_same_v<typename KMER::WordType, typename Container::value_type>) {
         thread_pool_.enqueue(extract_kmers<KMER, Extractor, Container>,
                              [generate_sequences](CallString callback) {
@@ -235,6 +352,31 @@ template <typename KMER, class KmerExtractor, class Container>
 void KmerCollector<KMER, KmerExtractor, Container>::join() {
     batcher_.process_all_buffered();
     thread_pool_.join();
+
+    if (superkmer_bins_)
+        expand_superkmer_bins();
+}
+
+template <typename KMER, class KmerExtractor, class Container>
+void KmerCollector<KMER, KmerExtractor, Container>::expand_superkmer_bins() {
+    assert(superkmer_bins_);
+
+    common::logger->trace("Expanding {} MiB of super-k-mers from {} bins...",
+                          superkmer_bins_->num_bytes() >> 20,
+                          superkmer_bins_->num_bins());
+    Timer timer;
+
+    for (size_t bin = 0; bin < superkmer_bins_->num_bins(); ++bin) {
+        thread_pool_.enqueue(expand_superkmers<KMER, Extractor, Container>,
+                             superkmer_bins_.get(), bin,
+                             both_strands_mode_, kmers_.get(), canonical_only_);
+    }
+    thread_pool_.join();
+
+    // the sequences added from now on are collected directly
+    superkmer_bins_.reset();
+
+    common::logger->trace("Super-k-mers expanded in {} sec", timer.elapsed());
 }
 
 #define INSTANTIATE_KMER_STORAGE(KMER_EXTRACTOR, KMER) \
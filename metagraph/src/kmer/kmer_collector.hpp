@@ -9,6 +9,7 @@
 
 #include "common/threads/threading.hpp"
 #include "common/batch_accumulator.hpp"
+#include "superkmer_bins.hpp"
 
 
 namespace mtg {
@@ -51,6 +52,10 @@ class KmerCollector {
      * @param  num_threads The number of threads in the pool processing incoming sequences
      * @param  memory_preallocated The number of bytes to reserve in the container
      * @param canonical_only keep only canonical k-mers when in #both_strands_mode
+     * @param num_superkmer_bins If positive, the sequences are first split into
+     * super-k-mers distributed between this many bins on disk (see SuperkmerBins),
+     * which are expanded, deduplicated, and counted independently when the data
+     * is requested. Not supported with #filter_suffix_encoded.
      */
     KmerCollector(size_t k,
                   bool both_strands_mode = false,
@@ -59,7 +64,8 @@ class KmerCollector {
                   double memory_preallocated = 0,
                   const std::filesystem::path &swap_dir = "/tmp/",
                   size_t disk_cap_bytes = 1e9,
-                  bool canonical_only = false);
+                  bool canonical_only = false,
+                  size_t num_superkmer_bins = 0);
 
     ~KmerCollector();
 
@@ -106,6 +112,9 @@ class KmerCollector {
   private:
     void join();
 
+    // expand the super-k-mers from all bins and add the k-mers to the container
+    void expand_superkmer_bins();
+
     size_t k_;
     std::unique_ptr<Container> kmers_;
 
@@ -123,6 +132,8 @@ class KmerCollector {
     std::filesystem::path tmp_dir_;
 
     size_t buffer_size_;
+
+    std::unique_ptr<SuperkmerBins> superkmer_bins_;
 };
 
 /** Visible For Testing */
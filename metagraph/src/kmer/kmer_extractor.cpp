@@ -312,13 +312,16 @@ KmerExtractorBOSS::TAlphabet KmerExtractorBOSS::complement(TAlphabet c) {
  * @param[out] kmers output parameter for the resulting k-mers
  * @param canonical_mode if true, extracts canonical (lexicographically smaller vs. the
  * reverse complement) k-mers
+ * @param dummy_kmers if true, adds the dummy source and sink k-mers even if #suffix
+ * is empty
  */
 template <typename KMER>
 void KmerExtractorBOSS::sequence_to_kmers(std::string_view sequence,
                                           size_t k,
                                           const std::vector<TAlphabet> &suffix,
                                           Vector<KMER> *kmers,
-                                          bool canonical_mode) {
+                                          bool canonical_mode,
+                                          bool dummy_kmers) {
     assert(kmers);
     assert(k);
     assert(suffix.size() < k && "suffix does not include the last character");
@@ -327,8 +330,11 @@ void KmerExtractorBOSS::sequence_to_kmers(std::string_view sequence,
         return;
 
     // encode sequence
-    const size_t dummy_prefix_size = suffix.empty() ? 0 : k - 1;
-    const size_t dummy_suffix_size = suffix.empty() ? 0 : 1;
+    if (suffix.size())
+        dummy_kmers = true;
+
+    const size_t dummy_prefix_size = dummy_kmers ? k - 1 : 0;
+    const size_t dummy_suffix_size = dummy_kmers ? 1 : 0;
 
     std::vector<TAlphabet> seq(dummy_prefix_size
                                     + sequence.size() + 1, alphabet.size());
@@ -385,18 +391,21 @@ void KmerExtractorBOSS::sequence_to_kmers(std::string_view,
                                           size_t,
                                           const std::vector<TAlphabet>&,
                                           Vector<Kmer64>*,
+                                          bool,
                                           bool);
 template
 void KmerExtractorBOSS::sequence_to_kmers(std::string_view,
                                           size_t,
                                           const std::vector<TAlphabet>&,
                                           Vector<Kmer128>*,
+                                          bool,
                                           bool);
 template
 void KmerExtractorBOSS::sequence_to_kmers(std::string_view,
                                           size_t,
                                           const std::vector<TAlphabet>&,
                                           Vector<Kmer256>*,
+                                          bool,
                                           bool);
 
 std::vector<std::string> KmerExtractorBOSS::generate_suffixes(size_t len) {
@@ -57,14 +57,16 @@ class KmerExtractorBOSS {
 
     /**
      * Break the sequence into kmers and add them to the kmer storage.
-     * Adds only valid k-mers.
+     * Adds only valid k-mers. The dummy k-mers are added if |dummy_kmers|
+     * is true or if |suffix| is not empty.
      */
     template <class KMER>
     static void sequence_to_kmers(std::string_view sequence,
                                   size_t k,
                                   const std::vector<TAlphabet> &suffix,
                                   Vector<KMER> *kmers,
-                                  bool canonical_mode = false);
+                                  bool canonical_mode = false,
+                                  bool dummy_kmers = false);
 
     template <class KMER>
     static std::string kmer_to_sequence(const KMER &kmer, size_t k) {
@@ -0,0 +1,235 @@
+#include "superkmer_bins.hpp"
+
+#include <cassert>
+#include <cctype>
+#include <deque>
+#include <limits>
+
+#include "common/logger.hpp"
+#include "common/seq_tools/reverse_complement.hpp"
+#include "common/utils/file_utils.hpp"
+
+
+namespace mtg {
+namespace kmer {
+
+using mtg::common::logger;
+
+// flush the local buffers to the bins when they reach this size
+const size_t kMaxBufferedBytes = 4'000'000;
+
+
+// hash of an m-mer with well mixed bits (case-insensitive)
+inline uint64_t hash_mmer(const char *begin, size_t m) {
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const char *it = begin; it != begin + m; ++it) {
+        hash ^= static_cast<uint8_t>(std::toupper(*it));
+        hash *= 0x100000001b3ull;
+    }
+    // finalizer from MurmurHash3
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+
+SuperkmerBins::SuperkmerBins(size_t k,
+                             size_t num_bins,
+                             const std::filesystem::path &tmp_dir,
+                             bool canonical,
+                             const std::function<bool(char)> &is_valid,
+                             size_t minimizer_length)
+      : k_(k),
+        minimizer_length_(std::min(k, minimizer_length)),
+        canonical_(canonical),
+        dir_(utils::create_temp_dir(tmp_dir, "superkmers")) {
+    assert(k_);
+    assert(minimizer_length_);
+    assert(num_bins);
+
+    for (size_t c = 0; c < is_valid_.size(); ++c) {
+        is_valid_[c] = is_valid(static_cast<char>(c));
+    }
+
+    bins_.reserve(num_bins);
+    for (size_t i = 0; i < num_bins; ++i) {
+        bins_.push_back(std::make_unique<Bin>());
+        bins_.back()->out.open(dir_/("bin_" + std::to_string(i)), std::ios::binary);
+        if (!bins_.back()->out.good()) {
+            logger->error("Can't create a super-k-mer bin in {}", dir_.string());
+            exit(1);
+        }
+    }
+}
+
+SuperkmerBins::~SuperkmerBins() {
+    bins_.clear();
+    utils::remove_temp_dir(dir_);
+}
+
+void SuperkmerBins::split(std::string_view sequence,
+                          const std::function<void(std::string_view, size_t)> &callback) const {
+    if (sequence.size() < k_)
+        return;
+
+    const size_t m = minimizer_length_;
+    const size_t num_mmers = sequence.size() - m + 1;
+    // the number of m-mers in a k-mer
+    const size_t window = k_ - m + 1;
+
+    std::string rev_comp;
+    if (canonical_) {
+        rev_comp = sequence;
+        reverse_complement(rev_comp.begin(), rev_comp.end());
+    }
+
+    std::vector<uint64_t> hashes(num_mmers);
+    for (size_t i = 0; i < num_mmers; ++i) {
+        hashes[i] = hash_mmer(sequence.data() + i, m);
+        if (canonical_) {
+            // the same m-mer on the reverse complement strand
+            hashes[i] = std::min(hashes[i],
+                                 hash_mmer(rev_comp.data() + num_mmers - 1 - i, m));
+        }
+    }
+
+    // sliding window minimum over the m-mers of each k-mer
+    std::deque<size_t> min_queue;
+    size_t superkmer_begin = 0;
+    uint64_t superkmer_minimizer = 0;
+
+    for (size_t i = 0; i < num_mmers; ++i) {
+        while (min_queue.size() && hashes[min_queue.back()] >= hashes[i]) {
+            min_queue.pop_back();
+        }
+        min_queue.push_back(i);
+
+        if (i + 1 < window)
+            continue;
+
+        // the k-mer starting at |kmer_begin| ends with the m-mer |i|
+        size_t kmer_begin = i + 1 - window;
+        if (min_queue.front() < kmer_begin)
+            min_queue.pop_front();
+
+        uint64_t minimizer = hashes[min_queue.front()];
+
+        if (!kmer_begin) {
+            superkmer_minimizer = minimizer;
+
+        } else if (minimizer != superkmer_minimizer) {
+            // call the super-k-mer ending with the previous k-mer
+            callback(sequence.substr(superkmer_begin, kmer_begin - 1 + k_ - superkmer_begin),
+                     superkmer_minimizer % bins_.size());
+            superkmer_begin = kmer_begin;
+            superkmer_minimizer = minimizer;
+        }
+    }
+
+    callback(sequence.substr(superkmer_begin), superkmer_minimizer % bins_.size());
+}
+
+void SuperkmerBins::add_sequences(const std::function<void(CallSequence)> &generate_sequences) {
+    // Each record is the length of the super-k-mer and the count
+    // of its sequence (uint32_t each), followed by the super-k-mer.
+    std::vector<std::string> buffers(bins_.size());
+    size_t buffered_bytes = 0;
+
+    auto flush = [&]() {
+        for (size_t bin = 0; bin < buffers.size(); ++bin) {
+            if (buffers[bin].size()) {
+                write(bin, buffers[bin]);
+                buffers[bin].clear();
+            }
+        }
+        buffered_bytes = 0;
+    };
+
+    auto add_superkmer = [&](std::string_view superkmer, size_t bin, uint32_t count) {
+        uint32_t length = superkmer.size();
+        std::string &buffer = buffers[bin];
+        buffer.append(reinterpret_cast<const char *>(&length), sizeof(length));
+        buffer.append(reinterpret_cast<const char *>(&count), sizeof(count));
+        buffer.append(superkmer);
+        buffered_bytes += superkmer.size() + sizeof(length) + sizeof(count);
+    };
+
+    generate_sequences([&](std::string_view sequence, uint64_t count) {
+        count = std::min(count, static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()));
+
+        // split into segments of valid characters
+        size_t begin = 0;
+        while (begin < sequence.size()) {
+            size_t end = begin;
+            while (end < sequence.size() && is_valid_[static_cast<uint8_t>(sequence[end])]) {
+                end++;
+            }
+
+            split(sequence.substr(begin, end - begin), [&](std::string_view superkmer, size_t bin) {
+                add_superkmer(superkmer, bin, count);
+            });
+
+            begin = end + 1;
+        }
+
+        if (buffered_bytes >= kMaxBufferedBytes)
+            flush();
+    });
+
+    flush();
+}
+
+void SuperkmerBins::write(size_t bin, const std::string &buffer) {
+    Bin &b = *bins_[bin];
+    std::lock_guard<std::mutex> lock(b.mutex);
+    if (!b.out.write(buffer.data(), buffer.size())) {
+        logger->error("Failed to write super-k-mers to {}", dir_.string());
+        exit(1);
+    }
+    b.num_bytes += buffer.size();
+}
+
+void SuperkmerBins::call_superkmers(size_t bin, const CallSequence &callback) {
+    assert(bin < bins_.size());
+
+    std::filesystem::path fname = dir_/("bin_" + std::to_string(bin));
+    {
+        std::lock_guard<std::mutex> lock(bins_[bin]->mutex);
+        bins_[bin]->out.flush();
+    }
+
+    std::ifstream in(fname, std::ios::binary);
+    if (!in.good()) {
+        logger->error("Can't read super-k-mers from {}", fname.string());
+        exit(1);
+    }
+
+    std::string superkmer;
+    uint32_t length;
+    uint32_t count;
+    while (in.read(reinterpret_cast<char *>(&length), sizeof(length))
+            && in.read(reinterpret_cast<char *>(&count), sizeof(count))) {
+        superkmer.resize(length);
+        if (!in.read(superkmer.data(), length)) {
+            logger->error("Corrupted super-k-mer bin {}", fname.string());
+            exit(1);
+        }
+        callback(superkmer, count);
+    }
+}
+
+uint64_t SuperkmerBins::num_bytes() const {
+    uint64_t num_bytes = 0;
+    for (const auto &bin : bins_) {
+        std::lock_guard<std::mutex> lock(bin->mutex);
+        num_bytes += bin->num_bytes;
+    }
+    return num_bytes;
+}
+
+} // namespace kmer
+} // namespace mtg
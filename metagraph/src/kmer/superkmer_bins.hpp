@@ -0,0 +1,104 @@
+#ifndef __SUPERKMER_BINS_HPP__
+#define __SUPERKMER_BINS_HPP__
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace mtg {
+namespace kmer {
+
+/**
+ * Splits sequences into super-k-mers, maximal runs of consecutive k-mers
+ * sharing the same minimizer, and distributes them between bins stored on
+ * disk by the minimizer. Each k-mer gets into the bin of its minimizer, so
+ * the bins partition the set of distinct k-mers and can be expanded, sorted,
+ * and counted independently (as in KMC).
+ *
+ * In canonical mode, the minimizers are computed on canonical m-mers, so a
+ * k-mer and its reverse complement always share a bin.
+ *
+ * The super-k-mers are stored as plain characters, which takes a fraction of
+ * the space the expanded k-mers would take.
+ */
+class SuperkmerBins {
+  public:
+    typedef std::function<void(std::string_view, uint64_t)> CallSequence;
+
+    static constexpr size_t kDefaultMinimizerLength = 11;
+
+    /**
+     * @param k the k-mer length
+     * @param num_bins the number of bins
+     * @param tmp_dir the directory where a temp directory for the bins is created
+     * @param canonical use canonical minimizers
+     * @param is_valid characters breaking the sequences into segments are
+     * the ones for which this returns false
+     */
+    SuperkmerBins(size_t k,
+                  size_t num_bins,
+                  const std::filesystem::path &tmp_dir,
+                  bool canonical,
+                  const std::function<bool(char)> &is_valid,
+                  size_t minimizer_length = kDefaultMinimizerLength);
+
+    SuperkmerBins(const SuperkmerBins &) = delete;
+    SuperkmerBins& operator=(const SuperkmerBins &) = delete;
+
+    ~SuperkmerBins();
+
+    /**
+     * Split the sequences into super-k-mers and append them to the bins.
+     * Thread-safe, can be called concurrently.
+     */
+    void add_sequences(const std::function<void(CallSequence)> &generate_sequences);
+
+    /**
+     * Call all super-k-mers (with the counts of their sequences) stored in
+     * bin |bin|. Must not be called concurrently with #add_sequences.
+     */
+    void call_superkmers(size_t bin, const CallSequence &callback);
+
+    size_t num_bins() const { return bins_.size(); }
+
+    size_t get_k() const { return k_; }
+
+    // total number of bytes written to all bins
+    uint64_t num_bytes() const;
+
+    /**
+     * Call the super-k-mers of |sequence| with the bins they belong to.
+     * The sequence must only consist of valid characters.
+     */
+    void split(std::string_view sequence,
+               const std::function<void(std::string_view, size_t)> &callback) const;
+
+  private:
+    struct Bin {
+        std::mutex mutex;
+        std::ofstream out;
+        uint64_t num_bytes = 0;
+    };
+
+    void write(size_t bin, const std::string &buffer);
+
+    size_t k_;
+    size_t minimizer_length_;
+    bool canonical_;
+    std::array<bool, 256> is_valid_;
+    std::filesystem::path dir_;
+    std::vector<std::unique_ptr<Bin>> bins_;
+};
+
+} // namespace kmer
+} // namespace mtg
+
+#endif // __SUPERKMER_BINS_HPP__
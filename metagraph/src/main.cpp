@@ -2,6 +2,7 @@
 
 #include "common/logger.hpp"
 #include "common/algorithms.hpp"
+#include "common/perf_counters.hpp"
 #include "cli/config/config.hpp"
 #include "cli/build.hpp"
 #include "cli/annotate.hpp"
@@ -13,6 +14,7 @@
 #include "cli/query.hpp"
 #include "cli/assemble.hpp"
 #include "cli/server.hpp"
+#include "cli/router.hpp"
 #include "cli/transform_graph.hpp"
 #include "cli/transform_annotation.hpp"
 
@@ -21,70 +23,61 @@ using mtg::common::logger;
 using mtg::cli::Config;
 
 
-int main(int argc, char *argv[]) {
-    auto config = std::make_unique<Config>(argc, argv);
-
-    logger->set_level(common::get_verbose()
-                            ? spdlog::level::trace
-                            : spdlog::level::info);
-    //logger->set_pattern("%^date %x....%$  %v");
-    //spdlog::set_pattern("[%H:%M:%S %z] [%n] [%^---%L---%$] [thread %t] %v");
-    //console_sink->set_color(spdlog::level::trace, "\033[37m");
-    spdlog::flush_every(std::chrono::seconds(1));
-
-    logger->trace("Metagraph started");
-
+int run_command(Config *config) {
     switch (config->identity) {
         case Config::BUILD:
-            return cli::build_graph(config.get());
+            return cli::build_graph(config);
 
         case Config::EXTEND:
-            return cli::augment_graph(config.get());
+            return cli::augment_graph(config);
 
         case Config::ANNOTATE:
-            return cli::annotate_graph(config.get());
+            return cli::annotate_graph(config);
 
         case Config::ANNOTATE_COORDINATES:
-            return cli::annotate_graph_with_genome_coordinates(config.get());
+            return cli::annotate_graph_with_genome_coordinates(config);
 
         case Config::MERGE_ANNOTATIONS:
-            return cli::merge_annotation(config.get());
+            return cli::merge_annotation(config);
 
         case Config::QUERY:
-            return cli::query_graph(config.get());
+            return cli::query_graph(config);
 
         case Config::SERVER_QUERY:
-            return cli::run_server(config.get());
+            return cli::run_server(config);
+
+        case Config::SERVER_ROUTER:
+            return cli::run_router(config);
 
         case Config::COMPARE:
-            return cli::compare(config.get());
+            return cli::compare(config);
 
         case Config::CONCATENATE:
-            return cli::concatenate_graph_chunks(config.get());
+            return cli::concatenate_graph_chunks(config);
 
         case Config::MERGE:
-            return cli::merge_graph(config.get());
+            return cli::merge_graph(config);
 
         case Config::CLEAN:
-            return cli::clean_graph(config.get());
+            return cli::clean_graph(config);
 
         case Config::STATS:
-            return cli::print_stats(config.get());
+            return cli::print_stats(config);
 
         case Config::TRANSFORM_ANNOTATION:
-            return cli::transform_annotation(config.get());
+            return cli::transform_annotation(config);
 
         case Config::TRANSFORM:
-            return cli::transform_graph(config.get());
+            return cli::transform_graph(config);
 
         case Config::ASSEMBLE:
-            return cli::assemble(config.get());
+            return cli::assemble(config);
 
         case Config::RELAX_BRWT:
-            return cli::relax_multi_brwt(config.get());
+            return cli::relax_multi_brwt(config);
 
         case Config::ALIGN:
-            return cli::align_to_graph(config.get());
+            return cli::align_to_graph(config);
 
         case Config::NO_IDENTITY:
             assert(false);
@@ -92,3 +85,26 @@ int main(int argc, char *argv[]) {
 
     return 0;
 }
+
+int main(int argc, char *argv[]) {
+    auto config = std::make_unique<Config>(argc, argv);
+
+    logger->set_level(common::get_verbose()
+                            ? spdlog::level::trace
+                            : spdlog::level::info);
+    //logger->set_pattern("%^date %x....%$  %v");
+    //spdlog::set_pattern("[%H:%M:%S %z] [%n] [%^---%L---%$] [thread %t] %v");
+    //console_sink->set_color(spdlog::level::trace, "\033[37m");
+    spdlog::flush_every(std::chrono::seconds(1));
+
+    logger->trace("Metagraph started");
+
+    int ret = run_command(config.get());
+
+    if (config->metrics_file.size()
+            && !common::dump_perf_counters(config->metrics_file)) {
+        logger->error("Cannot write performance counters to '{}'", config->metrics_file);
+    }
+
+    return ret;
+}
@@ -0,0 +1,142 @@
+#include "block_gzip_writer.hpp"
+
+#include <cassert>
+#include <stdexcept>
+
+
+namespace mtg {
+namespace seq_io {
+
+// zlib's windowBits for a raw deflate stream with a gzip header and trailer
+const int kGzipWindowBits = 15 + 16;
+const int kMemLevel = 8;
+
+
+std::string compress_gzip_member(const char *data, size_t size, int compression_level) {
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+
+    if (deflateInit2(&strm, compression_level, Z_DEFLATED,
+                     kGzipWindowBits, kMemLevel, Z_DEFAULT_STRATEGY) != Z_OK)
+        throw std::runtime_error("Failed to initialize deflate stream");
+
+    std::string compressed(deflateBound(&strm, size), '\0');
+
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    strm.avail_in = size;
+    strm.next_out = reinterpret_cast<Bytef*>(compressed.data());
+    strm.avail_out = compressed.size();
+
+    int ret = deflate(&strm, Z_FINISH);
+    compressed.resize(compressed.size() - strm.avail_out);
+    deflateEnd(&strm);
+
+    if (ret != Z_STREAM_END)
+        throw std::runtime_error("Failed to compress block");
+
+    return compressed;
+}
+
+
+BlockGzipWriter::BlockGzipWriter(const std::string &filename,
+                                 const char *mode,
+                                 int compression_level,
+                                 size_t num_threads,
+                                 size_t block_size)
+      : out_(std::fopen(filename.c_str(), mode && mode[0] == 'a' ? "ab" : "wb")),
+        compression_level_(compression_level),
+        block_size_(std::max(block_size, size_t(1))),
+        // keep all workers busy while the oldest block is being written
+        max_num_pending_blocks_(2 * num_threads + 1),
+        pool_(num_threads, 2 * num_threads + 1) {
+    buffer_.reserve(block_size_);
+}
+
+BlockGzipWriter::~BlockGzipWriter() {
+    close();
+}
+
+bool BlockGzipWriter::write(const char *data, size_t size) {
+    if (!out_)
+        return false;
+
+    while (buffer_.size() + size >= block_size_) {
+        size_t chunk = block_size_ - buffer_.size();
+        buffer_.append(data, chunk);
+        data += chunk;
+        size -= chunk;
+        submit_block();
+    }
+    buffer_.append(data, size);
+
+    return good_;
+}
+
+bool BlockGzipWriter::put(char c) {
+    return write(&c, 1);
+}
+
+void BlockGzipWriter::submit_block() {
+    if (buffer_.empty())
+        return;
+
+    pending_blocks_.push_back(pool_.enqueue(
+        [level = compression_level_](const std::string &block) {
+            return compress_gzip_member(block.data(), block.size(), level);
+        },
+        std::move(buffer_)
+    ));
+
+    buffer_ = std::string();
+    buffer_.reserve(block_size_);
+
+    // bound the memory taken by compressed blocks waiting to be written
+    while (pending_blocks_.size() > max_num_pending_blocks_) {
+        write_compressed_block();
+    }
+}
+
+bool BlockGzipWriter::write_compressed_block() {
+    assert(pending_blocks_.size());
+
+    const std::string &block = pending_blocks_.front().get();
+    if (std::fwrite(block.data(), 1, block.size(), out_) != block.size())
+        good_ = false;
+
+    pending_blocks_.pop_front();
+    return good_;
+}
+
+bool BlockGzipWriter::flush() {
+    if (!out_)
+        return false;
+
+    submit_block();
+
+    while (pending_blocks_.size()) {
+        write_compressed_block();
+    }
+
+    if (std::fflush(out_))
+        good_ = false;
+
+    return good_;
+}
+
+bool BlockGzipWriter::close() {
+    if (!out_)
+        return false;
+
+    flush();
+
+    if (std::fclose(out_))
+        good_ = false;
+
+    out_ = NULL;
+    return good_;
+}
+
+} // namespace seq_io
+} // namespace mtg
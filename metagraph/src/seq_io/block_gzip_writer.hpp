@@ -0,0 +1,88 @@
+#ifndef __BLOCK_GZIP_WRITER_HPP__
+#define __BLOCK_GZIP_WRITER_HPP__
+
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <string>
+#include <string_view>
+
+#include <zlib.h>
+
+#include "common/threads/threading.hpp"
+
+
+namespace mtg {
+namespace seq_io {
+
+/**
+ * A writer for gzip files with block-parallel compression (pigz/BGZF style).
+ *
+ * The data written is split into blocks of (roughly) |block_size| bytes,
+ * each block is compressed into an independent gzip member on a thread pool,
+ * and the compressed members are written to the file in the order of their
+ * submission. A concatenation of gzip members is a valid gzip file, so the
+ * output can be read with gzread, kseq, or any gzip decompressor.
+ *
+ * The writer itself is not thread-safe and must be called from one thread
+ * at a time.
+ */
+class BlockGzipWriter {
+  public:
+    static constexpr size_t kDefaultBlockSize = 1 << 20;
+
+    /**
+     * |mode| is either "w" (truncate) or "a" (append).
+     * If |num_threads| is zero, the blocks are compressed synchronously in
+     * the calling thread.
+     */
+    BlockGzipWriter(const std::string &filename,
+                    const char *mode = "w",
+                    int compression_level = Z_DEFAULT_COMPRESSION,
+                    size_t num_threads = 0,
+                    size_t block_size = kDefaultBlockSize);
+
+    BlockGzipWriter(const BlockGzipWriter &) = delete;
+    BlockGzipWriter& operator=(const BlockGzipWriter &) = delete;
+
+    ~BlockGzipWriter();
+
+    // return false on failure
+    bool is_open() const { return out_ != NULL; }
+
+    bool write(const char *data, size_t size);
+    bool write(std::string_view data) { return write(data.data(), data.size()); }
+    bool put(char c);
+
+    // compress all buffered data and write it to the file
+    bool flush();
+
+    // flush and close the file
+    bool close();
+
+  private:
+    void submit_block();
+    bool write_compressed_block();
+
+    std::FILE *out_;
+    int compression_level_;
+    size_t block_size_;
+    size_t max_num_pending_blocks_;
+    std::string buffer_;
+    bool good_ = true;
+
+    std::deque<std::shared_future<std::string>> pending_blocks_;
+    ThreadPool pool_;
+};
+
+/**
+ * Compress |size| bytes from |data| into a standalone gzip member.
+ * Throws std::runtime_error if the compression fails.
+ */
+std::string compress_gzip_member(const char *data, size_t size,
+                                 int compression_level = Z_DEFAULT_COMPRESSION);
+
+} // namespace seq_io
+} // namespace mtg
+
+#endif // __BLOCK_GZIP_WRITER_HPP__
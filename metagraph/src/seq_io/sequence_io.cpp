@@ -1,7 +1,9 @@
 #include "sequence_io.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <stdexcept>
 #include <thread>
 
 #include "common/seq_tools/reverse_complement.hpp"
@@ -28,19 +30,23 @@ const size_t kWorkerQueueSize = 1;
 const size_t kBufferSize = 1'000'000;
 
 
+std::string get_fasta_filename(const std::string &filebase) {
+    return utils::remove_suffix(filebase, ".gz", ".fasta") + ".fasta.gz";
+}
+
 FastaWriter::FastaWriter(const std::string &filebase,
                          const std::string &header,
                          bool enumerate_sequences,
                          bool async,
-                         const char *mode)
-      : header_(header),
+                         const char *mode,
+                         int compression_level)
+      : gz_out_(get_fasta_filename(filebase), mode, compression_level,
+                async ? get_num_threads() : 0),
+        header_(header),
         enumerate_sequences_(enumerate_sequences),
         worker_(async, kWorkerQueueSize) {
-    auto filename = utils::remove_suffix(filebase, ".gz", ".fasta") + ".fasta.gz";
-
-    gz_out_ = gzopen(filename.c_str(), mode);
-    if (gz_out_ == Z_NULL) {
-        std::cerr << "ERROR: Can't write to " << filename << std::endl;
+    if (!gz_out_.is_open()) {
+        std::cerr << "ERROR: Can't write to " << get_fasta_filename(filebase) << std::endl;
         exit(1);
     }
 
@@ -60,12 +66,13 @@ FastaWriter::FastaWriter(const std::string &filebase,
 
 FastaWriter::~FastaWriter() {
     flush();
-    gzclose(gz_out_);
+    gz_out_.close();
 }
 
 void FastaWriter::flush() {
     batcher_.process_all_buffered();
     worker_.join();
+    gz_out_.flush();
 }
 
 void FastaWriter::write(const std::string &sequence) {
@@ -94,27 +101,30 @@ ExtendedFastaWriter<T>::ExtendedFastaWriter(const std::string &filebase,
                                             const std::string &header,
                                             bool enumerate_sequences,
                                             bool async,
-                                            const char *mode)
-      : kmer_length_(kmer_length),
+                                            const char *mode,
+                                            int compression_level)
+      : fasta_gz_out_(get_fasta_filename(filebase), mode, compression_level,
+                      async ? get_num_threads() : 0),
+        feature_gz_out_(utils::remove_suffix(filebase, ".gz", ".fasta")
+                            + "." + feature_name + ".gz",
+                        "w", compression_level,
+                        async ? get_num_threads() : 0),
+        kmer_length_(kmer_length),
         header_(header),
         enumerate_sequences_(enumerate_sequences),
         worker_(async, kWorkerQueueSize) {
     assert(feature_name.size());
 
-    auto filename = utils::remove_suffix(filebase, ".gz", ".fasta") + ".fasta.gz";
-
-    fasta_gz_out_ = gzopen(filename.c_str(), mode);
-    if (fasta_gz_out_ == Z_NULL) {
-        std::cerr << "ERROR: Can't write to " << filename << std::endl;
+    if (!fasta_gz_out_.is_open()) {
+        std::cerr << "ERROR: Can't write to " << get_fasta_filename(filebase) << std::endl;
         exit(1);
     }
 
-    filename = utils::remove_suffix(filebase, ".gz", ".fasta") + "." + feature_name + ".gz";
-
-    feature_gz_out_ = gzopen(filename.c_str(), "w");
-    if (feature_gz_out_ == Z_NULL
-            || gzwrite(feature_gz_out_, &kmer_length_, 4) != sizeof(kmer_length_)) {
-        std::cerr << "ERROR: Can't write to " << filename << std::endl;
+    if (!feature_gz_out_.is_open()
+            || !feature_gz_out_.write(reinterpret_cast<const char*>(&kmer_length_), 4)) {
+        std::cerr << "ERROR: Can't write to "
+                  << utils::remove_suffix(filebase, ".gz", ".fasta")
+                        + "." + feature_name + ".gz" << std::endl;
         exit(1);
     }
 
@@ -135,14 +145,16 @@ ExtendedFastaWriter<T>::ExtendedFastaWriter(const std::string &filebase,
 template <typename T>
 ExtendedFastaWriter<T>::~ExtendedFastaWriter() {
     flush();
-    gzclose(fasta_gz_out_);
-    gzclose(feature_gz_out_);
+    fasta_gz_out_.close();
+    feature_gz_out_.close();
 }
 
 template <typename T>
 void ExtendedFastaWriter<T>::flush() {
     batcher_.process_all_buffered();
     worker_.join();
+    fasta_gz_out_.flush();
+    feature_gz_out_.flush();
 }
 
 template <typename T>
@@ -174,9 +186,8 @@ void ExtendedFastaWriter<T>::write_to_disk(const value_type &value_pair) {
         exit(1);
     }
 
-    if (gzwrite(feature_gz_out_, kmer_features.data(),
-                                 kmer_features.size() * sizeof(feature_type))
-            != static_cast<int>(kmer_features.size() * sizeof(feature_type))) {
+    if (!feature_gz_out_.write(reinterpret_cast<const char*>(kmer_features.data()),
+                               kmer_features.size() * sizeof(feature_type))) {
         std::cerr << "ERROR: ExtendedFastaWriter::write failed. Can't dump k-mer features" << std::endl;
         exit(1);
     }
@@ -213,6 +224,15 @@ bool write_fasta(gzFile gz_out, const std::string &header,
         && gzputc(gz_out, '\n') == '\n';
 }
 
+bool write_fasta(BlockGzipWriter &gz_out, const std::string &header,
+                                         const std::string &sequence) {
+    return gz_out.put('>')
+        && gz_out.write(header)
+        && gz_out.put('\n')
+        && gz_out.write(sequence)
+        && gz_out.put('\n');
+}
+
 bool write_fastq(gzFile gz_out, const kseq_t &kseq) {
     std::string qual(kseq.qual.s, kseq.qual.l);
 
@@ -529,6 +549,84 @@ void read_fasta_from_string(const std::string &fasta_flat,
 }
 
 
+void read_fasta_from_buffer(std::string_view buffer,
+                            const std::function<void(std::string_view name,
+                                                     std::string_view seq)> &callback,
+                            bool with_reverse) {
+    size_t pos = 0;
+
+    auto next_line = [&]() {
+        size_t end = std::min(buffer.find('\n', pos), buffer.size());
+        std::string_view line = buffer.substr(pos, end - pos);
+        pos = std::min(end + 1, buffer.size());
+        if (line.size() && line.back() == '\r')
+            line.remove_suffix(1);
+        return line;
+    };
+
+    auto is_header = [&]() { return buffer[pos] == '>' || buffer[pos] == '@'; };
+
+    // skip everything before the first header, as kseq does
+    while (pos < buffer.size() && !is_header()) {
+        next_line();
+    }
+
+    std::string seq_buffer;
+
+    while (pos < buffer.size()) {
+        std::string_view header = next_line().substr(1);
+        std::string_view name = header.substr(0, header.find_first_of(" \t"));
+
+        std::string_view seq;
+        bool multiline = false;
+        seq_buffer.clear();
+
+        while (pos < buffer.size() && !is_header() && buffer[pos] != '+') {
+            std::string_view line = next_line();
+            if (line.empty())
+                continue;
+
+            if (seq.empty() && !multiline) {
+                seq = line;
+                continue;
+            }
+
+            if (!multiline) {
+                seq_buffer.assign(seq);
+                multiline = true;
+            }
+            seq_buffer.append(line);
+        }
+
+        if (multiline)
+            seq = seq_buffer;
+
+        if (pos < buffer.size() && buffer[pos] == '+') {
+            // skip the quality string, which may also span multiple lines
+            next_line();
+            size_t qual_length = 0;
+            while (qual_length < seq.size() && pos < buffer.size()) {
+                qual_length += next_line().size();
+            }
+            if (qual_length != seq.size()) {
+                throw std::runtime_error("Quality string length does not match"
+                                         " the sequence length in record "
+                                         + std::string(name));
+            }
+        }
+
+        callback(name, seq);
+
+        if (with_reverse) {
+            if (!multiline)
+                seq_buffer.assign(seq);
+            reverse_complement(seq_buffer);
+            callback(name, seq_buffer);
+        }
+    }
+}
+
+
 void read_vcf_file_critical(const std::string &filename,
                             const std::string &ref_filename,
                             size_t k,
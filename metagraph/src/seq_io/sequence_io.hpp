@@ -4,6 +4,7 @@
 #include <functional>
 #include <vector>
 #include <string>
+#include <string_view>
 
 #include <zlib.h>
 #include <htslib/kseq.h>
@@ -11,6 +12,7 @@
 #include "common/batch_accumulator.hpp"
 #include "common/seq_tools/reverse_complement.hpp"
 #include "common/threads/threading.hpp"
+#include "block_gzip_writer.hpp"
 
 
 namespace mtg {
@@ -19,13 +21,19 @@ namespace seq_io {
 KSEQ_DECLARE(gzFile);
 
 
+/**
+ * Write sequences to a compressed fasta file `<filebase>.fasta.gz`.
+ * If |async| is true, the output is compressed in independent blocks
+ * in parallel with get_num_threads() threads.
+ */
 class FastaWriter {
   public:
     FastaWriter(const std::string &filebase,
                 const std::string &header = "",
                 bool enumerate_sequences = false,
                 bool async = false,
-                const char *mode = "w");
+                const char *mode = "w",
+                int compression_level = Z_DEFAULT_COMPRESSION);
 
     ~FastaWriter();
 
@@ -37,7 +45,7 @@ class FastaWriter {
   private:
     void write_to_disk(const std::string &sequence);
 
-    gzFile gz_out_;
+    BlockGzipWriter gz_out_;
     const std::string header_;
     bool enumerate_sequences_;
     uint64_t count_ = 0;
@@ -58,6 +66,8 @@ class ExtendedFastaWriter {
      * The features are dumped to a compressed array of `T`.
      * Each sequence dumped must contain at least one k-mer, that
      * is, must be at least |kmer_length| in length.
+     * If |async| is true, both files are compressed in independent blocks
+     * in parallel with get_num_threads() threads.
      */
     ExtendedFastaWriter(const std::string &filebase,
                         const std::string &feature_name,
@@ -65,7 +75,8 @@ class ExtendedFastaWriter {
                         const std::string &header = "",
                         bool enumerate_sequences = false,
                         bool async = false,
-                        const char *mode = "w");
+                        const char *mode = "w",
+                        int compression_level = Z_DEFAULT_COMPRESSION);
 
     ~ExtendedFastaWriter();
 
@@ -82,8 +93,8 @@ class ExtendedFastaWriter {
   private:
     void write_to_disk(const value_type &value_pair);
 
-    gzFile fasta_gz_out_;
-    gzFile feature_gz_out_;
+    BlockGzipWriter fasta_gz_out_;
+    BlockGzipWriter feature_gz_out_;
     uint32_t kmer_length_;
     const std::string header_;
     bool enumerate_sequences_;
@@ -97,6 +108,9 @@ bool write_fasta(gzFile gz_out, const kseq_t &kseq);
 bool write_fasta(gzFile gz_out, const std::string &header,
                                 const std::string &sequence);
 
+bool write_fasta(BlockGzipWriter &gz_out, const std::string &header,
+                                         const std::string &sequence);
+
 bool write_fastq(gzFile gz_out, const kseq_t &kseq);
 
 void read_fasta_file_critical(const std::string &filename,
@@ -130,6 +144,18 @@ void read_fasta_from_string(const std::string &fasta_flat,
                             std::function<void(kseq_t*)> callback,
                             bool with_reverse = false);
 
+/**
+ * Parse fasta/fastq records from a buffer held in memory. The names and the
+ * sequences written on a single line are passed as views into |buffer|, so
+ * no copies are made for them. Sequences wrapped over multiple lines are
+ * concatenated into a temporary buffer, as are their reverse complements.
+ * Throw std::runtime_error if a fastq record is truncated.
+ */
+void read_fasta_from_buffer(std::string_view buffer,
+                            const std::function<void(std::string_view name,
+                                                     std::string_view seq)> &callback,
+                            bool with_reverse = false);
+
 
 class FastaParser {
   public:
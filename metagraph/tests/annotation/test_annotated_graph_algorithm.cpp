@@ -5,6 +5,7 @@
 
 #include "common/threads/threading.hpp"
 #include "graph/annotated_graph_algorithm.hpp"
+#include "graph/alignment/dbg_aligner.hpp"
 
 
 namespace {
@@ -118,6 +119,75 @@ TYPED_TEST(MaskedDeBruijnGraphAlgorithm, MaskIndicesByLabel) {
 }
 
 
+TYPED_TEST(MaskedDeBruijnGraphAlgorithm, MaskIndicesByLabelCached) {
+    for (size_t k = 3; k < max_test_k<typename TypeParam::first_type>(); ++k) {
+        const std::vector<std::string> sequences {
+            std::string("T") + std::string(k - 1, 'A') + std::string(2 * k, 'T'),
+            std::string("T") + std::string(k - 1, 'A') + "C",
+            std::string("T") + std::string(k - 1, 'A') + "C",
+            std::string("T") + std::string(k - 1, 'A') + "A",
+            std::string("T") + std::string(k - 1, 'A') + "G"
+        };
+        const std::vector<std::string> labels { "A", "B", "C", "D", "E" };
+
+        auto anno_graph = build_anno_graph<typename TypeParam::first_type,
+                                           typename TypeParam::second_type>(k, sequences, labels);
+
+        const std::unordered_set<std::string> ref_kmers {
+            std::string("T") + std::string(k - 1, 'A'),
+            std::string(k - 1, 'A') + "C"
+        };
+
+        MaskedDeBruijnGraph masked_dbg(
+            std::dynamic_pointer_cast<const DeBruijnGraph>(anno_graph->get_graph_ptr()),
+            mask_nodes_by_labels_cached(*anno_graph, { "B", "C" })
+        );
+
+        ASSERT_EQ(anno_graph->get_graph().max_index(), masked_dbg.max_index());
+
+        // the second pass reads the cached values
+        for (size_t i = 0; i < 2; ++i) {
+            std::unordered_set<std::string> obs_kmers;
+            masked_dbg.call_kmers([&](auto, const auto &kmer) { obs_kmers.insert(kmer); });
+            EXPECT_EQ(ref_kmers, obs_kmers) << k;
+        }
+    }
+}
+
+TYPED_TEST(MaskedDeBruijnGraphAlgorithm, AlignToLabelMaskedGraph) {
+    size_t k = 5;
+    std::string reference_a = "ATGCGATCGATTACGGCTAG";
+    std::string reference_b = "ATGCGATCGAGTACGGCTAG";
+    //                                   X
+
+    auto anno_graph = build_anno_graph<typename TypeParam::first_type,
+                                       typename TypeParam::second_type>(
+        k, { reference_a, reference_b }, { "A", "B" }
+    );
+
+    align::DBGAlignerConfig config(align::DBGAlignerConfig::dna_scoring_matrix(2, -1, -2));
+
+    {
+        align::DBGAligner<> aligner(anno_graph->get_graph(), config);
+        auto paths = aligner.align(reference_b);
+        ASSERT_EQ(1ull, paths.size());
+        EXPECT_EQ(reference_b, paths[0].get_sequence());
+        EXPECT_EQ("20=", paths[0].get_cigar().to_string());
+    }
+
+    MaskedDeBruijnGraph masked_dbg(
+        std::dynamic_pointer_cast<const DeBruijnGraph>(anno_graph->get_graph_ptr()),
+        mask_nodes_by_labels_cached(*anno_graph, { "A" })
+    );
+
+    align::DBGAligner<> aligner(masked_dbg, config);
+    auto paths = aligner.align(reference_b);
+    ASSERT_EQ(1ull, paths.size());
+    EXPECT_EQ(reference_a, paths[0].get_sequence());
+    EXPECT_EQ("10=1X9=", paths[0].get_cigar().to_string());
+    EXPECT_TRUE(paths[0].is_valid(masked_dbg, &config));
+}
+
 template <class Graph, class Annotation = annot::ColumnCompressed<>>
 void
 test_mask_unitigs(double inlabel_fraction,
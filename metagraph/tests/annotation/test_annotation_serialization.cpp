@@ -219,4 +219,63 @@ TYPED_TEST(AnnotatorDynamicNoSparseTest, MergeLoad) {
               convert_to_set(this->annotation->get(4)));
 }
 
+TEST(ColumnCompressed, MergeSerialize) {
+    const std::string out = test_dump_basename_vec_good + "_merged";
+    for (size_t mem_bytes : { 0, 1, 100, 1'000'000 }) {
+        for (size_t num_threads : { 1, 4 }) {
+            {
+                annot::ColumnCompressed<> annotation(5);
+                annotation.set(0, { "Label0", "Label2", "Label8" });
+                annotation.set(2, { "Label1", "Label2" });
+                annotation.set(4, { "Label8" });
+                annotation.serialize(test_dump_basename_vec_good + "_1");
+            }
+            {
+                annot::ColumnCompressed<> annotation(5);
+                annotation.set(1, { "Label0", "Label2", "Label8" });
+                annotation.set(2, { "Label1", "Label9", "Label0" });
+                annotation.set(3, { "Label8" });
+                annotation.serialize(test_dump_basename_vec_good + "_2");
+            }
+            ASSERT_TRUE(annot::ColumnCompressed<>::merge_serialize(
+                { test_dump_basename_vec_good + "_1", test_dump_basename_vec_good + "_2" },
+                out, mem_bytes, num_threads
+            ));
+
+            annot::ColumnCompressed<> annotation;
+            ASSERT_TRUE(annotation.load(out));
+
+            EXPECT_EQ(5u, annotation.num_objects());
+            EXPECT_EQ(5u, annotation.num_labels());
+            EXPECT_EQ(convert_to_set({ "Label0", "Label2", "Label8" }),
+                      convert_to_set(annotation.get(0)));
+            EXPECT_EQ(convert_to_set({ "Label0", "Label2", "Label8" }),
+                      convert_to_set(annotation.get(1)));
+            EXPECT_EQ(convert_to_set({ "Label1", "Label2", "Label9", "Label0" }),
+                      convert_to_set(annotation.get(2)));
+            EXPECT_EQ(convert_to_set({ "Label8" }),
+                      convert_to_set(annotation.get(3)));
+            EXPECT_EQ(convert_to_set({ "Label8" }),
+                      convert_to_set(annotation.get(4)));
+        }
+    }
+}
+
+TEST(ColumnCompressed, MergeSerializeInconsistentRows) {
+    {
+        annot::ColumnCompressed<> annotation(5);
+        annotation.set(0, { "Label0" });
+        annotation.serialize(test_dump_basename_vec_good + "_1");
+    }
+    {
+        annot::ColumnCompressed<> annotation(6);
+        annotation.set(1, { "Label0" });
+        annotation.serialize(test_dump_basename_vec_good + "_2");
+    }
+    EXPECT_FALSE(annot::ColumnCompressed<>::merge_serialize(
+        { test_dump_basename_vec_good + "_1", test_dump_basename_vec_good + "_2" },
+        test_dump_basename_vec_good + "_merged", 1'000'000
+    ));
+}
+
 } // namespace
@@ -1,4 +1,5 @@
 #include <filesystem>
+#include <fstream>
 #include <random>
 
 #include <gmock/gmock.h>
@@ -7,6 +8,7 @@
 #include "../test_helpers.hpp"
 #include "annotation/representation/column_compressed/annotate_column_compressed.hpp"
 #include "annotation/representation/row_compressed/annotate_row_compressed.hpp"
+#include "annotation/representation/row_sharded/annotate_row_sharded.hpp"
 #include "annotation/representation/annotation_matrix/static_annotators_def.hpp"
 #include "annotation/annotation_converters.hpp"
 #include "annotation/binary_matrix/base/binary_matrix.hpp"
@@ -311,6 +313,124 @@ TEST(RowDiff, ConvertFromColumnCompressedSameLabels) {
     std::filesystem::remove_all(dst_dir);
 }
 
+TEST(RowDiff, ConvertFromColumnCompressedAnchorsForQueries) {
+    const auto dst_dir = std::filesystem::path(test_dump_basename)/"row_diff_queries";
+    const std::string graph_fname
+            = dst_dir/(std::string("ACGTCAG") + graph::DBGSuccinct::kExtension);
+    const std::string annot_fname
+            = dst_dir/(std::string("ACGTCAG") + ColumnCompressed<>::kExtension);
+    const std::string dest_fname
+            = dst_dir/(std::string("ACGTCAG") + RowDiffColumnAnnotator::kExtension);
+    const std::string queries_fname = dst_dir/"queries.fa";
+
+    /**
+     * Row-diff path (annotation rows): 1 -> 3 -> 4 -> 2 -> 0, anchor: 0
+     * Query: ACG (row 1), cut at depth 1 with a new anchor at row 3
+     */
+    for (double max_extra_anchors : { 0., 1. }) {
+        std::filesystem::remove_all(dst_dir);
+        std::filesystem::create_directories(dst_dir);
+
+        std::unique_ptr<graph::DBGSuccinct> graph = create_graph(3, { "ACGTCAG" });
+        graph->serialize(graph_fname);
+
+        ColumnCompressed<> source_annot(5);
+        source_annot.add_labels({ 0, 1, 2, 3, 4 }, { "Label0" });
+        source_annot.serialize(annot_fname);
+
+        std::ofstream(queries_fname) << ">query\nACG\n>query\nACG\n";
+
+        convert_to_row_diff({ annot_fname }, graph_fname, 1e9, 5, dst_dir, false,
+                            { queries_fname }, 1, max_extra_anchors);
+
+        binmat::RowDiff<binmat::ColumnMajor>::anchor_bv_type anchors;
+        std::ifstream fanchors(graph_fname + binmat::kRowDiffAnchorExt + ".unopt",
+                               std::ios::binary);
+        ASSERT_TRUE(anchors.load(fanchors));
+        ASSERT_EQ(5u, anchors.size());
+        EXPECT_TRUE(anchors[0]);
+        EXPECT_EQ(max_extra_anchors > 0, anchors[3]);
+        EXPECT_EQ(max_extra_anchors > 0 ? 2u : 1u, anchors.num_set_bits());
+
+        ASSERT_TRUE(std::filesystem::exists(dest_fname));
+        RowDiffColumnAnnotator annotator;
+        annotator.load(dest_fname);
+        const_cast<binmat::RowDiff<binmat::ColumnMajor> &>(annotator.get_matrix())
+                .set_graph(graph.get());
+        const_cast<binmat::RowDiff<binmat::ColumnMajor> &>(annotator.get_matrix())
+                .load_anchor(graph_fname + binmat::kRowDiffAnchorExt + ".unopt");
+
+        ASSERT_EQ(5u, annotator.num_objects());
+        EXPECT_EQ(anchors.num_set_bits(), annotator.num_relations());
+        for (uint32 i = 0; i < annotator.num_objects(); ++i) {
+            ASSERT_THAT(annotator.get(i), ElementsAre("Label0"));
+        }
+    }
+    std::filesystem::remove_all(dst_dir);
+}
+
+TEST(RowDiff, ConvertFromColumnCompressedAnchorsForQueriesTwoBatches) {
+    const auto dst_dir = std::filesystem::path(test_dump_basename)/"row_diff_queries_batches";
+    const std::string graph_fname
+            = dst_dir/(std::string("ACGTCAG") + graph::DBGSuccinct::kExtension);
+    const std::string anchors_fname
+            = graph_fname + binmat::kRowDiffAnchorExt + ".unopt";
+
+    std::filesystem::remove_all(dst_dir);
+    std::filesystem::create_directories(dst_dir);
+
+    std::unique_ptr<graph::DBGSuccinct> graph = create_graph(3, { "ACGTCAG" });
+    graph->serialize(graph_fname);
+
+    /**
+     * Row-diff path (annotation rows): 1 -> 3 -> 4 -> 2 -> 0, anchor: 0
+     * Batch 1, query: ACG (row 1), cut at depth 1 with a new anchor at row 3
+     * Batch 2, query: GTC (row 4), would be cut with a new anchor at row 2,
+     * but the anchors are already used by the columns in batch 1
+     */
+    const std::vector<std::string> labels = { "Label0", "Label1" };
+    const std::vector<std::string> queries = { ">query\nACG\n", ">query\nGTC\n" };
+    for (size_t i = 0; i < labels.size(); ++i) {
+        const std::string annot_fname
+                = dst_dir/(labels[i] + ColumnCompressed<>::kExtension);
+        ColumnCompressed<> source_annot(5);
+        source_annot.add_labels({ 0, 1, 2, 3, 4 }, { labels[i] });
+        source_annot.serialize(annot_fname);
+
+        const std::string queries_fname = dst_dir/"queries.fa";
+        std::ofstream(queries_fname) << queries[i];
+
+        convert_to_row_diff({ annot_fname }, graph_fname, 1e9, 5, dst_dir, false,
+                            { queries_fname }, 1, 1.);
+    }
+
+    binmat::RowDiff<binmat::ColumnMajor>::anchor_bv_type anchors;
+    std::ifstream fanchors(anchors_fname, std::ios::binary);
+    ASSERT_TRUE(anchors.load(fanchors));
+    ASSERT_EQ(5u, anchors.size());
+    EXPECT_TRUE(anchors[0]);
+    EXPECT_TRUE(anchors[3]);
+    EXPECT_EQ(2u, anchors.num_set_bits());
+
+    for (const std::string &label : labels) {
+        const std::string dest_fname
+                = dst_dir/(label + RowDiffColumnAnnotator::kExtension);
+        ASSERT_TRUE(std::filesystem::exists(dest_fname));
+        RowDiffColumnAnnotator annotator;
+        annotator.load(dest_fname);
+        const_cast<binmat::RowDiff<binmat::ColumnMajor> &>(annotator.get_matrix())
+                .set_graph(graph.get());
+        const_cast<binmat::RowDiff<binmat::ColumnMajor> &>(annotator.get_matrix())
+                .load_anchor(anchors_fname);
+
+        ASSERT_EQ(5u, annotator.num_objects());
+        for (uint32 i = 0; i < annotator.num_objects(); ++i) {
+            EXPECT_THAT(annotator.get(i), ElementsAre(label)) << label << " " << i;
+        }
+    }
+    std::filesystem::remove_all(dst_dir);
+}
+
 TEST(RowDiff, ConvertFromColumnCompressedSameLabelsMultipleColumns) {
     const auto dst_dir = std::filesystem::path(test_dump_basename)/"row_diff_multi_col";
     const std::string graph_fname
@@ -1094,4 +1214,60 @@ TEST(ColumnCompressed, ToRowAnnotatorStreamingParallel) {
     }
 }
 
+TEST(ColumnCompressed, SplitByRows) {
+    const size_t num_rows = 10;
+    ColumnCompressed<> annotation(num_rows);
+    annotation.add_labels({ 0, 1, 9 }, {"Label0", "Label2"});
+    annotation.add_labels({ 2 }, {"Label1"});
+    annotation.add_labels({ 4, 5, 6 }, {"Label2", "Label8"});
+    annotation.add_labels({ 8 }, {"Label9"});
+
+    for (const std::vector<uint64_t> &boundaries : std::vector<std::vector<uint64_t>> {
+                { 0, 10 }, { 0, 3, 10 }, { 0, 1, 2, 3, 7, 10 }, { 0, 5, 5, 10 } }) {
+        for (size_t num_threads : { 1, 4 }) {
+            split_by_rows(annotation, boundaries, test_dump_basename, num_threads);
+
+            std::vector<std::unique_ptr<MultiLabelEncoded<std::string>>> shards;
+            for (size_t s = 0; s + 1 < boundaries.size(); ++s) {
+                shards.push_back(std::make_unique<ColumnCompressed<>>());
+                ASSERT_TRUE(shards.back()->load(
+                    RowShardedAnnotator<>::shard_filename(test_dump_basename, s)
+                ));
+                EXPECT_EQ(boundaries[s + 1] - boundaries[s], shards.back()->num_objects());
+            }
+
+            RowShardedAnnotator<> sharded(std::move(shards), num_threads);
+            ASSERT_EQ(annotation.num_objects(), sharded.num_objects());
+            ASSERT_EQ(annotation.num_labels(), sharded.num_labels());
+            ASSERT_EQ(annotation.num_relations(), sharded.num_relations());
+
+            std::vector<uint64_t> rows;
+            std::vector<std::pair<uint64_t, size_t>> index_counts;
+            for (size_t i = 0; i < num_rows; ++i) {
+                EXPECT_EQ(convert_to_set(annotation.get(i)),
+                          convert_to_set(sharded.get(i)));
+                EXPECT_EQ(annotation.get_matrix().get_row(i),
+                          sharded.get_matrix().get_row(i));
+                rows.push_back(num_rows - i - 1);
+                index_counts.emplace_back(i, i + 1);
+            }
+
+            EXPECT_EQ(annotation.get_matrix().get_rows(rows),
+                      sharded.get_matrix().get_rows(rows));
+
+            for (size_t j = 0; j < annotation.num_labels(); ++j) {
+                EXPECT_EQ(annotation.get_matrix().get_column(j),
+                          sharded.get_matrix().get_column(j));
+            }
+
+            for (size_t min_count : { 1, 5, 20 }) {
+                for (size_t count_cap : { 20, 100 }) {
+                    EXPECT_EQ(annotation.count_labels(index_counts, min_count, count_cap),
+                              sharded.count_labels(index_counts, min_count, count_cap));
+                }
+            }
+        }
+    }
+}
+
 } // namespace
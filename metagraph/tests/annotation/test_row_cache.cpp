@@ -0,0 +1,104 @@
+#include <random>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "annotation/binary_matrix/base/row_cache.hpp"
+#include "annotation/binary_matrix/row_vector/unique_row_binmat.hpp"
+
+
+namespace {
+
+using namespace mtg;
+using namespace mtg::annot::binmat;
+
+const uint64_t kNumRows = 10'000;
+
+UniqueRowBinmat build_matrix() {
+    std::vector<BinaryMatrix::SetBitPositions> unique_rows {
+        {}, { 0 }, { 1, 3 }, { 0, 1, 2, 3 }, { 2 }
+    };
+    std::vector<uint32_t> row_rank(kNumRows);
+    for (uint64_t i = 0; i < kNumRows; ++i) {
+        row_rank[i] = i % unique_rows.size();
+    }
+    return UniqueRowBinmat(std::move(unique_rows), std::move(row_rank), 4);
+}
+
+
+TEST(RowCache, GetRows) {
+    auto matrix = build_matrix();
+    RowCache cache(matrix, 100, 4);
+
+    for (size_t pass = 0; pass < 3; ++pass) {
+        for (uint64_t i = 0; i < kNumRows; i += 7) {
+            EXPECT_EQ(matrix.get_row(i), cache.get_row(i));
+        }
+    }
+    EXPECT_GE(cache.capacity(), cache.size());
+
+    std::vector<uint64_t> rows { 5, 3, 5, 1000, 3, 9999 };
+    auto cached_rows = cache.get_rows(rows);
+    ASSERT_EQ(rows.size(), cached_rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_EQ(matrix.get_row(rows[i]), cached_rows[i]);
+    }
+}
+
+TEST(RowCache, HotRowsStayCached) {
+    auto matrix = build_matrix();
+    RowCache cache(matrix, 100, 4);
+
+    // a scan over the rows interleaved with queries of the hot rows [0, 50)
+    for (uint64_t i = 50; i < kNumRows; ++i) {
+        cache.get_row(i);
+        cache.get_row(i % 50);
+    }
+
+    uint64_t num_hits = cache.num_hits();
+    for (uint64_t i = 0; i < 50; ++i) {
+        cache.get_row(i);
+    }
+    EXPECT_LE(num_hits + 45, cache.num_hits());
+}
+
+TEST(RowCache, Clear) {
+    auto matrix = build_matrix();
+    RowCache cache(matrix, 100);
+
+    cache.get_row(1);
+    cache.get_row(1);
+    EXPECT_EQ(1u, cache.num_hits());
+    EXPECT_EQ(1u, cache.num_misses());
+    EXPECT_EQ(0.5, cache.hit_rate());
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(0u, cache.num_hits());
+    EXPECT_EQ(0u, cache.num_misses());
+}
+
+TEST(RowCache, ConcurrentAccess) {
+    auto matrix = build_matrix();
+    RowCache cache(matrix, 500, 8);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 gen(t);
+            for (size_t i = 0; i < 10'000; ++i) {
+                // skewed access: half of the queries hit the first 100 rows
+                uint64_t row = i % 2 ? gen() % 100 : gen() % kNumRows;
+                ASSERT_EQ(matrix.get_row(row), cache.get_rows({ row, row / 2 })[0]);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_GE(cache.capacity(), cache.size());
+    EXPECT_LT(0.3, cache.hit_rate());
+}
+
+} // namespace
@@ -0,0 +1,93 @@
+#include <iterator>
+#include <set>
+
+#include "gtest/gtest.h"
+
+#include "../graph/all/test_dbg_helpers.hpp"
+
+#include "annotation/representation/column_compressed/annotate_column_compressed.hpp"
+#include "cli/config/config.hpp"
+#include "cli/query.hpp"
+#include "common/seq_tools/reverse_complement.hpp"
+#include "common/threads/threading.hpp"
+#include "graph/annotated_dbg.hpp"
+#include "graph/representation/hash/dbg_hash_ordered.hpp"
+
+
+namespace {
+
+using namespace mtg;
+using namespace mtg::test;
+using namespace mtg::graph;
+
+const size_t k = 5;
+// the two references share the prefix up to the fork at the k-mer AACAA
+const std::vector<std::string> references {
+    "ACTCTATCTTAGTAACAAGCGAGGACTTCG",
+    "ACTCTATCTTAGTAACAATGTGGTCGTTCT"
+};
+const std::string query = "TTAGTAACA";
+
+std::set<std::string> get_kmers(const std::vector<std::string> &sequences, bool canonical) {
+    std::set<std::string> kmers;
+    for (std::string sequence : sequences) {
+        for (size_t i = 0; i + k <= sequence.size(); ++i) {
+            kmers.insert(sequence.substr(i, k));
+        }
+        if (canonical) {
+            reverse_complement(sequence);
+            for (size_t i = 0; i + k <= sequence.size(); ++i) {
+                kmers.insert(sequence.substr(i, k));
+            }
+        }
+    }
+    return kmers;
+}
+
+void check_hull(bool canonical, const std::vector<std::string> &expected) {
+    auto graph = build_graph_batch<DBGHashOrdered>(k, references,
+                                                   canonical ? CANONICAL : NORMAL);
+    AnnotatedDBG anno_graph(graph,
+                            std::make_unique<annot::ColumnCompressed<>>(graph->max_index()));
+    for (const auto &reference : references) {
+        anno_graph.annotate_sequence(std::string(reference), { reference });
+    }
+
+    const char *argv[] = { "metagraph", "query", "-i", "graph", "-a", "annotation",
+                           "--max-hull-forks", "4", "--max-hull-depth", "3",
+                           "query.fa" };
+    cli::Config config(std::size(argv), const_cast<char **>(argv));
+
+    for (size_t num_threads : { 1, 4 }) {
+        set_num_threads(num_threads);
+        auto query_graph = cli::construct_query_graph(
+            anno_graph,
+            [&](std::function<void(const std::string &)> call_sequence) {
+                call_sequence(query);
+            },
+            num_threads,
+            canonical,
+            &config
+        );
+
+        std::set<std::string> kmers;
+        query_graph->get_graph().call_kmers([&](auto, const std::string &kmer) {
+            kmers.insert(kmer);
+        });
+        EXPECT_EQ(get_kmers(expected, canonical), kmers) << num_threads;
+    }
+    set_num_threads(1);
+}
+
+TEST(QueryGraph, HullExpansion) {
+    // the traversal from the end of the query takes both branches of the fork
+    // and stops three nodes after the query
+    check_hull(false, { "TTAGTAACAAGC", "ACAATG" });
+}
+
+TEST(QueryGraph, HullExpansionCanonical) {
+    // the reverse complement of the query is expanded as well
+    check_hull(true, { "ATCTTAGTAACAAGC", "ACAATG" });
+}
+
+} // namespace
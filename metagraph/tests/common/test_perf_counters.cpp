@@ -0,0 +1,69 @@
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "common/perf_counters.hpp"
+
+
+namespace {
+
+using namespace mtg::common;
+
+TEST(PerfCounters, CounterConcurrent) {
+    auto &counter = get_counter("test_concurrent_total", "Test counter");
+    ASSERT_EQ(&counter, &get_counter("test_concurrent_total", "Test counter"));
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (size_t i = 0; i < 1000; ++i) {
+                counter.add();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(4000u, counter.get());
+}
+
+TEST(PerfCounters, Histogram) {
+    auto &histogram = get_histogram("test_histogram_seconds", "Test histogram");
+    histogram.observe(0.005);
+    histogram.observe(0.05);
+    histogram.observe(1e6);
+
+    EXPECT_EQ(3u, histogram.count());
+    EXPECT_EQ(0u, histogram.cumulative_count(1));
+    EXPECT_EQ(1u, histogram.cumulative_count(2));
+    EXPECT_EQ(2u, histogram.cumulative_count(3));
+    EXPECT_EQ(2u, histogram.cumulative_count(LatencyHistogram::kBuckets.size() - 1));
+    EXPECT_NEAR(1e6 + 0.055, histogram.sum(), 1e-6);
+
+    {
+        ScopedLatency timer(histogram);
+    }
+    EXPECT_EQ(4u, histogram.count());
+}
+
+TEST(PerfCounters, NameClash) {
+    get_counter("test_clash", "Test counter");
+    EXPECT_THROW(get_histogram("test_clash", "Test histogram"), std::runtime_error);
+}
+
+TEST(PerfCounters, Render) {
+    get_counter("test_render_total", "Rendered counter").add(5);
+    get_histogram("test_render_seconds", "Rendered histogram").observe(0.5);
+
+    std::string metrics = render_perf_counters();
+    EXPECT_NE(std::string::npos, metrics.find("# TYPE test_render_total counter\n"));
+    EXPECT_NE(std::string::npos, metrics.find("test_render_total 5\n"));
+    EXPECT_NE(std::string::npos, metrics.find("# TYPE test_render_seconds histogram\n"));
+    EXPECT_NE(std::string::npos, metrics.find("test_render_seconds_bucket{le=\"0.1\"} 0\n"));
+    EXPECT_NE(std::string::npos, metrics.find("test_render_seconds_bucket{le=\"1\"} 1\n"));
+    EXPECT_NE(std::string::npos, metrics.find("test_render_seconds_bucket{le=\"+Inf\"} 1\n"));
+    EXPECT_NE(std::string::npos, metrics.find("test_render_seconds_count 1\n"));
+}
+
+} // namespace
@@ -8,6 +8,7 @@
 #include "../../test_helpers.hpp"
 #include "test_dbg_helpers.hpp"
 #include "graph/graph_extensions/node_weights.hpp"
+#include "graph/graph_extensions/minimizer_index.hpp"
 
 
 namespace {
@@ -178,6 +179,58 @@ TYPED_TEST(DeBruijnGraphTest, Weighted) {
     }
 }
 
+TYPED_TEST(DeBruijnGraphTest, MinimizerIndex) {
+    std::vector<std::string> sequences {
+        "CATGTACTAGCTGATCGTAGCTAGCTAGCGATCGATCGTACGTAGCTAGCTAGCATCGA",
+        "AAAAAAAAAAAAAAAAAAAAAAAAAAAAA",
+        "GGCTAGCTAGCATCGACGGCGCGCATATGCGCTTTATATCGATCGTAGCTAGCT"
+    };
+
+    for (size_t k = 4; k < 15; ++k) {
+        auto graph = build_graph<TypeParam>(k, sequences);
+
+        for (size_t m = 1; m <= k; m += 3) {
+            MinimizerIndex index(*graph, m, 2);
+            EXPECT_TRUE(index.is_compatible(*graph));
+            EXPECT_LE(index.num_sampled_kmers(), graph->num_nodes());
+
+            // all sampled k-mers of the graph sequences must be found
+            size_t num_sampled = 0;
+            for (const auto &sequence : sequences) {
+                std::vector<bool> found(sequence.size() - k + 1, false);
+                index.call_nodes(sequence, [&](size_t i, auto node) {
+                    if (graph->get_node_sequence(node) == sequence.substr(i, k))
+                        found[i] = true;
+                });
+                index.call_sampled_kmers(sequence, [&](size_t i, uint64_t) {
+                    EXPECT_TRUE(found[i]) << k << " " << m << " " << sequence;
+                    ++num_sampled;
+                });
+            }
+            EXPECT_LT(0u, num_sampled);
+
+            index.serialize(test_dump_basename);
+            MinimizerIndex loaded;
+            ASSERT_TRUE(loaded.load(test_dump_basename));
+            EXPECT_TRUE(loaded.is_compatible(*graph));
+            EXPECT_EQ(index.get_minimizer_length(), loaded.get_minimizer_length());
+            EXPECT_EQ(index.num_sampled_kmers(), loaded.num_sampled_kmers());
+
+            for (const auto &sequence : sequences) {
+                std::vector<std::pair<size_t, uint64_t>> expected;
+                std::vector<std::pair<size_t, uint64_t>> nodes;
+                index.call_nodes(sequence, [&](size_t i, auto node) {
+                    expected.emplace_back(i, node);
+                });
+                loaded.call_nodes(sequence, [&](size_t i, auto node) {
+                    nodes.emplace_back(i, node);
+                });
+                EXPECT_EQ(expected, nodes);
+            }
+        }
+    }
+}
+
 TYPED_TEST(DeBruijnGraphTest, ReverseComplement) {
     auto graph1 = build_graph<TypeParam>(12, { "AAAAAAAAAAAAAAAAAAAAAAAAAAAAA" });
     auto graph2 = build_graph<TypeParam>(12, { "AAAAAAAAAAAAAAAAAAAAAAAAAAAAA",
@@ -3,6 +3,7 @@
 #define private public
 #define protected public
 
+#include <random>
 #include <set>
 
 #include "../../test_helpers.hpp"
@@ -909,4 +910,42 @@ TYPED_TEST(DeBruijnGraphTest, CallUnitigsCross) {
     }
 }
 
+TYPED_TEST(DeBruijnGraphTest, CallUnitigsParallelSameAsSequential) {
+    std::mt19937 rng(42);
+    std::vector<std::string> sequences;
+    for (size_t i = 0; i < 50; ++i) {
+        std::string seq(200, 'A');
+        for (char &c : seq) {
+            c = "ACGT"[rng() % 4];
+        }
+        sequences.push_back(seq);
+    }
+    // add repeats and loops
+    sequences.push_back(sequences[0].substr(10, 50) + sequences[1].substr(20, 50));
+    sequences.push_back(std::string(30, 'A'));
+    sequences.push_back("ACGTACGTACGTACGT");
+
+    for (size_t k : { 3, 5, 9 }) {
+        auto graph = build_graph_batch<TypeParam>(k, sequences);
+
+        for (size_t min_tip_size : { 1, 3 }) {
+            std::multiset<std::string> unitigs;
+            graph->call_unitigs([&](const auto &sequence, const auto &) {
+                unitigs.insert(sequence);
+            }, 1, min_tip_size);
+
+            for (size_t num_threads : { 2, 4, 8 }) {
+                std::multiset<std::string> obs_unitigs;
+                std::mutex seq_mutex;
+                graph->call_unitigs([&](const auto &sequence, const auto &path) {
+                    ASSERT_EQ(path, map_sequence_to_nodes(*graph, sequence));
+                    std::unique_lock<std::mutex> lock(seq_mutex);
+                    obs_unitigs.insert(sequence);
+                }, num_threads, min_tip_size);
+                EXPECT_EQ(unitigs, obs_unitigs) << k << " " << num_threads;
+            }
+        }
+    }
+}
+
 } // namespace
@@ -83,6 +83,17 @@ void test_graph(BOSS *graph, const std::string &last,
     test_graph(graph, last, W, F, BOSS::State::DYN);
     test_graph(graph, last, W, F, BOSS::State::SMALL);
     test_graph(graph, last, W, F, BOSS::State::DYN);
+
+    if (graph->get_W().logsigma() <= occ_table_vector::kMaxLogSigma) {
+        test_graph(graph, last, W, F, BOSS::State::OCC);
+        test_graph(graph, last, W, F, BOSS::State::STAT);
+        test_graph(graph, last, W, F, BOSS::State::OCC);
+        test_graph(graph, last, W, F, BOSS::State::INTERLEAVED);
+        test_graph(graph, last, W, F, BOSS::State::INTERLEAVED);
+        test_graph(graph, last, W, F, BOSS::State::SMALL);
+        test_graph(graph, last, W, F, BOSS::State::INTERLEAVED);
+        test_graph(graph, last, W, F, BOSS::State::DYN);
+    }
 }
 
 
@@ -1,4 +1,5 @@
 #include <cstdio>
+#include <fstream>
 #include <string>
 #include <sstream>
 #include <mutex>
@@ -330,6 +331,144 @@ TEST(BOSSConstruct, ConstructionFromChunks) {
     }
 }
 
+TEST(BOSSConstruct, ConstructionSuperkmerBins) {
+    std::vector<std::pair<std::string, uint64_t>> input_data = {
+        { "ACAGCTAGCTAGCTAGCTAGCTG", 1 },
+        { "ATATTATAAAAAATTTTAAAAAA", 3 },
+        { "ATATATTCTCTCTCTCTCATANNNNNATATATTCTCTCTCTCTCATA", 2 },
+        { "GTGTGTGTGGGGGGCCCTTTTTTCATA", 1 },
+        { std::string(100, 'T') + "A" + std::string(100, 'G'), 1 },
+    };
+#if ! _PROTEIN_GRAPH
+    const std::vector<bool> canonical_modes = { false, true };
+#else
+    const std::vector<bool> canonical_modes = { false };
+#endif
+    for (size_t k = 1; k < kMaxK; k += 3) {
+        for (auto container : { kmer::ContainerType::VECTOR, kmer::ContainerType::VECTOR_DISK }) {
+            for (bool canonical : canonical_modes) {
+                for (bool weighted : { false, true }) {
+                    auto build = [&](size_t num_threads, size_t num_superkmer_bins) {
+                        auto constructor = IBOSSChunkConstructor::initialize(
+                            k, canonical, weighted ? 8 : 0, "", num_threads, 20000,
+                            container, "/tmp/", 1e9, num_superkmer_bins
+                        );
+                        for (const auto &[sequence, count] : input_data) {
+                            constructor->add_sequence(sequence, count);
+                        }
+                        auto boss = std::make_unique<BOSS>(k);
+                        sdsl::int_vector<> weights;
+                        constructor->build_chunk().initialize_boss(boss.get(),
+                                                                  weighted ? &weights : nullptr);
+                        return std::make_pair(std::move(boss), weights);
+                    };
+
+                    auto [expected, expected_weights] = build(1, 0);
+
+                    for (size_t num_threads : { 1, 4 }) {
+                        for (size_t num_superkmer_bins : { 1, 7 }) {
+                            auto [boss, weights] = build(num_threads, num_superkmer_bins);
+                            EXPECT_EQ(*expected, *boss)
+                                << k << " " << canonical << " " << num_superkmer_bins;
+                            if (weighted)
+                                EXPECT_EQ(expected_weights, weights);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(BOSSConstruct, ConstructionFromChunksSinglePass) {
+    std::vector<std::pair<std::string, uint64_t>> input_data = {
+        { "ACAGCTAGCTAGCTAGCTAGCTG", 1 },
+        { "ATATTATAAAAAATTTTAAAAAA", 3 },
+        { "ATATATTCTCTCTCTCTCATANNNNNATATATTCTCTCTCTCTCATA", 2 },
+        { std::string(100, 'T') + "A" + std::string(100, 'G'), 1 },
+    };
+#if ! _PROTEIN_GRAPH
+    const std::vector<bool> canonical_modes = { false, true };
+#else
+    const std::vector<bool> canonical_modes = { false };
+#endif
+    auto read_file = [](const std::string &filename) {
+        std::ifstream in(filename, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), {});
+    };
+
+    for (size_t k = 2; k < kMaxK; k += 5) {
+        for (auto container : { kmer::ContainerType::VECTOR, kmer::ContainerType::VECTOR_DISK }) {
+            for (size_t suffix_len = 1; suffix_len < std::min(k, (size_t)3u); ++suffix_len) {
+                for (bool canonical : canonical_modes) {
+                    for (bool weighted : { false, true }) {
+                        const auto suffixes = KmerExtractorBOSS::generate_suffixes(suffix_len);
+
+                        std::vector<std::string> chunk_files;
+                        for (const std::string &suffix : suffixes) {
+                            auto constructor = IBOSSChunkConstructor::initialize(
+                                k, canonical, weighted ? 8 : 0, suffix, 1, 20000, container
+                            );
+                            for (const auto &[sequence, count] : input_data) {
+                                constructor->add_sequence(sequence, count);
+                            }
+                            chunk_files.push_back(test_dump_basename + "." + suffix);
+                            constructor->build_chunk().serialize(chunk_files.back());
+                        }
+
+                        auto multi_constructor = IBOSSMultiChunkConstructor::initialize(
+                            k, canonical, weighted ? 8 : 0, suffixes, 4, 20000, container
+                        );
+                        multi_constructor->add_sequences(
+                            std::vector<std::pair<std::string, uint64_t>>(input_data)
+                        );
+
+                        std::vector<std::string> multi_chunk_files(suffixes.size());
+                        multi_constructor->call_chunks([&](size_t i, BOSS::Chunk&& chunk) {
+                            multi_chunk_files[i] = test_dump_basename + ".multi." + suffixes[i];
+                            chunk.serialize(multi_chunk_files[i]);
+                        });
+
+                        for (size_t i = 0; i < suffixes.size(); ++i) {
+                            ASSERT_FALSE(multi_chunk_files[i].empty()) << suffixes[i];
+                            EXPECT_EQ(read_file(chunk_files[i] + BOSS::Chunk::kFileExtension),
+                                      read_file(multi_chunk_files[i] + BOSS::Chunk::kFileExtension))
+                                << k << " " << suffixes[i] << " " << canonical << " " << weighted;
+                        }
+
+                        sdsl::int_vector<> expected_weights;
+                        std::unique_ptr<BOSS> expected(BOSS::Chunk::build_boss_from_chunks(
+                            chunk_files, false, weighted ? &expected_weights : nullptr
+                        ).first);
+                        sdsl::int_vector<> weights;
+                        std::unique_ptr<BOSS> boss(BOSS::Chunk::build_boss_from_chunks(
+                            multi_chunk_files, false, weighted ? &weights : nullptr
+                        ).first);
+
+                        ASSERT_TRUE(expected);
+                        ASSERT_TRUE(boss);
+                        EXPECT_EQ(*expected, *boss);
+                        EXPECT_EQ(expected_weights, weights);
+
+                        if (canonical)
+                            continue;
+
+                        auto full_constructor = IBOSSChunkConstructor::initialize(
+                            k, canonical, weighted ? 8 : 0, "", 1, 20000, container
+                        );
+                        for (const auto &[sequence, count] : input_data) {
+                            full_constructor->add_sequence(sequence, count);
+                        }
+                        BOSS full(k);
+                        full_constructor->build_chunk().initialize_boss(&full);
+                        EXPECT_EQ(full, *boss);
+                    }
+                }
+            }
+        }
+    }
+}
+
 // TODO: k is node length
 template <typename KMER>
 void sequence_to_kmers_parallel_wrapper(std::vector<std::string> *reads,
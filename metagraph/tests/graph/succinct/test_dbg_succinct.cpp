@@ -1,6 +1,8 @@
 #include "graph/representation/succinct/dbg_succinct.hpp"
+#include "graph/representation/succinct/interleaved_edges.hpp"
 
 #include "graph/representation/base/sequence_graph.hpp"
+#include "common/seq_tools/reverse_complement.hpp"
 
 #include <gtest/gtest.h>
 
@@ -10,6 +12,11 @@ namespace {
 using namespace mtg;
 using namespace mtg::graph;
 
+using mtg::graph::boss::BOSS;
+
+const std::string test_data_dir = "../tests/data";
+const std::string test_dump_basename = test_data_dir + "/dbg_succinct_dump_test";
+
 TEST(DBGSuccinct, get_degree_with_source_dummy) {
     for (size_t k = 2; k < 10; ++k) {
         auto graph = std::make_unique<DBGSuccinct>(k);
@@ -526,4 +533,102 @@ TEST(DBGSuccinct, CallNodesWithSuffixMultipleInOut) {
     EXPECT_EQ(ref_node_str, node_str) << *graph;
 }
 
+
+void check_same_nodes(const DBGSuccinct &graph, const DBGSuccinct &reference) {
+    ASSERT_EQ(reference.num_nodes(), graph.num_nodes());
+    reference.call_nodes([&](auto node) {
+        ASSERT_EQ(reference.get_node_sequence(node), graph.get_node_sequence(node));
+        EXPECT_EQ(reference.outdegree(node), graph.outdegree(node));
+        EXPECT_EQ(reference.indegree(node), graph.indegree(node));
+        EXPECT_EQ(node, graph.kmer_to_node(reference.get_node_sequence(node)));
+    });
+}
+
+TEST(DBGSuccinct, MapToNodesWithRC) {
+    size_t k = 5;
+    std::string reference = "ACGTCAGGGATTACCGAT";
+    std::string reference_rc = reference;
+    reverse_complement(reference_rc.begin(), reference_rc.end());
+
+    // forward k-mers, an invalid character, and k-mers present only as
+    // reverse complements, some of which are also present in forward
+    std::string query = "ACGTCAGGGAT" "N" + reference_rc.substr(0, 12) + "TTTTTT"
+                            + reference.substr(3, 8);
+
+    for (bool mask_dummy : { false, true }) {
+        DBGSuccinct graph(k);
+        graph.add_sequence(reference);
+        if (mask_dummy)
+            graph.mask_dummy_kmers(1, false);
+
+        std::vector<std::pair<DBGSuccinct::node_index, bool>> nodes;
+        graph.map_to_nodes_with_rc(query, [&](auto node, bool is_rc) {
+            nodes.emplace_back(node, is_rc);
+        });
+
+        ASSERT_EQ(query.size() - k + 1, nodes.size());
+
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            std::string kmer = query.substr(i, k);
+            std::string kmer_rc = kmer;
+            reverse_complement(kmer_rc.begin(), kmer_rc.end());
+
+            auto node = graph.kmer_to_node(kmer);
+            if (node) {
+                EXPECT_EQ(std::make_pair(node, false), nodes[i]) << kmer;
+            } else if ((node = graph.kmer_to_node(kmer_rc))) {
+                EXPECT_EQ(std::make_pair(node, true), nodes[i]) << kmer;
+            } else {
+                EXPECT_EQ(DBGSuccinct::npos, nodes[i].first) << kmer;
+                EXPECT_FALSE(nodes[i].second) << kmer;
+            }
+        }
+    }
+}
+
+TEST(DBGSuccinct, InterleavedState) {
+    const std::vector<std::string> sequences {
+        "AAACACTAGCTAGCTAGCGCGCTATAGCCC", "AGAGAGAGACACTTTAGCAT", "CCCCCCCCCCCCCCCCCC"
+    };
+    for (bool mask_first : { false, true }) {
+        DBGSuccinct reference(5);
+        for (const auto &sequence : sequences) {
+            reference.add_sequence(sequence);
+        }
+        if (reference.get_boss().get_W().logsigma() > boss::InterleavedEdges::kMaxLogSigma)
+            return;
+
+        reference.mask_dummy_kmers(1, false);
+        reference.switch_state(BOSS::State::STAT);
+
+        DBGSuccinct graph(5);
+        for (const auto &sequence : sequences) {
+            graph.add_sequence(sequence);
+        }
+        if (mask_first) {
+            graph.mask_dummy_kmers(1, false);
+            graph.switch_state(BOSS::State::INTERLEAVED);
+        } else {
+            graph.switch_state(BOSS::State::INTERLEAVED);
+            graph.mask_dummy_kmers(1, false);
+        }
+        ASSERT_EQ(BOSS::State::INTERLEAVED, graph.get_state());
+        ASSERT_TRUE(graph.get_mask());
+        EXPECT_EQ(*reference.get_mask(), *graph.get_mask());
+        check_same_nodes(graph, reference);
+
+        graph.serialize(test_dump_basename);
+        DBGSuccinct loaded(2);
+        ASSERT_TRUE(loaded.load(test_dump_basename));
+        ASSERT_EQ(BOSS::State::INTERLEAVED, loaded.get_state());
+        ASSERT_TRUE(loaded.get_mask());
+        EXPECT_EQ(*reference.get_mask(), *loaded.get_mask());
+        check_same_nodes(loaded, reference);
+
+        loaded.switch_state(BOSS::State::STAT);
+        EXPECT_EQ(*reference.get_mask(), *loaded.get_mask());
+        check_same_nodes(loaded, reference);
+    }
+}
+
 } // namespace
@@ -0,0 +1,171 @@
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "graph/representation/succinct/interleaved_edges.hpp"
+
+
+namespace {
+
+using namespace mtg;
+using namespace mtg::graph::boss;
+
+typedef InterleavedEdges::TAlphabet TAlphabet;
+
+// 32 edges per block, 65536 edges per superblock
+const std::vector<uint64_t> kSizes { 1, 31, 32, 33, 1000, 65535, 65536, 65537, 140'000 };
+
+
+void test_bits(const bit_vector &vector, const sdsl::bit_vector &reference) {
+    const uint64_t size = reference.size();
+    ASSERT_EQ(size, vector.size());
+
+    std::vector<uint64_t> next(size + 1, size);
+    for (uint64_t i = size; i-- > 0; ) {
+        next[i] = reference[i] ? i : next[i + 1];
+    }
+
+    uint64_t rank = 0;
+    uint64_t prev = size;
+    for (uint64_t i = 0; i < size; ++i) {
+        ASSERT_EQ(bool(reference[i]), vector[i]) << i;
+        if (reference[i]) {
+            ASSERT_EQ(i, vector.select1(++rank)) << i;
+            prev = i;
+        } else {
+            ASSERT_EQ(i, vector.select0(i + 1 - rank)) << i;
+        }
+        ASSERT_EQ(rank, vector.rank1(i)) << i;
+        ASSERT_EQ(next[i], vector.next1(i)) << i;
+        ASSERT_EQ(prev, vector.prev1(i)) << i;
+
+        uint32_t width = std::min(uint64_t(64), size - i);
+        ASSERT_EQ(reference.get_int(i, width), vector.get_int(i, width)) << i;
+    }
+    EXPECT_EQ(rank, vector.num_set_bits());
+
+    // ranges within a block and across block and superblock boundaries
+    for (auto [begin, end] : std::vector<std::pair<uint64_t, uint64_t>> {
+            { 0, size }, { 1, 31 }, { 31, 33 }, { 30, 65 },
+            { 65535, 65537 }, { 65504, 65568 }, { 100, 131'073 },
+            { size / 3, size - size / 5 } }) {
+        end = std::min(end, size);
+        if (begin >= end)
+            continue;
+
+        std::vector<uint64_t> ones;
+        for (uint64_t i = begin; i < end; ++i) {
+            if (reference[i])
+                ones.push_back(i);
+        }
+        std::vector<uint64_t> called;
+        vector.call_ones_in_range(begin, end, [&](uint64_t i) { called.push_back(i); });
+        EXPECT_EQ(ones, called) << begin << " " << end;
+    }
+}
+
+void test_symbols(const wavelet_tree &vector, const sdsl::int_vector<> &reference) {
+    const uint64_t size = reference.size();
+    const uint64_t sigma = 1llu << vector.logsigma();
+    ASSERT_EQ(size, vector.size());
+
+    for (TAlphabet c = 0; c < sigma; ++c) {
+        std::vector<uint64_t> next(size + 1, size);
+        for (uint64_t i = size; i-- > 0; ) {
+            next[i] = reference[i] == c ? i : next[i + 1];
+        }
+
+        uint64_t rank = 0;
+        uint64_t prev = size;
+        for (uint64_t i = 0; i < size; ++i) {
+            if (reference[i] == c) {
+                ASSERT_EQ(i, vector.select(c, ++rank)) << i;
+                prev = i;
+            }
+            ASSERT_EQ(rank, vector.rank(c, i)) << i;
+            ASSERT_EQ(next[i], vector.next(i, c)) << i;
+            ASSERT_EQ(prev, vector.prev(i, c)) << i;
+        }
+        EXPECT_EQ(rank, vector.count(c));
+    }
+
+    for (uint64_t i = 0; i < size; ++i) {
+        ASSERT_EQ(uint64_t(reference[i]), vector[i]) << i;
+    }
+}
+
+TEST(InterleavedEdges, Queries) {
+    std::mt19937 gen(42);
+    for (uint8_t logsigma : { 1, 4 }) {
+        for (uint64_t size : kSizes) {
+            // sparse, dense, and full bit vectors
+            for (uint32_t density : { 16, 2, 1 }) {
+                sdsl::int_vector<> symbols(size, 0, logsigma);
+                sdsl::bit_vector last(size);
+                sdsl::bit_vector mask(size);
+                for (uint64_t i = 0; i < size; ++i) {
+                    symbols[i] = gen() % (1 << logsigma);
+                    last[i] = gen() % density == 0;
+                    mask[i] = gen() % density != 0;
+                }
+
+                auto edges = std::make_shared<InterleavedEdges>(logsigma);
+                edges->set_symbols(symbols);
+                edges->set_bits(InterleavedEdges::LAST, last);
+                edges->set_bits(InterleavedEdges::MASK, mask);
+
+                test_symbols(InterleavedEdges::SymbolView(edges), symbols);
+                test_bits(InterleavedEdges::BitView(edges, InterleavedEdges::LAST), last);
+                test_bits(InterleavedEdges::BitView(edges, InterleavedEdges::MASK), mask);
+            }
+        }
+    }
+}
+
+TEST(InterleavedEdges, SetIncompatibleBits) {
+    auto edges = std::make_shared<InterleavedEdges>(4);
+    edges->set_symbols(sdsl::int_vector<>(100, 3, 4));
+    EXPECT_THROW(edges->set_bits(InterleavedEdges::LAST, sdsl::bit_vector(99)),
+                 std::runtime_error);
+}
+
+TEST(InterleavedEdges, Serialization) {
+    std::mt19937 gen(42);
+    const uint64_t size = 140'000;
+    sdsl::int_vector<> symbols(size, 0, 4);
+    sdsl::bit_vector last(size);
+    sdsl::bit_vector mask(size);
+    for (uint64_t i = 0; i < size; ++i) {
+        symbols[i] = gen() % 16;
+        last[i] = gen() % 2;
+        mask[i] = gen() % 3 != 0;
+    }
+
+    std::stringstream out;
+    {
+        auto edges = std::make_shared<InterleavedEdges>(4);
+        edges->set_symbols(symbols);
+        edges->set_bits(InterleavedEdges::LAST, last);
+        edges->set_bits(InterleavedEdges::MASK, mask);
+        InterleavedEdges::SymbolView(edges).serialize(out);
+        InterleavedEdges::BitView(edges, InterleavedEdges::LAST).serialize(out);
+        InterleavedEdges::BitView(edges, InterleavedEdges::MASK).serialize(out);
+    }
+
+    auto edges = std::make_shared<InterleavedEdges>(4);
+    InterleavedEdges::SymbolView loaded_symbols(edges);
+    InterleavedEdges::BitView loaded_last(edges, InterleavedEdges::LAST);
+    InterleavedEdges::BitView loaded_mask(edges, InterleavedEdges::MASK);
+    ASSERT_TRUE(loaded_symbols.load(out));
+    ASSERT_TRUE(loaded_last.load(out));
+    ASSERT_TRUE(loaded_mask.load(out));
+
+    EXPECT_EQ(symbols, loaded_symbols.to_vector());
+    EXPECT_EQ(last, loaded_last.to_vector());
+    EXPECT_EQ(mask, loaded_mask.to_vector());
+    test_bits(loaded_last, last);
+}
+
+} // namespace
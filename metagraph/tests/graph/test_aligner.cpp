@@ -5,9 +5,11 @@
 #include "../test_helpers.hpp"
 
 #include "graph/alignment/aligner_methods.hpp"
+#include "graph/graph_extensions/minimizer_index.hpp"
 #include "seq_io/sequence_io.hpp"
 
 #include "common/seq_tools/reverse_complement.hpp"
+#include "common/perf_counters.hpp"
 #include "kmer/alphabets.hpp"
 
 
@@ -644,6 +646,179 @@ TYPED_TEST(DBGAlignerTest, align_multiple_misalignment_bandwidth) {
     }
 }
 
+TYPED_TEST(DBGAlignerTest, align_multiple_misalignment_chain_seeds) {
+    size_t k = 4;
+    std::string reference = "AAAGCGGACCCTTTCCGTTAT";
+    std::string query =     "AAAGGGGACCCTTTTCGTTAT";
+    //                           X         X
+
+    auto graph = build_graph_batch<TypeParam>(k, { reference });
+    DBGAlignerConfig config(DBGAlignerConfig::dna_scoring_matrix(2, -1, -2));
+
+    auto &num_seeds = mtg::common::get_counter("metagraph_alignment_seeds_total",
+                                               "Number of generated alignment seeds");
+    auto &num_extended = mtg::common::get_counter("metagraph_alignment_seeds_extended_total",
+                                                  "Number of alignment seeds extended");
+
+    // 0 disables chaining, so every seed is extended
+    for (size_t max_num_seed_chains : { 0, 1, 2, 10 }) {
+        auto config_chain = config;
+        config_chain.max_num_seed_chains = max_num_seed_chains;
+
+        DBGAligner<> aligner(*graph, config_chain);
+        uint64_t seeds_before = num_seeds.get();
+        uint64_t extended_before = num_extended.get();
+        auto paths = aligner.align(query);
+        uint64_t seeds = num_seeds.get() - seeds_before;
+        uint64_t extended = num_extended.get() - extended_before;
+
+        // the seeds within the runs of matching k-mers are chained, so only
+        // the first seed of each run is extended
+        ASSERT_LT(0u, seeds);
+        if (max_num_seed_chains) {
+            EXPECT_LT(extended, seeds);
+        } else {
+            EXPECT_EQ(seeds, extended);
+        }
+
+        ASSERT_EQ(1ull, paths.size());
+        auto path = paths[0];
+
+        EXPECT_EQ(query.size() - k + 1, path.size());
+        EXPECT_EQ(reference, path.get_sequence());
+        EXPECT_EQ(config.score_sequences(query, reference), path.get_score());
+        EXPECT_EQ("4=1X9=1X6=", path.get_cigar().to_string());
+        EXPECT_EQ(19u, path.get_num_matches());
+        EXPECT_EQ(0u, path.get_clipping());
+        EXPECT_EQ(0u, path.get_end_clipping());
+        EXPECT_TRUE(path.is_valid(*graph, &config));
+        check_json_dump_load(*graph, path, paths.get_query(), paths.get_query(PICK_REV_COMP));
+
+        check_extend(graph, aligner.get_config(), paths, query);
+    }
+}
+
+TYPED_TEST(DBGAlignerTest, align_multiple_misalignment_minimizer_seeds) {
+    size_t k = 7;
+    std::string reference = "AAAGCGGACCCTTTCCGTTATGCACGTTAGCAATCGTAGCTAGCTGATCGG";
+    std::string query =     "AAAGCGGACCCTTTCCGTTATGCACGTTAGCTATCGTAGCTAGCTGATCGG";
+    //                                                      X
+
+    auto graph = build_graph_batch<TypeParam>(k, { reference });
+    graph->add_extension(std::make_shared<MinimizerIndex>(*graph, 3));
+
+    DBGAlignerConfig config(DBGAlignerConfig::dna_scoring_matrix(2, -1, -2));
+    config.min_seed_length = k;
+    config.max_seed_length = k;
+    DBGAligner<MinimizerSeeder<>> aligner(*graph, config);
+    auto paths = aligner.align(query);
+
+    ASSERT_EQ(1ull, paths.size());
+    auto path = paths[0];
+
+    EXPECT_EQ(query.size() - k + 1, path.size());
+    EXPECT_EQ(reference, path.get_sequence());
+    EXPECT_EQ(config.score_sequences(query, reference), path.get_score());
+    EXPECT_EQ("31=1X19=", path.get_cigar().to_string());
+    EXPECT_TRUE(path.is_valid(*graph, &config));
+    check_json_dump_load(*graph, path, paths.get_query(), paths.get_query(PICK_REV_COMP));
+
+    check_extend(graph, aligner.get_config(), paths, query);
+}
+
+TYPED_TEST(DBGAlignerTest, align_exact_minimizer_seeds_min_exact_match) {
+    size_t k = 11;
+    std::string reference = "AAAGCGGACCCTTTCCGTTATGCACGTTAGCAATCGTAGCTAGCTGATCGG";
+    std::string query = reference;
+
+    auto graph = build_graph_batch<TypeParam>(k, { reference });
+    // with w = 10, most query k-mers are not sampled
+    graph->add_extension(std::make_shared<MinimizerIndex>(*graph, 2));
+
+    DBGAlignerConfig config(DBGAlignerConfig::dna_scoring_matrix(2, -1, -2));
+    config.min_seed_length = k;
+    config.max_seed_length = k;
+    config.min_exact_match = 0.7;
+
+    // the k-mers between the sampled ones are mapped as well
+    EXPECT_EQ(map_sequence_to_nodes(*graph, query),
+              MinimizerSeeder<>::map_sampled_kmers(*graph, query));
+
+    DBGAligner<MinimizerSeeder<>> aligner(*graph, config);
+    auto paths = aligner.align(query);
+
+    ASSERT_EQ(1ull, paths.size());
+    auto path = paths[0];
+
+    EXPECT_EQ(query.size() - k + 1, path.size());
+    EXPECT_EQ(reference, path.get_sequence());
+    EXPECT_EQ(config.match_score(query), path.get_score());
+    EXPECT_EQ("51=", path.get_cigar().to_string());
+    EXPECT_TRUE(path.is_valid(*graph, &config));
+    check_json_dump_load(*graph, path, paths.get_query(), paths.get_query(PICK_REV_COMP));
+
+    check_extend(graph, aligner.get_config(), paths, query);
+}
+
+TYPED_TEST(DBGAlignerTest, align_multiple_misalignment_wavefront) {
+    size_t k = 4;
+    std::string reference = "AAAGCGGACCCTTTCCGTTAT";
+    std::string query =     "AAAGGGGACCCTTTTCGTTAT";
+    //                           X         X
+
+    auto graph = build_graph_batch<TypeParam>(k, { reference });
+    DBGAlignerConfig config(DBGAlignerConfig::dna_scoring_matrix(2, -1, -2));
+    config.wavefront_extension = true;
+    DBGAligner<ExactSeeder<>, WavefrontExtender<>> aligner(*graph, config);
+    auto paths = aligner.align(query);
+
+    ASSERT_EQ(1ull, paths.size());
+    auto path = paths[0];
+
+    EXPECT_EQ(query.size() - k + 1, path.size());
+    EXPECT_EQ(reference, path.get_sequence());
+    EXPECT_EQ(config.score_sequences(query, reference), path.get_score());
+    EXPECT_EQ("4=1X9=1X6=", path.get_cigar().to_string());
+    EXPECT_EQ(19u, path.get_num_matches());
+    EXPECT_EQ(0u, path.get_clipping());
+    EXPECT_EQ(0u, path.get_end_clipping());
+    EXPECT_TRUE(path.is_valid(*graph, &config));
+    check_json_dump_load(*graph, path, paths.get_query(), paths.get_query(PICK_REV_COMP));
+
+    check_extend(graph, aligner.get_config(), paths, query);
+}
+
+TYPED_TEST(DBGAlignerTest, align_insert_multi_wavefront) {
+    size_t k = 4;
+    std::string reference = "TTTCCTTGTT";
+    std::string query =     "TTTCCAATTGTT";
+    //                            II
+
+    auto graph = build_graph_batch<TypeParam>(k, { reference });
+    DBGAlignerConfig config(DBGAlignerConfig::dna_scoring_matrix(2, -1, -2));
+    config.gap_opening_penalty = -3;
+    config.gap_extension_penalty = -3;
+    config.wavefront_extension = true;
+    DBGAligner<ExactSeeder<>, WavefrontExtender<>> aligner(*graph, config);
+    auto paths = aligner.align(query);
+
+    ASSERT_EQ(1ull, paths.size());
+    auto path = paths[0];
+
+    EXPECT_EQ(reference.size() - k + 1, path.size());
+    EXPECT_EQ(reference, path.get_sequence());
+    EXPECT_EQ(config.match_score(reference)
+        + config.gap_opening_penalty + config.gap_extension_penalty, path.get_score());
+    EXPECT_EQ("5=2I5=", path.get_cigar().to_string());
+    EXPECT_EQ(10u, path.get_num_matches());
+    EXPECT_EQ(0u, path.get_clipping());
+    EXPECT_EQ(0u, path.get_end_clipping());
+    EXPECT_TRUE(path.is_valid(*graph, &config));
+    check_json_dump_load(*graph, path, paths.get_query(), paths.get_query(PICK_REV_COMP));
+
+    check_extend(graph, aligner.get_config(), paths, query);
+}
+
 TYPED_TEST(DBGAlignerTest, align_insert_non_existent) {
     size_t k = 4;
     std::string reference = "TTTCCTTGTT";
@@ -0,0 +1,189 @@
+#include "gtest/gtest.h"
+
+#include <set>
+
+#include "../test_helpers.hpp"
+#include "all/test_dbg_helpers.hpp"
+
+#include "graph/delta_index.hpp"
+#include "annotation/representation/column_compressed/annotate_column_compressed.hpp"
+
+
+namespace {
+
+using namespace mtg;
+using namespace mtg::graph;
+using namespace mtg::test;
+
+const std::string test_data_dir = "../tests/data";
+const std::string test_dump_basename = test_data_dir + "/delta_index_dump_test";
+
+const std::vector<std::string> base_sequences {
+    "AAACACTAGCGTCG", "AACGACATGCATGC", "GGGGGGGGGGGGG"
+};
+const std::vector<std::string> base_labels { "A", "B", "C" };
+
+const std::vector<std::string> new_sequences {
+    "AAACACTAGCTTTTTT", "CGTCGACATGCATGG", "AACGACATGCATGC"
+};
+const std::vector<std::string> new_labels { "A", "D", "C" };
+
+
+std::unique_ptr<DeltaIndex> build_delta_index(size_t k, bool canonical) {
+    auto graph = build_graph_batch<DBGSuccinct>(k, base_sequences,
+                                                canonical ? CANONICAL : NORMAL);
+
+    auto annotation = std::make_shared<annot::ColumnCompressed<>>(graph->max_index());
+    for (size_t i = 0; i < base_sequences.size(); ++i) {
+        graph->map_to_nodes(base_sequences[i], [&](auto node) {
+            annotation->add_labels({ AnnotatedDBG::graph_to_anno_index(node) },
+                                   { base_labels[i] });
+        });
+    }
+
+    auto delta_index = std::make_unique<DeltaIndex>(graph, annotation);
+    for (size_t i = 0; i < new_sequences.size(); ++i) {
+        delta_index->add_sequence(new_sequences[i], { new_labels[i] });
+    }
+
+    return delta_index;
+}
+
+std::unique_ptr<AnnotatedDBG> build_full_anno_graph(size_t k, bool canonical) {
+    std::vector<std::string> sequences = base_sequences;
+    sequences.insert(sequences.end(), new_sequences.begin(), new_sequences.end());
+    auto graph = build_graph_batch<DBGSuccinct>(k, sequences, canonical ? CANONICAL : NORMAL);
+
+    auto anno_graph = std::make_unique<AnnotatedDBG>(
+        graph, std::make_unique<annot::ColumnCompressed<>>(graph->max_index())
+    );
+    for (size_t i = 0; i < base_sequences.size(); ++i) {
+        anno_graph->annotate_sequence(base_sequences[i], { base_labels[i] });
+    }
+    for (size_t i = 0; i < new_sequences.size(); ++i) {
+        anno_graph->annotate_sequence(new_sequences[i], { new_labels[i] });
+    }
+
+    return anno_graph;
+}
+
+std::set<std::string> get_outgoing_kmers(const DeBruijnGraph &graph, const std::string &kmer) {
+    std::set<std::string> result;
+    graph.call_outgoing_kmers(graph.kmer_to_node(kmer), [&](auto next, char) {
+        result.insert(graph.get_node_sequence(next));
+    });
+    return result;
+}
+
+std::set<std::string> get_incoming_kmers(const DeBruijnGraph &graph, const std::string &kmer) {
+    std::set<std::string> result;
+    graph.call_incoming_kmers(graph.kmer_to_node(kmer), [&](auto prev, char) {
+        result.insert(graph.get_node_sequence(prev));
+    });
+    return result;
+}
+
+// in canonical mode, the labels are assigned to the node |kmer| is mapped to
+std::set<std::string> get_labels(const AnnotatedDBG &anno_graph, const std::string &kmer) {
+    std::set<std::string> result;
+    anno_graph.get_graph().map_to_nodes(kmer, [&](auto node) {
+        for (const auto &label : anno_graph.get_labels(node)) {
+            result.insert(label);
+        }
+    });
+    return result;
+}
+
+
+TEST(DeltaIndex, SameGraphAsRebuilt) {
+    for (bool canonical : { false, true }) {
+        for (size_t k = 3; k <= 10; ++k) {
+            auto delta_index = build_delta_index(k, canonical);
+            auto full = build_full_anno_graph(k, canonical);
+
+            const auto &graph = delta_index->get_graph();
+            const auto &full_graph = full->get_graph();
+
+            EXPECT_EQ(full_graph.num_nodes(), graph.num_nodes());
+            EXPECT_LT(0u, graph.get_delta_graph().num_nodes());
+
+            full_graph.call_kmers([&](auto, const std::string &kmer) {
+                ASSERT_NE(DeBruijnGraph::npos, graph.kmer_to_node(kmer)) << kmer;
+                EXPECT_EQ(kmer, graph.get_node_sequence(graph.kmer_to_node(kmer)));
+                EXPECT_EQ(get_outgoing_kmers(full_graph, kmer),
+                          get_outgoing_kmers(graph, kmer)) << kmer;
+                EXPECT_EQ(get_incoming_kmers(full_graph, kmer),
+                          get_incoming_kmers(graph, kmer)) << kmer;
+                EXPECT_EQ(full_graph.outdegree(full_graph.kmer_to_node(kmer)),
+                          graph.outdegree(graph.kmer_to_node(kmer))) << kmer;
+                EXPECT_EQ(full_graph.indegree(full_graph.kmer_to_node(kmer)),
+                          graph.indegree(graph.kmer_to_node(kmer))) << kmer;
+            });
+        }
+    }
+}
+
+TEST(DeltaIndex, SameLabelsAsRebuilt) {
+    for (bool canonical : { false, true }) {
+        for (size_t k = 3; k <= 10; ++k) {
+            auto delta_index = build_delta_index(k, canonical);
+            auto full = build_full_anno_graph(k, canonical);
+
+            const auto &anno_graph = delta_index->get_anno_graph();
+            EXPECT_EQ(full->get_annotation().num_labels(),
+                      anno_graph.get_annotation().num_labels());
+            EXPECT_EQ(full->get_annotation().num_relations(),
+                      anno_graph.get_annotation().num_relations());
+
+            full->get_graph().call_kmers([&](auto, const std::string &kmer) {
+                EXPECT_EQ(get_labels(*full, kmer), get_labels(anno_graph, kmer)) << kmer;
+            });
+        }
+    }
+}
+
+TEST(DeltaIndex, SerializeLoadDelta) {
+    for (bool canonical : { false, true }) {
+        for (size_t k = 3; k <= 10; ++k) {
+            auto delta_index = build_delta_index(k, canonical);
+            delta_index->serialize_delta(test_dump_basename);
+
+            DeltaIndex loaded(delta_index->get_graph().get_base_graph_ptr(),
+                              delta_index->get_annotation().get_base_annotation_ptr());
+            ASSERT_TRUE(loaded.load_delta(test_dump_basename));
+
+            EXPECT_EQ(delta_index->get_graph().num_nodes(), loaded.get_graph().num_nodes());
+            EXPECT_EQ(delta_index->get_annotation().num_relations(),
+                      loaded.get_annotation().num_relations());
+
+            delta_index->get_graph().call_kmers([&](auto, const std::string &kmer) {
+                EXPECT_EQ(get_labels(delta_index->get_anno_graph(), kmer),
+                          get_labels(loaded.get_anno_graph(), kmer)) << kmer;
+            });
+        }
+    }
+}
+
+TEST(DeltaIndex, CompactSameAsRebuilt) {
+    for (size_t num_threads : { 1, 4 }) {
+        for (bool canonical : { false, true }) {
+            for (size_t k = 3; k <= 10; ++k) {
+                auto delta_index = build_delta_index(k, canonical);
+                auto full = build_full_anno_graph(k, canonical);
+
+                auto compacted = delta_index->compact_async(num_threads).get();
+
+                EXPECT_EQ(full->get_graph().num_nodes(), compacted->get_graph().num_nodes());
+                EXPECT_EQ(full->get_annotation().num_relations(),
+                          compacted->get_annotation().num_relations());
+
+                full->get_graph().call_kmers([&](auto, const std::string &kmer) {
+                    ASSERT_NE(DeBruijnGraph::npos, compacted->get_graph().kmer_to_node(kmer));
+                    EXPECT_EQ(get_labels(*full, kmer), get_labels(*compacted, kmer)) << kmer;
+                });
+            }
+        }
+    }
+}
+
+} // namespace
@@ -2,8 +2,11 @@
 
 #include <string>
 #include <filesystem>
+#include <fstream>
+#include <sstream>
 
 #include "seq_io/sequence_io.hpp"
+#include "seq_io/block_gzip_writer.hpp"
 
 
 namespace {
@@ -104,6 +107,31 @@ TEST(FastaFile, full_iterator_read_100K_async) {
     std::filesystem::remove(dump_filename);
 }
 
+TEST(FastaFile, full_iterator_read_100K_parallel_compression) {
+    set_num_threads(4);
+    for (int level : { 0, 1, 6, 9 }) {
+        {
+            FastaWriter writer(dump_filename, "seq", true, true, "w", level);
+            for (size_t i = 0; i < 100'000; ++i) {
+                writer.write(std::string(i % 1'000, 'A'));
+            }
+        }
+
+        size_t num_records = 0;
+        size_t total_size = 0;
+        for (const auto &record : FastaParser(dump_filename)) {
+            EXPECT_EQ("seq" + std::to_string(num_records + 1), record.name.s);
+            num_records++;
+            total_size += record.seq.l;
+        }
+        EXPECT_EQ(100'000u, num_records);
+        EXPECT_EQ(49'950'000u, total_size);
+    }
+    set_num_threads(1);
+
+    std::filesystem::remove(dump_filename);
+}
+
 TEST(FastaFile, full_iterator_read_100K_multithreaded) {
     {
         FastaWriter writer(dump_filename, "seq", true, true);
@@ -759,6 +787,36 @@ TEST(FastaFileWithCanonical, iterator_read_1M_multiple_copies) {
     std::filesystem::remove(dump_filename);
 }
 
+TEST(BlockGzipWriter, write_read) {
+    std::string data;
+    for (size_t i = 0; i < 100'000; ++i) {
+        data += "ACGT"[(i * i) % 4];
+    }
+
+    for (size_t num_threads : { 0, 1, 3 }) {
+        for (size_t block_size : { 7, 1'000, 100'000, 200'000 }) {
+            {
+                BlockGzipWriter writer(dump_filename, "w", 1, num_threads, block_size);
+                ASSERT_TRUE(writer.is_open());
+                for (size_t i = 0; i < data.size(); i += 1234) {
+                    ASSERT_TRUE(writer.write(std::string_view(data).substr(i, 1234)));
+                }
+            }
+
+            gzFile in = gzopen(dump_filename.c_str(), "r");
+            ASSERT_TRUE(in != Z_NULL);
+            std::string decompressed(data.size() + 1, '\0');
+            ASSERT_EQ(static_cast<int>(data.size()),
+                      gzread(in, decompressed.data(), decompressed.size()));
+            decompressed.resize(data.size());
+            EXPECT_EQ(data, decompressed);
+            gzclose(in);
+        }
+    }
+
+    std::filesystem::remove(dump_filename);
+}
+
 TEST(FastaFromString, read_fasta_from_string) {
     std::string fasta_str = "";
 
@@ -779,4 +837,75 @@ TEST(FastaFromString, read_fasta_from_string) {
     EXPECT_EQ(seqs_cnt, nr_seqs);
 }
 
+void test_read_fasta_from_buffer(const std::string &filename, bool with_reverse) {
+    std::ifstream in(filename);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string content = buffer.str();
+
+    std::vector<std::pair<std::string, std::string>> expected;
+    read_fasta_file_critical(filename, [&](kseq_t *read_stream) {
+        expected.emplace_back(read_stream->name.s, read_stream->seq.s);
+    }, with_reverse);
+    ASSERT_LT(0u, expected.size());
+
+    std::vector<std::pair<std::string, std::string>> records;
+    read_fasta_from_buffer(content, [&](std::string_view name, std::string_view seq) {
+        records.emplace_back(name, seq);
+    }, with_reverse);
+
+    EXPECT_EQ(expected, records);
+}
+
+TEST(FastaFromBuffer, same_as_file) {
+    for (bool with_reverse : { false, true }) {
+        test_read_fasta_from_buffer(test_fasta, with_reverse);
+        test_read_fasta_from_buffer(test_data_dir + "/genome.MT.fa", with_reverse);
+        test_read_fasta_from_buffer(test_data_dir + "/genome_MT1.fq", with_reverse);
+    }
+}
+
+TEST(FastaFromBuffer, zero_copy) {
+    std::string fasta_str = ">seq1 comment\nACGT\n>seq2\nAAA\nCC\n";
+
+    std::vector<std::pair<std::string, std::string>> records;
+    read_fasta_from_buffer(fasta_str, [&](std::string_view name, std::string_view seq) {
+        records.emplace_back(name, seq);
+        if (name == "seq1") {
+            // single-line sequences point into the buffer
+            EXPECT_EQ(fasta_str.data() + 1, name.data());
+            EXPECT_EQ(fasta_str.data() + 14, seq.data());
+        }
+    });
+
+    std::vector<std::pair<std::string, std::string>> expected {
+        { "seq1", "ACGT" }, { "seq2", "AAACC" }
+    };
+    EXPECT_EQ(expected, records);
+}
+
+TEST(FastaFromBuffer, fastq) {
+    std::string fastq_str = "@r1\nACGT\n+\n@@II\n@r2 x\r\nGG\r\n+r2\r\n>I\r\n";
+
+    std::vector<std::pair<std::string, std::string>> records;
+    read_fasta_from_buffer(fastq_str, [&](std::string_view name, std::string_view seq) {
+        records.emplace_back(name, seq);
+    }, true);
+
+    std::vector<std::pair<std::string, std::string>> expected {
+        { "r1", "ACGT" }, { "r1", "ACGT" }, { "r2", "GG" }, { "r2", "CC" }
+    };
+    EXPECT_EQ(expected, records);
+
+    EXPECT_THROW(read_fasta_from_buffer("@r1\nACGT\n+\nII\n", [](auto, auto) {}),
+                 std::runtime_error);
+}
+
+TEST(FastaFromBuffer, empty) {
+    size_t num_records = 0;
+    read_fasta_from_buffer("", [&](auto, auto) { num_records++; });
+    read_fasta_from_buffer("\n\n", [&](auto, auto) { num_records++; });
+    EXPECT_EQ(0u, num_records);
+}
+
 } // namespace
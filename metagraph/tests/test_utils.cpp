@@ -6,6 +6,7 @@
 #include "common/utils/file_utils.hpp"
 #include "common/algorithms.hpp"
 #include "common/vectors/bitmap_mergers.hpp"
+#include "common/threads/numa.hpp"
 #include "common/threads/threading.hpp"
 #include "common/vectors/bit_vector_adaptive.hpp"
 #include "seq_io/formats.hpp"
@@ -305,6 +306,29 @@ TEST(seq_equal, basics) {
     EXPECT_TRUE(utils::seq_equal(std::string("ABAAACD"), std::string("BAAAACD"), 100));
 }
 
+TEST(ThreadPool, NumaPinning) {
+    ASSERT_LE(1u, get_num_numa_nodes());
+    set_numa_pinning(true);
+    {
+        ThreadPool pool(4);
+        std::atomic<size_t> sum = 0;
+        for (size_t t = 0; t < 1000; ++t) {
+            pool.enqueue([&]() { ++sum; });
+        }
+        pool.join();
+        EXPECT_EQ(1000u, sum);
+    }
+    set_numa_pinning(false);
+}
+
+TEST(Numa, ParseCpuList) {
+    EXPECT_EQ(std::vector<int>({}), parse_cpu_list(""));
+    EXPECT_EQ(std::vector<int>({ 0 }), parse_cpu_list("0"));
+    EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3 }), parse_cpu_list("0-3"));
+    EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3, 8, 10, 11 }), parse_cpu_list("0-3,8,10-11"));
+    EXPECT_EQ(std::vector<int>({}), parse_cpu_list("a-b"));
+}
+
 TEST(ThreadPool, EmptyConstructor) {
     ThreadPool pool(1);
     ThreadPool pool2(2);
@@ -1,3 +1,5 @@
+#include <random>
+
 #include "gtest/gtest.h"
 #include "test_helpers.hpp"
 
@@ -505,6 +507,83 @@ TYPED_TEST(WaveletTreeTest, operator_neq) {
     }
 }
 
+TEST(occ_table_vector, Queries) {
+    std::mt19937 gen(42);
+    for (uint8_t logsigma = 1; logsigma <= occ_table_vector::kMaxLogSigma; ++logsigma) {
+        // cover partial blocks and multiple superblocks
+        for (uint64_t size : { 1, 63, 64, 65, 1000, 150'000 }) {
+            std::vector<uint64_t> numbers(size);
+            for (uint64_t &c : numbers) {
+                c = gen() % (1 << logsigma);
+            }
+            occ_table_vector vector(logsigma, numbers);
+            EXPECT_EQ(logsigma, vector.logsigma());
+            if (size <= 1000) {
+                reference_based_test(vector, numbers);
+                continue;
+            }
+
+            std::vector<uint64_t> rank(1 << logsigma, 0);
+            for (uint64_t i = 0; i < size; ++i) {
+                rank[numbers[i]]++;
+                ASSERT_EQ(numbers[i], vector[i]);
+                ASSERT_EQ(rank[numbers[i]], vector.rank(numbers[i], i));
+                ASSERT_EQ(i, vector.select(numbers[i], rank[numbers[i]]));
+            }
+            for (uint64_t c = 0; c < rank.size(); ++c) {
+                EXPECT_EQ(rank[c], vector.count(c));
+            }
+            test_next(vector);
+            test_prev(vector);
+        }
+    }
+}
+
+TEST(occ_table_vector, Serialization) {
+    std::vector<uint64_t> numbers(100'000);
+    for (uint64_t i = 0; i < numbers.size(); ++i) {
+        numbers[i] = (i * i + i / 3) % 10;
+    }
+    occ_table_vector vector(4, numbers);
+    std::ofstream outstream(test_dump_basename);
+    vector.serialize(outstream);
+    outstream.close();
+
+    occ_table_vector loaded(1);
+    std::ifstream instream(test_dump_basename);
+    ASSERT_TRUE(loaded.load(instream));
+    EXPECT_EQ(4u, loaded.logsigma());
+    EXPECT_EQ(vector, loaded);
+    for (uint64_t c = 0; c < 16; ++c) {
+        EXPECT_EQ(vector.count(c), loaded.count(c));
+        EXPECT_EQ(vector.rank(c, numbers.size() / 2), loaded.rank(c, numbers.size() / 2));
+    }
+}
+
+TEST(occ_table_vector, Convert) {
+    std::vector<uint64_t> numbers = { 0, 1, 0, 1, 1, 1, 1, 0,
+                                      0, 1, 2, 0, 3, 2, 1, 1 };
+
+    sdsl::int_vector<> int_vector(numbers.size(), 0, 2);
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        int_vector[i] = numbers[i];
+    }
+
+    test_convert_to<occ_table_vector, wavelet_tree_stat>(int_vector);
+    test_convert_to<occ_table_vector, wavelet_tree_fast>(int_vector);
+    test_convert_to<occ_table_vector, wavelet_tree_dyn>(int_vector);
+    test_convert_to<occ_table_vector, wavelet_tree_small>(int_vector);
+    test_convert_to<wavelet_tree_stat, occ_table_vector>(int_vector);
+    test_convert_to<wavelet_tree_fast, occ_table_vector>(int_vector);
+    test_convert_to<wavelet_tree_dyn, occ_table_vector>(int_vector);
+    test_convert_to<wavelet_tree_small, occ_table_vector>(int_vector);
+}
+
+TEST(occ_table_vector, LargeAlphabet) {
+    EXPECT_THROW(occ_table_vector(occ_table_vector::kMaxLogSigma + 1),
+                 std::runtime_error);
+}
+
 TYPED_TEST(WaveletTreeTest, width) {
     for (uint8_t width : { 1, 2, 3, 4, 5, 6, 7, 8, 15, 16, 18 }) {
         const TypeParam wt(width, sdsl::int_vector<>(100, 1llu << (width - 1)));